@@ -0,0 +1,315 @@
+#include <stdlib.h>
+#include <string.h>
+#include "allocator.h"
+
+// --- Block List ---
+
+static bool reserve_blocks(Allocator *allocator, int count) {
+    if (count <= allocator->room) return true;
+    int room = allocator->room > 0 ? allocator->room * 2 : 16;
+    while (room < count) room *= 2;
+    Partition *blocks = (Partition *)realloc(allocator->blocks, room * sizeof(Partition));
+    if (!blocks) return false;
+    allocator->blocks = blocks;
+    allocator->room = room;
+    return true;
+}
+
+static bool insert_block(Allocator *allocator, int index, Partition block) {
+    if (!reserve_blocks(allocator, allocator->count + 1)) return false;
+    memmove(&allocator->blocks[index + 1], &allocator->blocks[index], (allocator->count - index) * sizeof(Partition));
+    allocator->blocks[index] = block;
+    allocator->count++;
+    return true;
+}
+
+static void remove_block(Allocator *allocator, int index) {
+    memmove(&allocator->blocks[index], &allocator->blocks[index + 1], (allocator->count - index - 1) * sizeof(Partition));
+    allocator->count--;
+}
+
+static Partition hole(int start, int size) {
+    Partition block = {start, size, 0, -1};
+    return block;
+}
+
+// Splits the first size bytes off the hole at index, the rest stays a hole after it
+static bool split_block(Allocator *allocator, int index, int size) {
+    Partition *block = &allocator->blocks[index];
+    if (block->size == size) return true;
+    Partition rest = hole(block->start + size, block->size - size);
+    block->size = size;
+    return insert_block(allocator, index + 1, rest);
+}
+
+// --- Buddy System ---
+// A capacity that is not a power of two is covered by descending power of two top blocks
+// (21000 bytes: 16384, 4096 and 512), and blocks only merge inside their top block.
+// The bytes left below BUDDY_MIN_BLOCK are never handed out.
+
+static int top_block_base(int capacity, int address, int *top_size) {
+    int base = 0;
+    for (int size = 1 << 30; size >= BUDDY_MIN_BLOCK; size >>= 1) {
+        if (capacity - base >= size) {
+            if (address < base + size) {
+                *top_size = size;
+                return base;
+            }
+            base += size;
+        }
+    }
+    *top_size = 0;
+    return -1;
+}
+
+static int round_up_power(int size) {
+    int block = BUDDY_MIN_BLOCK;
+    while (block < size) block <<= 1;
+    return block;
+}
+
+static int log2_of(int value) {
+    int order = 0;
+    while ((1 << order) < value) order++;
+    return order;
+}
+
+// Searching the free list of every order from the request up is what a buddy allocation costs
+static int find_buddy_block(Allocator *allocator, int need, int *probes) {
+    int best = -1;
+    for (int i = 0; i < allocator->count; i++) {
+        const Partition *block = &allocator->blocks[i];
+        if (block->owner == -1 && block->size >= need && (best == -1 || block->size < allocator->blocks[best].size)) {
+            best = i;
+        }
+    }
+    int largest = best != -1 ? allocator->blocks[best].size : round_up_power(allocator->capacity);
+    *probes = log2_of(largest) - log2_of(need) + 1;
+    return best;
+}
+
+static void merge_buddies(Allocator *allocator, int index) {
+    while (true) {
+        Partition *block = &allocator->blocks[index];
+        int top_size;
+        int base = top_block_base(allocator->capacity, block->start, &top_size);
+        if (block->size >= top_size) return;
+        int buddy_start = base + ((block->start - base) ^ block->size);
+        int buddy = buddy_start < block->start ? index - 1 : index + 1;
+        if (buddy < 0 || buddy >= allocator->count) return;
+        Partition *other = &allocator->blocks[buddy];
+        if (other->start != buddy_start || other->size != block->size || other->owner != -1) return;
+        int first = buddy < index ? buddy : index;
+        allocator->blocks[first].size *= 2;
+        remove_block(allocator, first + 1);
+        index = first;
+    }
+}
+
+// --- Variable Partitions ---
+
+static int find_hole(Allocator *allocator, int size, int *probes) {
+    int found = -1;
+    *probes = 0;
+    if (allocator->strategy == FIT_NEXT) {
+        int first = 0;
+        while (first < allocator->count && allocator->blocks[first].start + allocator->blocks[first].size <= allocator->next_fit) {
+            first++;
+        }
+        for (int n = 0; n < allocator->count && found == -1; n++) {
+            int i = (first + n) % allocator->count;
+            (*probes)++;
+            if (allocator->blocks[i].owner == -1 && allocator->blocks[i].size >= size) found = i;
+        }
+        return found;
+    }
+    for (int i = 0; i < allocator->count; i++) {
+        const Partition *block = &allocator->blocks[i];
+        (*probes)++;
+        if (block->owner != -1 || block->size < size) continue;
+        if (allocator->strategy == FIT_FIRST) return i;
+        if (found == -1 || block->size < allocator->blocks[found].size) found = i; // FIT_BEST
+    }
+    return found;
+}
+
+static void merge_holes(Allocator *allocator, int index) {
+    if (index + 1 < allocator->count && allocator->blocks[index + 1].owner == -1) {
+        allocator->blocks[index].size += allocator->blocks[index + 1].size;
+        remove_block(allocator, index + 1);
+    }
+    if (index > 0 && allocator->blocks[index - 1].owner == -1) {
+        allocator->blocks[index - 1].size += allocator->blocks[index].size;
+        remove_block(allocator, index);
+    }
+}
+
+// Moves every partition down to the lowest free address, leaving one hole at the end
+static void compact(Allocator *allocator) {
+    int next = 0, kept = 0;
+    for (int i = 0; i < allocator->count; i++) {
+        Partition block = allocator->blocks[i];
+        if (block.owner == -1) continue;
+        if (block.start != next) allocator->stats.bytes_moved += block.size;
+        block.start = next;
+        next += block.size;
+        allocator->blocks[kept++] = block;
+    }
+    allocator->count = kept;
+    if (next < allocator->capacity) insert_block(allocator, kept, hole(next, allocator->capacity - next));
+    allocator->next_fit = 0;
+    allocator->stats.compactions++;
+}
+
+static int free_bytes(const Allocator *allocator, int *largest) {
+    int total = 0;
+    *largest = 0;
+    for (int i = 0; i < allocator->count; i++) {
+        const Partition *block = &allocator->blocks[i];
+        if (block->owner != -1) continue;
+        total += block->size;
+        if (block->size > *largest) *largest = block->size;
+    }
+    return total;
+}
+
+static void count_probes(Allocator *allocator, int probes) {
+    allocator->stats.probes += probes;
+    if (probes > allocator->stats.max_probes) allocator->stats.max_probes = probes;
+}
+
+// --- Interface ---
+
+bool allocator_init(Allocator *allocator, AllocStrategy strategy, int capacity, bool compaction) {
+    memset(allocator, 0, sizeof(Allocator));
+    allocator->strategy = strategy;
+    allocator->compaction = compaction && strategy != FIT_BUDDY; // Buddy blocks cannot be slid around
+    allocator->capacity = capacity;
+    if (strategy != FIT_BUDDY) {
+        return capacity <= 0 || insert_block(allocator, 0, hole(0, capacity));
+    }
+    int top_size;
+    for (int base = 0; top_block_base(capacity, base, &top_size) == base; base += top_size) {
+        if (!insert_block(allocator, allocator->count, hole(base, top_size))) return false;
+    }
+    return true;
+}
+
+void allocator_destroy(Allocator *allocator) {
+    free(allocator->blocks);
+    allocator->blocks = NULL;
+    allocator->count = allocator->room = 0;
+}
+
+int allocator_alloc(Allocator *allocator, int owner, int size) {
+    if (size < 1) size = 1;
+    int probes, index;
+    int need = allocator->strategy == FIT_BUDDY ? round_up_power(size) : size;
+    if (allocator->strategy == FIT_BUDDY) {
+        index = find_buddy_block(allocator, need, &probes);
+    } else {
+        index = find_hole(allocator, need, &probes);
+        int largest;
+        if (index == -1 && allocator->compaction && free_bytes(allocator, &largest) >= need) {
+            compact(allocator);
+            int more;
+            index = find_hole(allocator, need, &more);
+            probes += more;
+        }
+    }
+    count_probes(allocator, probes);
+    if (index == -1) {
+        allocator->stats.failures++;
+        return -1;
+    }
+
+    if (allocator->strategy == FIT_BUDDY) {
+        // Halve the block until it is the rounded request, the upper halves become holes
+        while (allocator->blocks[index].size > need) {
+            if (!split_block(allocator, index, allocator->blocks[index].size / 2)) return -1;
+        }
+    } else if (!split_block(allocator, index, need)) {
+        return -1;
+    }
+    Partition *block = &allocator->blocks[index];
+    block->owner = owner;
+    block->requested = size;
+    allocator->next_fit = block->start + block->size;
+    allocator->stats.allocations++;
+    return block->start;
+}
+
+void allocator_free(Allocator *allocator, int owner) {
+    for (int i = 0; i < allocator->count; i++) {
+        if (allocator->blocks[i].owner != owner) continue;
+        allocator->blocks[i].owner = -1;
+        allocator->blocks[i].requested = 0;
+        if (allocator->strategy == FIT_BUDDY) {
+            merge_buddies(allocator, i);
+        } else {
+            merge_holes(allocator, i);
+        }
+        return;
+    }
+}
+
+const Partition *allocator_find(const Allocator *allocator, int owner) {
+    for (int i = 0; i < allocator->count; i++) {
+        if (allocator->blocks[i].owner == owner) return &allocator->blocks[i];
+    }
+    return NULL;
+}
+
+// External fragmentation is the share of the free bytes outside the largest hole, so 0 when all free
+// memory is one hole. Internal fragmentation is the bytes given to partitions beyond their requests.
+void allocator_sample(Allocator *allocator) {
+    int largest;
+    int total = free_bytes(allocator, &largest);
+    int external = total > 0 ? (int)((long long)(total - largest) * 1000 / total) : 0;
+    int internal = 0;
+    for (int i = 0; i < allocator->count; i++) {
+        if (allocator->blocks[i].owner != -1) internal += allocator->blocks[i].size - allocator->blocks[i].requested;
+    }
+    AllocatorStats *stats = &allocator->stats;
+    stats->samples++;
+    stats->external_sum += external;
+    stats->internal_sum += internal;
+    if (external > stats->peak_external) stats->peak_external = external;
+    if (internal > stats->peak_internal) stats->peak_internal = internal;
+}
+
+void allocator_print_stats(const Allocator *allocator, FILE *out) {
+    const AllocatorStats *stats = &allocator->stats;
+    int searches = stats->allocations + stats->failures;
+    fprintf(out, "%-26s %s%s\n", "allocator", alloc_strategy_name(allocator->strategy),
+            allocator->compaction ? " with compaction" : "");
+    fprintf(out, "%-26s %d\n", "allocations", stats->allocations);
+    fprintf(out, "%-26s %d\n", "failed allocations", stats->failures);
+    fprintf(out, "%-26s %.2f\n", "probes per allocation", searches > 0 ? (double)stats->probes / searches : 0.0);
+    fprintf(out, "%-26s %d\n", "longest search", stats->max_probes);
+    fprintf(out, "%-26s %d\n", "compactions", stats->compactions);
+    fprintf(out, "%-26s %d\n", "bytes moved", stats->bytes_moved);
+    fprintf(out, "%-26s %.1f%%\n", "external fragmentation", stats->samples > 0 ? stats->external_sum / 10.0 / stats->samples : 0.0);
+    fprintf(out, "%-26s %.1f%%\n", "peak external frag.", stats->peak_external / 10.0);
+    fprintf(out, "%-26s %.1f\n", "internal fragmentation", stats->samples > 0 ? (double)stats->internal_sum / stats->samples : 0.0);
+    fprintf(out, "%-26s %d\n", "peak internal frag.", stats->peak_internal);
+}
+
+bool parse_alloc_strategy(const char *name, AllocStrategy *strategy) {
+    if (strcmp(name, "first") == 0) *strategy = FIT_FIRST;
+    else if (strcmp(name, "best") == 0) *strategy = FIT_BEST;
+    else if (strcmp(name, "next") == 0) *strategy = FIT_NEXT;
+    else if (strcmp(name, "buddy") == 0) *strategy = FIT_BUDDY;
+    else return false;
+    return true;
+}
+
+const char *alloc_strategy_name(AllocStrategy strategy) {
+    switch (strategy) {
+        case FIT_FIRST: return "first fit";
+        case FIT_BEST:  return "best fit";
+        case FIT_NEXT:  return "next fit";
+        case FIT_BUDDY: return "buddy";
+    }
+    return "";
+}
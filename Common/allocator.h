@@ -0,0 +1,65 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+// Contiguous allocation of whole process images, the alternative to paging.
+// Memory is a list of blocks ordered by address: partitions owned by a process and holes.
+// The variable partition strategies split holes to the exact size and merge neighbouring holes;
+// the buddy strategy only hands out power of two blocks and merges a block with its buddy.
+// Both parts build this one copy.
+
+#define BUDDY_MIN_BLOCK 256 // Smallest block the buddy allocator splits down to
+
+typedef enum { FIT_FIRST, FIT_BEST, FIT_NEXT, FIT_BUDDY } AllocStrategy;
+
+typedef struct {
+    int start;
+    int size;      // Bytes of the block
+    int requested; // Bytes the owner asked for (size - requested is internal fragmentation)
+    int owner;     // Process id, -1 for a hole
+} Partition;
+
+// Counters of one allocator, all ints so a checkpoint can store them as they are
+typedef struct {
+    int allocations;
+    int failures;         // Requests that did not fit, even after compaction
+    int probes;           // Blocks examined by all successful and failed searches
+    int max_probes;       // Longest single search
+    int compactions;
+    int bytes_moved;      // Bytes copied by compaction
+    int samples;          // Times allocator_sample() ran
+    int external_sum;     // External fragmentation of every sample, in per mille
+    int peak_external;
+    int internal_sum;     // Bytes of internal fragmentation of every sample
+    int peak_internal;
+} AllocatorStats;
+
+typedef struct {
+    AllocStrategy strategy;
+    bool compaction; // Slide the partitions together when a request fits the free bytes but no hole
+    int capacity;
+    Partition *blocks;
+    int count;
+    int room;
+    int next_fit;    // Address where the next-fit search resumes
+    AllocatorStats stats;
+} Allocator;
+
+bool allocator_init(Allocator *allocator, AllocStrategy strategy, int capacity, bool compaction);
+void allocator_destroy(Allocator *allocator);
+
+// Places size bytes for owner. Returns the start address, or -1 if the request does not fit.
+int allocator_alloc(Allocator *allocator, int owner, int size);
+void allocator_free(Allocator *allocator, int owner);
+const Partition *allocator_find(const Allocator *allocator, int owner);
+
+// Adds the current fragmentation to the averages (called once per simulated tick)
+void allocator_sample(Allocator *allocator);
+void allocator_print_stats(const Allocator *allocator, FILE *out);
+
+bool parse_alloc_strategy(const char *name, AllocStrategy *strategy);
+const char *alloc_strategy_name(AllocStrategy strategy);
+
+#endif // ALLOCATOR_H
@@ -0,0 +1,241 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "cache.h"
+
+void cache_default_levels(CacheLevelConfig levels[CACHE_LEVELS]) {
+    levels[0] = (CacheLevelConfig){512, 32, 2, CACHE_LRU};
+    levels[1] = (CacheLevelConfig){2048, 32, 4, CACHE_LRU};
+    levels[2] = (CacheLevelConfig){8192, 64, 8, CACHE_LRU};
+}
+
+static bool valid_level(const CacheLevelConfig *config) {
+    return config->size > 0 && config->line_size > 0 && config->ways > 0 &&
+           config->size % (config->line_size * config->ways) == 0 &&
+           config->replacement >= CACHE_LRU && config->replacement <= CACHE_RANDOM;
+}
+
+bool cache_init(CacheHierarchy *cache, const CacheLevelConfig levels[], int num_levels, int num_owners, int pollution) {
+    memset(cache, 0, sizeof(CacheHierarchy));
+    if (num_levels < 1 || num_levels > CACHE_LEVELS || num_owners < 1) return false;
+    cache->num_levels = num_levels;
+    cache->num_owners = num_owners;
+    cache->pollution = pollution;
+    cache->random_state = 2463534242u;
+    cache->owner_lost = (long long *)calloc(num_owners, sizeof(long long));
+    bool ok = cache->owner_lost != NULL;
+    for (int l = 0; l < num_levels && ok; l++) {
+        CacheLevel *level = &cache->levels[l];
+        if (!valid_level(&levels[l])) {
+            ok = false;
+            break;
+        }
+        level->config = levels[l];
+        level->sets = levels[l].size / (levels[l].line_size * levels[l].ways);
+        int lines = levels[l].size / levels[l].line_size;
+        level->tags = (int *)malloc(lines * sizeof(int));
+        level->owners = (int *)calloc(lines, sizeof(int));
+        level->stamps = (int *)calloc(lines, sizeof(int));
+        level->owner_accesses = (long long *)calloc(num_owners, sizeof(long long));
+        level->owner_misses = (long long *)calloc(num_owners, sizeof(long long));
+        ok = level->tags && level->owners && level->stamps && level->owner_accesses && level->owner_misses;
+        for (int i = 0; ok && i < lines; i++) {
+            level->tags[i] = -1;
+        }
+    }
+    if (!ok) cache_destroy(cache);
+    return ok;
+}
+
+void cache_destroy(CacheHierarchy *cache) {
+    for (int l = 0; l < CACHE_LEVELS; l++) {
+        CacheLevel *level = &cache->levels[l];
+        free(level->tags);
+        free(level->owners);
+        free(level->stamps);
+        free(level->owner_accesses);
+        free(level->owner_misses);
+    }
+    free(cache->owner_lost);
+    memset(cache, 0, sizeof(CacheHierarchy));
+}
+
+// Xorshift, so random replacement and pollution repeat from run to run
+static unsigned int next_random(CacheHierarchy *cache) {
+    unsigned int x = cache->random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    cache->random_state = x;
+    return x;
+}
+
+static void lose_line(CacheHierarchy *cache, int owner) {
+    if (owner >= 1 && owner <= cache->num_owners) cache->owner_lost[owner - 1]++;
+}
+
+// Puts a line in its set: an empty way if there is one, the policy's victim otherwise
+static void fill_line(CacheHierarchy *cache, CacheLevel *level, int owner, int line) {
+    int ways = level->config.ways;
+    int first = (line % level->sets) * ways;
+    int victim = -1;
+    for (int w = first; w < first + ways && victim == -1; w++) {
+        if (level->tags[w] == -1) victim = w;
+    }
+    if (victim == -1) {
+        if (level->config.replacement == CACHE_RANDOM) {
+            victim = first + (int)(next_random(cache) % ways);
+        } else {
+            victim = first; // LRU and FIFO both evict the smallest stamp, they differ in what renews it
+            for (int w = first + 1; w < first + ways; w++) {
+                if (level->stamps[w] < level->stamps[victim]) victim = w;
+            }
+        }
+        if (level->owners[victim] != owner) lose_line(cache, level->owners[victim]);
+    }
+    level->tags[victim] = line;
+    level->owners[victim] = owner;
+    level->stamps[victim] = cache->clock;
+}
+
+// Renumbers the stamps of every set from 0 in the same order, before the clock wraps on unbounded
+// streams. Stamps are only compared within their set.
+static void restart_clock(CacheHierarchy *cache) {
+    int next_clock = 0;
+    for (int l = 0; l < cache->num_levels; l++) {
+        CacheLevel *level = &cache->levels[l];
+        int ways = level->config.ways;
+        int *ranks = (int *)malloc(ways * sizeof(int));
+        if (ranks == NULL) continue; // The order of this level's sets is lost, nothing worse
+        for (int first = 0; first < level->sets * ways; first += ways) {
+            for (int w = 0; w < ways; w++) {
+                ranks[w] = 0;
+                for (int v = 0; v < ways; v++) {
+                    if (level->stamps[first + v] < level->stamps[first + w]) ranks[w]++;
+                }
+            }
+            memcpy(&level->stamps[first], ranks, ways * sizeof(int));
+        }
+        free(ranks);
+        if (ways > next_clock) next_clock = ways;
+    }
+    cache->clock = next_clock;
+}
+
+int cache_access(CacheHierarchy *cache, int owner, int address) {
+    bool counted = owner >= 1 && owner <= cache->num_owners;
+    if (cache->clock == INT_MAX) restart_clock(cache);
+    cache->clock++;
+    int hit_level = cache->num_levels;
+    for (int l = 0; l < cache->num_levels && hit_level == cache->num_levels; l++) {
+        CacheLevel *level = &cache->levels[l];
+        int line = address / level->config.line_size;
+        int first = (line % level->sets) * level->config.ways;
+        level->accesses++;
+        if (counted) level->owner_accesses[owner - 1]++;
+        for (int w = first; w < first + level->config.ways; w++) {
+            if (level->tags[w] == line) {
+                if (level->config.replacement == CACHE_LRU) level->stamps[w] = cache->clock;
+                hit_level = l;
+                break;
+            }
+        }
+        if (hit_level != l) {
+            level->misses++;
+            if (counted) level->owner_misses[owner - 1]++;
+        }
+    }
+    for (int l = 0; l < hit_level && l < cache->num_levels; l++) {
+        fill_line(cache, &cache->levels[l], owner, address / cache->levels[l].config.line_size);
+    }
+    return hit_level;
+}
+
+// Another process, the kernel and the interrupt handlers on the way leave their own lines behind:
+// every valid line is lost with the pollution probability
+void cache_switch(CacheHierarchy *cache, int owner) {
+    if (owner == cache->last_owner) return;
+    if (cache->last_owner != 0) {
+        cache->switches++;
+        for (int l = 0; l < cache->num_levels && cache->pollution > 0; l++) {
+            CacheLevel *level = &cache->levels[l];
+            int lines = level->config.size / level->config.line_size;
+            for (int i = 0; i < lines; i++) {
+                if (level->tags[i] != -1 && (int)(next_random(cache) % 100) < cache->pollution) {
+                    lose_line(cache, level->owners[i]);
+                    level->tags[i] = -1;
+                }
+            }
+        }
+    }
+    cache->last_owner = owner;
+}
+
+static const char *level_name(const CacheHierarchy *cache, int l) {
+    static const char *const names[] = {"L1", "L2"};
+    return l == cache->num_levels - 1 && l > 0 ? "LLC" : names[l];
+}
+
+static double ratio(long long part, long long whole) {
+    return whole > 0 ? (double)part / whole : 0.0;
+}
+
+void cache_print_stats(const CacheHierarchy *cache, FILE *out) {
+    for (int l = 0; l < cache->num_levels; l++) {
+        const CacheLevel *level = &cache->levels[l];
+        char label[64];
+        snprintf(label, sizeof(label), "%s (%d B, %d B lines, %d-way %s)", level_name(cache, l), level->config.size,
+                 level->config.line_size, level->config.ways, cache_replacement_name((CacheReplacement)level->config.replacement));
+        fprintf(out, "%s\n", label);
+        fprintf(out, "%-26s %lld\n", "  accesses", level->accesses);
+        fprintf(out, "%-26s %.3f\n", "  miss rate", ratio(level->misses, level->accesses));
+    }
+    fprintf(out, "%-26s %lld\n", "context switches", cache->switches);
+    fprintf(out, "%-26s %d%%\n", "pollution per switch", cache->pollution);
+
+    fprintf(out, "%-8s", "pid");
+    for (int l = 0; l < cache->num_levels; l++) {
+        char heading[16];
+        snprintf(heading, sizeof(heading), "%s miss", level_name(cache, l));
+        fprintf(out, " %-10s", heading);
+    }
+    fprintf(out, " %s\n", "lines lost");
+    for (int p = 0; p < cache->num_owners; p++) {
+        if (cache->levels[0].owner_accesses[p] == 0) continue;
+        fprintf(out, "%-8d", p + 1);
+        for (int l = 0; l < cache->num_levels; l++) {
+            fprintf(out, " %-10.3f", ratio(cache->levels[l].owner_misses[p], cache->levels[l].owner_accesses[p]));
+        }
+        fprintf(out, " %lld\n", cache->owner_lost[p]);
+    }
+}
+
+bool parse_cache_level(const char *text, CacheLevelConfig *config) {
+    int size, line_size, ways;
+    char suffix[4] = "", replacement[16] = "lru";
+    int fields = sscanf(text, "%d%3[kK]:%d:%d:%15s", &size, suffix, &line_size, &ways, replacement);
+    if (fields < 4) {
+        suffix[0] = '\0';
+        fields = sscanf(text, "%d:%d:%d:%15s", &size, &line_size, &ways, replacement);
+        if (fields < 3) return false;
+    }
+    if (suffix[0] != '\0') size *= 1024;
+    memset(config, 0, sizeof(CacheLevelConfig));
+    config->size = size;
+    config->line_size = line_size;
+    config->ways = ways;
+    if (strcmp(replacement, "lru") == 0) config->replacement = CACHE_LRU;
+    else if (strcmp(replacement, "fifo") == 0) config->replacement = CACHE_FIFO;
+    else if (strcmp(replacement, "random") == 0) config->replacement = CACHE_RANDOM;
+    else return false;
+    return valid_level(config);
+}
+
+const char *cache_replacement_name(CacheReplacement replacement) {
+    switch (replacement) {
+        case CACHE_LRU:    return "lru";
+        case CACHE_FIFO:   return "fifo";
+        case CACHE_RANDOM: return "random";
+    }
+    return "";
+}
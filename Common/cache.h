@@ -0,0 +1,64 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+// Set associative CPU caches in front of physical memory. Every memory access looks up the levels
+// in order and fills the ones that missed, so a line is usually in every level below the one it was
+// found in. Each line remembers the process that brought it in, which gives per process miss rates
+// and counts the lines a process loses to the others. Both parts build this one copy.
+
+#define CACHE_LEVELS 3 // L1, L2 and the last level cache
+
+typedef enum { CACHE_LRU, CACHE_FIFO, CACHE_RANDOM } CacheReplacement;
+
+typedef struct {
+    int size;        // Bytes of the level
+    int line_size;   // Bytes per line
+    int ways;        // Lines per set
+    int replacement; // CacheReplacement
+} CacheLevelConfig;
+
+// One level. Lines are stored set after set, the ways of a set next to each other.
+typedef struct {
+    CacheLevelConfig config;
+    int sets;
+    int *tags;           // Line address (address / line_size), -1 for an empty line
+    int *owners;         // Process that filled the line
+    int *stamps;         // Access count of the last use (LRU) or of the fill (FIFO)
+    long long accesses;
+    long long misses;
+    long long *owner_accesses; // Per process, index pid - 1
+    long long *owner_misses;
+} CacheLevel;
+
+typedef struct {
+    int num_levels;
+    int num_owners;       // Processes 1 to num_owners get their own counters
+    int pollution;        // Percent of the lines of every level lost on each context switch
+    CacheLevel levels[CACHE_LEVELS];
+    int clock;            // Accesses so far, orders the lines for LRU and FIFO; restarts before it wraps
+    unsigned int random_state;
+    int last_owner;       // Process of the last context switch, 0 before the first one
+    long long switches;
+    long long *owner_lost; // Lines of each process evicted by another process or by pollution
+} CacheHierarchy;
+
+// A hierarchy scaled to the simulated memory (21000 bytes by default): 512 B L1, 2 KB L2, 8 KB LLC
+void cache_default_levels(CacheLevelConfig levels[CACHE_LEVELS]);
+bool cache_init(CacheHierarchy *cache, const CacheLevelConfig levels[], int num_levels, int num_owners, int pollution);
+void cache_destroy(CacheHierarchy *cache);
+
+// Looks up a physical address for a process. Returns the level that held it, or num_levels when it
+// came from memory.
+int cache_access(CacheHierarchy *cache, int owner, int address);
+// The CPU goes to another process: pollutes the levels if that is a different process than before
+void cache_switch(CacheHierarchy *cache, int owner);
+void cache_print_stats(const CacheHierarchy *cache, FILE *out);
+
+// Reads "size:line:ways[:lru|fifo|random]", sizes in bytes with an optional k suffix, like "2k:32:4:lru"
+bool parse_cache_level(const char *text, CacheLevelConfig *config);
+const char *cache_replacement_name(CacheReplacement replacement);
+
+#endif // CACHE_H
@@ -0,0 +1,255 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+#include "p1_simulator.h"
+#include "workload.h"
+#include "mrc.h"
+
+#ifdef _WIN32
+    #define NULL_DEVICE "NUL"
+#else
+    #define NULL_DEVICE "/dev/null"
+#endif
+
+// --- Allocation Counting ---
+// The bench target links with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc so every allocation
+// made by the simulator passes through these counters.
+
+long allocation_count = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    allocation_count++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    allocation_count++;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size) {
+    allocation_count++;
+    return __real_realloc(pointer, size);
+}
+
+// --- Measurements ---
+
+double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+long peak_rss_kb(void) {
+#ifndef _WIN32
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    const char *name;
+    AccessModel model;
+} BenchWorkload;
+
+void print_usage(const char *program_name) {
+    fprintf(stderr, "Usage: %s [options]\n", program_name);
+    fprintf(stderr, "  --length N     Accesses per generated trace (default 200000)\n");
+    fprintf(stderr, "  --procs N      Processes per trace (default %d)\n", MAX_PROCESSES);
+    fprintf(stderr, "  --repeats N    Timed runs per case (default 5)\n");
+    fprintf(stderr, "  --label TEXT   Value of the label column, e.g. a commit id\n");
+    fprintf(stderr, "  --csv FILE     Results file (default bench_part1.csv)\n");
+    fprintf(stderr, "  --quiet        Run the quiet kernels, without formatting the state tables\n");
+    fprintf(stderr, "  --mrc-csv FILE Sampled fault rate curves against exact ones (default bench_mrc_part1.csv)\n");
+}
+
+// Feeds a whole workload to a fault rate curve and returns the seconds it took
+double time_curve(MissRatioCurve *curve, const Workload *workload) {
+    double start = now_seconds();
+    for (int n = 0; n < workload->trace_len; n++) {
+        mrc_access(curve, workload->exec_trace[2 * n], workload->exec_trace[2 * n + 1]);
+    }
+    return now_seconds() - start;
+}
+
+// Sampled curves of traces with large address spaces against the exact curve, which is what a full
+// run of every memory size would count. Errors are absolute differences of the fault rate.
+void bench_mrc(FILE *csv, const char *label, const BenchWorkload workloads[], int num_workloads, int length, int num_procs) {
+    const double rates[] = {0.1, 0.01};
+    const ReplacementAlgo algos[] = {FIFO, LRU};
+    fprintf(csv, "label,workload,algo,accesses,rate,sampled_references,exact_sec,sampled_sec,speedup,mean_abs_error,max_abs_error\n");
+    fprintf(stderr, "\n%-12s %-5s %-6s %10s %10s %10s %9s %9s\n", "workload", "algo", "rate", "sampled", "exact s",
+            "sampled s", "mean err", "max err");
+    for (int w = 0; w < num_workloads; w++) {
+        WorkloadSpec spec = default_workload_spec();
+        spec.model = workloads[w].model;
+        spec.num_procs = num_procs;
+        spec.trace_len = length;
+        spec.seed = 42;
+        spec.min_memory = 300000;
+        spec.max_memory = 3000000; // 100 to 1000 pages per process
+        Workload workload;
+        if (!generate_workload(&spec, &workload)) {
+            fprintf(stderr, "Could not generate workload %s\n", workloads[w].name);
+            continue;
+        }
+        int frames[MRC_MAX_POINTS];
+        int num_points = mrc_default_frames(workload.num_procs, workload.mem_sizes, frames);
+        for (int a = 0; a < 2; a++) {
+            MissRatioCurve exact;
+            if (!mrc_init(&exact, algos[a], 1.0, workload.num_procs, workload.mem_sizes, frames, num_points)) continue;
+            double exact_time = time_curve(&exact, &workload);
+            for (int r = 0; r < 2; r++) {
+                MissRatioCurve sampled;
+                if (!mrc_init(&sampled, algos[a], rates[r], workload.num_procs, workload.mem_sizes, frames, num_points)) continue;
+                double sampled_time = time_curve(&sampled, &workload);
+                double total_error = 0.0, max_error = 0.0;
+                for (int p = 0; p < num_points; p++) {
+                    double error = fabs(mrc_fault_rate(&sampled, p) - mrc_fault_rate(&exact, p));
+                    total_error += error;
+                    if (error > max_error) max_error = error;
+                }
+                double speedup = sampled_time > 0 ? exact_time / sampled_time : 0.0;
+                fprintf(csv, "%s,%s,%s,%d,%g,%ld,%.6f,%.6f,%.1f,%.4f,%.4f\n", label, workloads[w].name,
+                        algos[a] == LRU ? "lru" : "fifo", length, rates[r], sampled.sampled, exact_time, sampled_time,
+                        speedup, total_error / num_points, max_error);
+                fprintf(stderr, "%-12s %-5s %-6g %10ld %10.3f %10.3f %9.4f %9.4f\n", workloads[w].name,
+                        algos[a] == LRU ? "lru" : "fifo", rates[r], sampled.sampled, exact_time, sampled_time,
+                        total_error / num_points, max_error);
+                mrc_destroy(&sampled);
+            }
+            mrc_destroy(&exact);
+        }
+        free_workload(&workload);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int length = 200000;
+    int num_procs = MAX_PROCESSES;
+    int repeats = 5;
+    const char *label = "local";
+    const char *csv_path = "bench_part1.csv";
+    const char *mrc_csv_path = "bench_mrc_part1.csv";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quiet") == 0) {
+            sim_options.quiet = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--length") == 0) length = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--procs") == 0) num_procs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--repeats") == 0) repeats = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--label") == 0) label = argv[++i];
+        else if (strcmp(argv[i], "--csv") == 0) csv_path = argv[++i];
+        else if (strcmp(argv[i], "--mrc-csv") == 0) mrc_csv_path = argv[++i];
+        else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (length < 1 || repeats < 1 || num_procs < 1 || num_procs > MAX_PROCESSES) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    BenchWorkload workloads[] = {
+        {"zipf", MODEL_ZIPF},
+        {"sequential", MODEL_SEQUENTIAL},
+        {"loop", MODEL_LOOP},
+        {"phases", MODEL_PHASES},
+        {"uniform", MODEL_UNIFORM}
+    };
+    int num_workloads = sizeof(workloads) / sizeof(workloads[0]);
+    const char *algo_names[] = {"fifo", "lru"};
+    const ReplacementAlgo algos[] = {FIFO, LRU};
+
+    FILE *csv = fopen(csv_path, "w");
+    if (csv == NULL) {
+        perror("Error opening results file");
+        return 1;
+    }
+    fprintf(csv, "label,workload,algo,accesses,repeats,median_sec,min_sec,accesses_per_sec,page_faults,ns_per_fault,peak_rss_kb,allocs_per_tick\n");
+    fprintf(stderr, "%-12s %-5s %14s %12s %12s %10s %12s\n", "workload", "algo", "accesses/sec", "ns/fault", "faults", "rss KB", "allocs/tick");
+
+    // The state tables go to the null device, so formatting is measured but not disk writes
+    if (freopen(NULL_DEVICE, "w", stdout) == NULL) {
+        perror("Error opening the null device");
+        fclose(csv);
+        return 1;
+    }
+
+    double *times = (double *)malloc(repeats * sizeof(double));
+    for (int w = 0; w < num_workloads; w++) {
+        WorkloadSpec spec = default_workload_spec();
+        spec.model = workloads[w].model;
+        spec.num_procs = num_procs;
+        spec.trace_len = length;
+        spec.seed = 42;
+        spec.max_memory = 30000;
+        Workload workload;
+        if (!generate_workload(&spec, &workload)) {
+            fprintf(stderr, "Could not generate workload %s\n", workloads[w].name);
+            continue;
+        }
+
+        for (int a = 0; a < 2; a++) {
+            long allocations = 0;
+            int faults = 0;
+            for (int r = 0; r < repeats; r++) {
+                long allocations_before = allocation_count;
+                double start = now_seconds();
+                run_simulation_logic(algos[a], workload.num_procs, workload.mem_sizes, workload.exec_trace, workload.trace_len);
+                times[r] = now_seconds() - start;
+                allocations = allocation_count - allocations_before;
+                faults = sim_stats.page_faults;
+            }
+
+            qsort(times, repeats, sizeof(double), compare_doubles);
+            double median = times[repeats / 2];
+            double accesses_per_sec = median > 0 ? length / median : 0.0;
+            double ns_per_fault = faults > 0 ? median * 1e9 / faults : 0.0;
+            double allocs_per_tick = (double)allocations / length;
+            long rss = peak_rss_kb();
+
+            fprintf(csv, "%s,%s,%s,%d,%d,%.6f,%.6f,%.0f,%d,%.1f,%ld,%.4f\n", label, workloads[w].name, algo_names[a],
+                    length, repeats, median, times[0], accesses_per_sec, faults, ns_per_fault, rss, allocs_per_tick);
+            fprintf(stderr, "%-12s %-5s %14.0f %12.1f %12d %10ld %12.4f\n", workloads[w].name, algo_names[a],
+                    accesses_per_sec, ns_per_fault, faults, rss, allocs_per_tick);
+        }
+        free_workload(&workload);
+    }
+    free(times);
+    fclose(csv);
+
+    FILE *mrc_csv = fopen(mrc_csv_path, "w");
+    if (mrc_csv == NULL) {
+        perror("Error opening results file");
+        return 1;
+    }
+    bench_mrc(mrc_csv, label, workloads, num_workloads, length, num_procs);
+    fclose(mrc_csv);
+    fprintf(stderr, "Results written to %s and %s\n", csv_path, mrc_csv_path);
+    return 0;
+}
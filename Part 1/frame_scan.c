@@ -0,0 +1,184 @@
+#include <limits.h>
+#include <string.h>
+#include "frame_scan.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define SCAN_WIDTH 8
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+    #define SCAN_WIDTH 4
+#else
+    #define SCAN_WIDTH 1
+#endif
+
+// --- Scalar Versions ---
+
+int scan_find_value_scalar(const int *values, int value, int count) {
+    for (int i = 0; i < count; i++) {
+        if (values[i] == value) return i;
+    }
+    return -1;
+}
+
+int scan_find_pair_scalar(const int *first, int first_value, const int *second, int second_value, int count) {
+    for (int i = 0; i < count; i++) {
+        if (first[i] == first_value && second[i] == second_value) return i;
+    }
+    return -1;
+}
+
+int scan_count_value_scalar(const int *values, int value, int count) {
+    int matches = 0;
+    for (int i = 0; i < count; i++) {
+        if (values[i] == value) matches++;
+    }
+    return matches;
+}
+
+int scan_min_index_scalar(const int *keys, const int *owners, const bool *eligible, int count) {
+    int best = -1;
+    for (int i = 0; i < count; i++) {
+        if (owners[i] == -1 || (eligible != NULL && !eligible[i])) continue;
+        if (best == -1 || keys[i] < keys[best]) best = i;
+    }
+    return best;
+}
+
+// --- Vector Helpers ---
+// Each helper turns SCAN_WIDTH lanes into a bit mask with one bit per frame.
+
+#if SCAN_WIDTH == 8
+
+typedef __m256i lanes_t;
+#define LOAD_LANES(pointer) _mm256_loadu_si256((const __m256i *)(pointer))
+#define SPLAT_LANES(value) _mm256_set1_epi32(value)
+#define EQUAL_LANES(a, b) _mm256_cmpeq_epi32(a, b)
+#define AND_LANES(a, b) _mm256_and_si256(a, b)
+#define LANE_BITS(v) _mm256_movemask_ps(_mm256_castsi256_ps(v))
+#define MIN_LANES(a, b) _mm256_min_epi32(a, b)
+#define SELECT_LANES(mask, yes, no) _mm256_blendv_epi8(no, yes, mask)
+
+// All-ones lanes for the frames whose eligible flag is set
+static lanes_t eligible_lanes(const bool *eligible, int start) {
+    if (eligible == NULL) return _mm256_set1_epi32(-1);
+    long long bytes;
+    memcpy(&bytes, eligible + start, sizeof(bytes));
+    __m256i widened = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(bytes));
+    return _mm256_cmpgt_epi32(widened, _mm256_setzero_si256());
+}
+
+#elif SCAN_WIDTH == 4
+
+typedef __m128i lanes_t;
+#define LOAD_LANES(pointer) _mm_loadu_si128((const __m128i *)(pointer))
+#define SPLAT_LANES(value) _mm_set1_epi32(value)
+#define EQUAL_LANES(a, b) _mm_cmpeq_epi32(a, b)
+#define AND_LANES(a, b) _mm_and_si128(a, b)
+#define LANE_BITS(v) _mm_movemask_ps(_mm_castsi128_ps(v))
+#define SELECT_LANES(mask, yes, no) _mm_or_si128(_mm_and_si128(mask, yes), _mm_andnot_si128(mask, no))
+
+// SSE2 has no signed 32-bit minimum, so build it from a compare
+static lanes_t MIN_LANES(lanes_t a, lanes_t b) {
+    lanes_t a_smaller = _mm_cmplt_epi32(a, b);
+    return SELECT_LANES(a_smaller, a, b);
+}
+
+static lanes_t eligible_lanes(const bool *eligible, int start) {
+    if (eligible == NULL) return _mm_set1_epi32(-1);
+    int bytes;
+    memcpy(&bytes, eligible + start, sizeof(bytes));
+    __m128i zero = _mm_setzero_si128();
+    __m128i widened = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+    return _mm_cmpgt_epi32(widened, zero);
+}
+
+#endif
+
+// --- Public Scans ---
+
+int scan_find_value(const int *values, int value, int count) {
+    int i = 0;
+#if SCAN_WIDTH > 1
+    lanes_t target = SPLAT_LANES(value);
+    for (; i + SCAN_WIDTH <= count; i += SCAN_WIDTH) {
+        int bits = LANE_BITS(EQUAL_LANES(LOAD_LANES(values + i), target));
+        if (bits) return i + __builtin_ctz(bits);
+    }
+#endif
+    int rest = scan_find_value_scalar(values + i, value, count - i);
+    return rest == -1 ? -1 : i + rest;
+}
+
+int scan_find_pair(const int *first, int first_value, const int *second, int second_value, int count) {
+    int i = 0;
+#if SCAN_WIDTH > 1
+    lanes_t first_target = SPLAT_LANES(first_value);
+    lanes_t second_target = SPLAT_LANES(second_value);
+    for (; i + SCAN_WIDTH <= count; i += SCAN_WIDTH) {
+        lanes_t match = AND_LANES(EQUAL_LANES(LOAD_LANES(first + i), first_target),
+                                  EQUAL_LANES(LOAD_LANES(second + i), second_target));
+        int bits = LANE_BITS(match);
+        if (bits) return i + __builtin_ctz(bits);
+    }
+#endif
+    int rest = scan_find_pair_scalar(first + i, first_value, second + i, second_value, count - i);
+    return rest == -1 ? -1 : i + rest;
+}
+
+int scan_count_value(const int *values, int value, int count) {
+    int i = 0, matches = 0;
+#if SCAN_WIDTH > 1
+    lanes_t target = SPLAT_LANES(value);
+    for (; i + SCAN_WIDTH <= count; i += SCAN_WIDTH) {
+        matches += __builtin_popcount(LANE_BITS(EQUAL_LANES(LOAD_LANES(values + i), target)));
+    }
+#endif
+    return matches + scan_count_value_scalar(values + i, value, count - i);
+}
+
+int scan_min_index(const int *keys, const int *owners, const bool *eligible, int count) {
+#if SCAN_WIDTH > 1
+    // First pass: smallest key over the eligible frames (the others count as INT_MAX)
+    lanes_t free_owner = SPLAT_LANES(-1);
+    lanes_t largest = SPLAT_LANES(INT_MAX);
+    lanes_t minimum = largest;
+    int any_eligible = 0;
+    int i = 0;
+    for (; i + SCAN_WIDTH <= count; i += SCAN_WIDTH) {
+        lanes_t occupied = EQUAL_LANES(EQUAL_LANES(LOAD_LANES(owners + i), free_owner), SPLAT_LANES(0));
+        lanes_t usable = AND_LANES(occupied, eligible_lanes(eligible, i));
+        any_eligible |= LANE_BITS(usable);
+        minimum = MIN_LANES(minimum, SELECT_LANES(usable, LOAD_LANES(keys + i), largest));
+    }
+    int lane_values[SCAN_WIDTH];
+    memcpy(lane_values, &minimum, sizeof(lane_values));
+    int smallest = INT_MAX;
+    for (int lane = 0; lane < SCAN_WIDTH; lane++) {
+        if (lane_values[lane] < smallest) smallest = lane_values[lane];
+    }
+    int vector_end = i;
+    for (; i < count; i++) {
+        if (owners[i] == -1 || (eligible != NULL && !eligible[i])) continue;
+        any_eligible = 1;
+        if (keys[i] < smallest) smallest = keys[i];
+    }
+    if (!any_eligible) return -1;
+
+    // Second pass: the first eligible frame holding that key
+    lanes_t target = SPLAT_LANES(smallest);
+    for (i = 0; i < vector_end; i += SCAN_WIDTH) {
+        lanes_t occupied = EQUAL_LANES(EQUAL_LANES(LOAD_LANES(owners + i), free_owner), SPLAT_LANES(0));
+        lanes_t match = AND_LANES(AND_LANES(occupied, eligible_lanes(eligible, i)),
+                                  EQUAL_LANES(LOAD_LANES(keys + i), target));
+        int bits = LANE_BITS(match);
+        if (bits) return i + __builtin_ctz(bits);
+    }
+    for (; i < count; i++) {
+        if (owners[i] != -1 && (eligible == NULL || eligible[i]) && keys[i] == smallest) return i;
+    }
+    return -1;
+#else
+    return scan_min_index_scalar(keys, owners, eligible, count);
+#endif
+}
@@ -0,0 +1,26 @@
+#ifndef FRAME_SCAN_H
+#define FRAME_SCAN_H
+
+#include <stdbool.h>
+
+// Linear scans over one column of the frame table.
+// They use AVX2 or SSE2 when the compiler targets them (e.g. make CFLAGS+=-mavx2) and plain loops
+// otherwise. Every version returns the lowest matching index, which keeps the frame id tie-breaks.
+
+// First i with values[i] == value, or -1
+int scan_find_value(const int *values, int value, int count);
+// First i with first[i] == first_value and second[i] == second_value, or -1
+int scan_find_pair(const int *first, int first_value, const int *second, int second_value, int count);
+// Number of i with values[i] == value
+int scan_count_value(const int *values, int value, int count);
+// First i holding the smallest keys[i] among the frames with owners[i] != -1 and eligible[i]
+// (eligible may be NULL to allow every occupied frame), or -1 if there is none
+int scan_min_index(const int *keys, const int *owners, const bool *eligible, int count);
+
+// Plain loop versions, also used by the fuzzer to cross-check the vector code
+int scan_find_value_scalar(const int *values, int value, int count);
+int scan_find_pair_scalar(const int *first, int first_value, const int *second, int second_value, int count);
+int scan_count_value_scalar(const int *values, int value, int count);
+int scan_min_index_scalar(const int *keys, const int *owners, const bool *eligible, int count);
+
+#endif
@@ -0,0 +1,561 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "p1_simulator.h"
+#include "p1_reference.h"
+#include "inputs_part1.h"
+#include "workload.h"
+#include "frame_scan.h"
+#include "mrc.h"
+
+// Differential fuzzer: every case is run through the reference engine and the current engine,
+// and the two state tables must be byte for byte identical.
+
+#if NUM_FRAMES != 7
+#error "The reference engine is fixed at 7 frames, build the fuzzer with the default NUM_FRAMES"
+#endif
+
+#define REFERENCE_OUTPUT "fuzz_reference.out"
+#define ENGINE_OUTPUT "fuzz_engine.out"
+#define FAILURE_TRACE "fuzz_failure.trace"
+
+#ifdef _WIN32
+    #define NULL_DEVICE "NUL"
+#else
+    #define NULL_DEVICE "/dev/null"
+#endif
+
+char *read_file(const char *path, long *length) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return NULL;
+    fseek(file, 0, SEEK_END);
+    *length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *data = (char *)malloc(*length + 1);
+    if (data != NULL && fread(data, 1, *length, file) != (size_t)*length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    return data;
+}
+
+// Compares two files and reports the first line that differs
+bool same_output(const char *expected_path, const char *actual_path) {
+    long expected_length = 0, actual_length = 0;
+    char *expected = read_file(expected_path, &expected_length);
+    char *actual = read_file(actual_path, &actual_length);
+    bool same = expected != NULL && actual != NULL && expected_length == actual_length &&
+                memcmp(expected, actual, expected_length) == 0;
+    if (!same && expected != NULL && actual != NULL) {
+        long line = 1;
+        for (long i = 0; i < expected_length && i < actual_length && expected[i] == actual[i]; i++) {
+            if (expected[i] == '\n') line++;
+        }
+        fprintf(stderr, "  %s and %s differ at line %ld\n", expected_path, actual_path, line);
+    }
+    free(expected);
+    free(actual);
+    return same;
+}
+
+void run_engine(const char *path, bool reference, ReplacementAlgo algo, const Workload *workload) {
+    freopen(path, "w", stdout);
+    if (reference) {
+        reference_print_header(workload->num_procs);
+        run_reference_simulation(algo, workload->num_procs, workload->mem_sizes, workload->exec_trace, workload->trace_len);
+    } else {
+        print_header(workload->num_procs);
+        run_simulation_logic(algo, workload->num_procs, workload->mem_sizes, workload->exec_trace, workload->trace_len);
+    }
+    fflush(stdout);
+    freopen(NULL_DEVICE, "w", stdout);
+}
+
+// Compares the counters a quiet run must reproduce from a run that printed the table.
+bool same_counters(const SimulationStats *a, const SimulationStats *b) {
+    return a->accesses == b->accesses && a->page_faults == b->page_faults && a->segfaults == b->segfaults &&
+           memcmp(a->process_faults, b->process_faults, sizeof(a->process_faults)) == 0;
+}
+
+// Runs one case with both policies, through the specialized kernels and through the general loop.
+// Each engine run is repeated quietly, which must count the same. On a mismatch the case is saved to FAILURE_TRACE.
+bool check_case(const Workload *workload, const char *description) {
+    const ReplacementAlgo algos[] = {FIFO, LRU};
+    for (int a = 0; a < 2; a++) {
+        run_engine(REFERENCE_OUTPUT, true, algos[a], workload);
+        for (int generic = 0; generic < 2; generic++) {
+            sim_options.force_generic = generic;
+            run_engine(ENGINE_OUTPUT, false, algos[a], workload);
+            SimulationStats table_stats = sim_stats;
+            sim_options.quiet = true;
+            run_simulation_logic(algos[a], workload->num_procs, workload->mem_sizes, workload->exec_trace, workload->trace_len);
+            sim_options.quiet = false;
+            sim_options.force_generic = false;
+
+            if (!same_output(REFERENCE_OUTPUT, ENGINE_OUTPUT) || !same_counters(&table_stats, &sim_stats)) {
+                fprintf(stderr, "Mismatch on %s with %s (%s loop), case saved to %s\n", description,
+                        algos[a] == FIFO ? "FIFO" : "LRU", generic ? "general" : "specialized", FAILURE_TRACE);
+                FILE *file = fopen(FAILURE_TRACE, "w");
+                if (file != NULL) {
+                    write_workload_text(file, workload);
+                    fclose(file);
+                }
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Contiguous allocation has no reference engine. Every partition must be given back by the end of
+// the trace, and the quiet run must count the same as the table run.
+bool check_contiguous(const Workload *workload, const char *description) {
+    sim_options.contiguous = true;
+    sim_options.alloc_strategy = (AllocStrategy)(rand() % 4);
+    sim_options.compaction = rand() % 2;
+    freopen(NULL_DEVICE, "w", stdout);
+    run_simulation_logic(LRU, workload->num_procs, workload->mem_sizes, workload->exec_trace, workload->trace_len);
+    SimulationStats table_stats = sim_stats;
+    AllocatorStats table_allocator = sim_partitions.stats;
+    bool released = true;
+    for (int pid = 1; pid <= workload->num_procs; pid++) {
+        released = released && allocator_find(&sim_partitions, pid) == NULL;
+    }
+    sim_options.quiet = true;
+    run_simulation_logic(LRU, workload->num_procs, workload->mem_sizes, workload->exec_trace, workload->trace_len);
+    sim_options.quiet = false;
+    sim_options.contiguous = false;
+    bool same = same_counters(&table_stats, &sim_stats) && table_stats.rejected_accesses == sim_stats.rejected_accesses &&
+                memcmp(&table_allocator, &sim_partitions.stats, sizeof(AllocatorStats)) == 0;
+    if (!released || !same) {
+        fprintf(stderr, "Contiguous run (%s) of %s %s\n", alloc_strategy_name(sim_options.alloc_strategy), description,
+                released ? "counts differently when quiet" : "keeps partitions after the trace");
+        return false;
+    }
+    return true;
+}
+
+// Random cache levels, sizes kept to whole sets
+CacheLevelConfig random_cache_level(void) {
+    CacheLevelConfig config;
+    config.line_size = 16 << (rand() % 3);
+    config.ways = 1 << (rand() % 4);
+    config.size = config.line_size * config.ways * (1 + rand() % 16);
+    config.replacement = rand() % 3;
+    return config;
+}
+
+// Caches only watch the accesses: the table must still match the reference engine, every valid
+// access must reach L1, every miss of a level must reach the next one, and a quiet run must count the same.
+bool check_cache(const Workload *workload, const char *description) {
+    sim_options.cache = true;
+    sim_options.num_cache_levels = rand() % (CACHE_LEVELS + 1);
+    for (int l = 0; l < sim_options.num_cache_levels; l++) {
+        sim_options.cache_levels[l] = random_cache_level();
+    }
+    sim_options.cache_pollution = rand() % 3 == 0 ? rand() % 101 : 0;
+    ReplacementAlgo algo = rand() % 2 ? LRU : FIFO;
+    run_engine(REFERENCE_OUTPUT, true, algo, workload);
+    run_engine(ENGINE_OUTPUT, false, algo, workload);
+    bool same = same_output(REFERENCE_OUTPUT, ENGINE_OUTPUT);
+    int valid_accesses = sim_stats.accesses - sim_stats.segfaults;
+    int first_pid = workload->trace_len > 0 ? workload->exec_trace[0] : 1;
+    if (first_pid < 1 || first_pid > workload->num_procs) valid_accesses--; // Loaded for the table, but no process of the trace
+    bool flows = sim_cache.levels[0].accesses == valid_accesses;
+    for (int l = 1; l < sim_cache.num_levels; l++) {
+        flows = flows && sim_cache.levels[l].accesses == sim_cache.levels[l - 1].misses;
+    }
+    long long table_counters[2 * CACHE_LEVELS + 1] = {sim_cache.switches};
+    for (int l = 0; l < sim_cache.num_levels; l++) {
+        table_counters[2 * l + 1] = sim_cache.levels[l].accesses;
+        table_counters[2 * l + 2] = sim_cache.levels[l].misses;
+    }
+    sim_options.quiet = true;
+    run_simulation_logic(algo, workload->num_procs, workload->mem_sizes, workload->exec_trace, workload->trace_len);
+    sim_options.quiet = false;
+    sim_options.cache = false;
+    bool quiet_same = sim_cache.switches == table_counters[0];
+    for (int l = 0; l < sim_cache.num_levels; l++) {
+        quiet_same = quiet_same && sim_cache.levels[l].accesses == table_counters[2 * l + 1] &&
+                     sim_cache.levels[l].misses == table_counters[2 * l + 2];
+    }
+    if (!same || !flows || !quiet_same) {
+        fprintf(stderr, "Cached run of %s %s\n", description,
+                !same ? "changes the table" : !flows ? "loses accesses between levels" : "counts differently when quiet");
+        return false;
+    }
+    return true;
+}
+
+// First touch without migration fills the frames in the same order as one flat pool, so the table must
+// match the reference engine. Interleave and migration only move pages between frames and keep their
+// times, so the faults must match a flat run. Every valid access is charged to one node, and a quiet
+// run must count and migrate the same.
+bool check_tiers(const Workload *workload, const char *description) {
+    ReplacementAlgo algo = rand() % 2 ? LRU : FIFO;
+    sim_options.quiet = true;
+    run_simulation_logic(algo, workload->num_procs, workload->mem_sizes, workload->exec_trace, workload->trace_len);
+    sim_options.quiet = false;
+    SimulationStats flat_stats = sim_stats;
+
+    sim_options.num_tiers = 1 + rand() % MAX_TIERS;
+    int frames_left = NUM_FRAMES;
+    for (int t = 0; t < sim_options.num_tiers; t++) {
+        int frames = 1 + rand() % (frames_left - (sim_options.num_tiers - t - 1));
+        sim_options.tiers[t].frames = frames;
+        sim_options.tiers[t].latency = (t + 1) * 100;
+        frames_left -= frames;
+    }
+    sim_options.placement = (TierPlacement)(rand() % 2);
+    sim_options.migrate_interval = rand() % 8;
+    sim_options.hot_threshold = 1 + rand() % 3;
+    run_engine(REFERENCE_OUTPUT, true, algo, workload);
+    run_engine(ENGINE_OUTPUT, false, algo, workload);
+    bool same = same_counters(&flat_stats, &sim_stats);
+    if (sim_options.placement == PLACE_FIRST_TOUCH && sim_options.migrate_interval == 0) {
+        same = same && same_output(REFERENCE_OUTPUT, ENGINE_OUTPUT);
+    }
+    SimulationStats table_stats = sim_stats;
+    int charged = 0;
+    for (int t = 0; t < sim_options.num_tiers; t++) {
+        charged += sim_stats.tier_accesses[t];
+    }
+    int valid_accesses = sim_stats.accesses - sim_stats.segfaults;
+    int first_pid = workload->trace_len > 0 ? workload->exec_trace[0] : 1;
+    if (first_pid < 1 || first_pid > workload->num_procs) valid_accesses--;
+    sim_options.quiet = true;
+    run_simulation_logic(algo, workload->num_procs, workload->mem_sizes, workload->exec_trace, workload->trace_len);
+    sim_options.quiet = false;
+    sim_options.num_tiers = 0;
+    bool quiet_same = same_counters(&table_stats, &sim_stats) && table_stats.access_latency == sim_stats.access_latency &&
+                      table_stats.promotions == sim_stats.promotions && table_stats.demotions == sim_stats.demotions;
+    if (!same || charged != valid_accesses || !quiet_same) {
+        fprintf(stderr, "Tiered run of %s %s\n", description,
+                !same ? "changes the faults or the table" : charged != valid_accesses ? "charges the wrong accesses" : "counts differently when quiet");
+        return false;
+    }
+    return true;
+}
+
+// The zswap pool keeps its frames out of reach of the pages and only holds pages that left memory:
+// at the end no compressed page is resident or belongs to a process killed by a segmentation fault,
+// every fault is either a pool hit or a backing store read, and a quiet run counts the same.
+bool check_zswap(const Workload *workload, const char *description) {
+    sim_options.zswap_frames = 1 + rand() % (NUM_FRAMES - 1);
+    sim_options.zswap_ratio = 1.0 + rand() % 30 / 10.0;
+    sim_options.prefetch_depth = rand() % 3;
+    ReplacementAlgo algo = rand() % 2 ? LRU : FIFO;
+    freopen(NULL_DEVICE, "w", stdout);
+    run_simulation_logic(algo, workload->num_procs, workload->mem_sizes, workload->exec_trace, workload->trace_len);
+    SimulationStats table_stats = sim_stats;
+    ZswapPool table_pool = sim_zswap;
+    StateSnapshot snapshot;
+    capture_state(0, workload->num_procs, &snapshot);
+
+    bool consistent = sim_zswap.hits + sim_zswap.misses == sim_stats.page_faults && sim_zswap.count <= sim_zswap.capacity;
+    for (int i = NUM_FRAMES - sim_options.zswap_frames; i < NUM_FRAMES; i++) {
+        consistent = consistent && snapshot.process_id[i] == ZSWAP_FRAME;
+    }
+    for (int e = 0; e < sim_zswap.count; e++) {
+        const ZswapEntry *entry = &sim_zswap.entries[e];
+        // The first access of the trace is loaded even for a pid past num_procs, which never terminates
+        consistent = consistent && (entry->pid > workload->num_procs || !snapshot.terminated[entry->pid - 1]);
+        for (int i = 0; i < NUM_FRAMES; i++) {
+            consistent = consistent && !(snapshot.process_id[i] == entry->pid && snapshot.page_number[i] == entry->page);
+        }
+    }
+    sim_options.quiet = true;
+    run_simulation_logic(algo, workload->num_procs, workload->mem_sizes, workload->exec_trace, workload->trace_len);
+    sim_options.quiet = false;
+    sim_options.zswap_frames = 0;
+    sim_options.prefetch_depth = 0;
+    bool same = same_counters(&table_stats, &sim_stats) && table_pool.hits == sim_zswap.hits &&
+                table_pool.writebacks == sim_zswap.writebacks && table_pool.stores == sim_zswap.stores;
+    if (!consistent || !same) {
+        fprintf(stderr, "Run of %s with a %d frame zswap pool %s\n", description, table_pool.frames,
+                !consistent ? "leaves the pool inconsistent" : "counts differently when quiet");
+        return false;
+    }
+    return true;
+}
+
+// Local replacement with a random quota split, sometimes with a first access whose pid has no quota:
+// past num_procs, where an earlier case may have left a quota, or past MAX_PROCESSES (an out of bounds
+// read that a sanitizer build of the fuzzer flags).
+// Every fault either finds a free frame or reclaims one, and the quiet run must count the same.
+bool check_local(const Workload *workload, const char *description) {
+    Workload shifted = *workload;
+    int *shifted_trace = NULL;
+    if (workload->trace_len > 0 && rand() % 3 == 0) {
+        size_t bytes = ((size_t)workload->trace_len * 2 + 2) * sizeof(int);
+        shifted_trace = (int *)malloc(bytes);
+        memcpy(shifted_trace, workload->exec_trace, bytes);
+        shifted_trace[0] = rand() % 2 ? workload->num_procs + 1 + rand() % (MAX_PROCESSES - workload->num_procs + 1)
+                                      : MAX_PROCESSES + 1 + rand() % 100;
+        shifted.exec_trace = shifted_trace;
+        workload = &shifted;
+    }
+    sim_options.replacement_scope = LOCAL_REPLACEMENT;
+    sim_options.frame_allocation = (FrameAllocation)(rand() % 3);
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        sim_options.priorities[i] = 1 + rand() % 5;
+    }
+    ReplacementAlgo algo = rand() % 2 ? LRU : FIFO;
+    freopen(NULL_DEVICE, "w", stdout);
+    run_simulation_logic(algo, workload->num_procs, workload->mem_sizes, workload->exec_trace, workload->trace_len);
+    SimulationStats table_stats = sim_stats;
+    bool consistent = sim_stats.free_frame_faults + sim_stats.direct_reclaims == sim_stats.page_faults;
+
+    sim_options.quiet = true;
+    run_simulation_logic(algo, workload->num_procs, workload->mem_sizes, workload->exec_trace, workload->trace_len);
+    sim_options.quiet = false;
+    sim_options.replacement_scope = GLOBAL_REPLACEMENT;
+    sim_options.frame_allocation = ALLOC_EQUAL;
+    memset(sim_options.priorities, 0, sizeof(sim_options.priorities));
+    bool same = same_counters(&table_stats, &sim_stats) && table_stats.direct_reclaims == sim_stats.direct_reclaims;
+    free(shifted_trace);
+    if (!consistent || !same) {
+        fprintf(stderr, "Local replacement run of %s %s\n", description,
+                !consistent ? "miscounts the faults" : "counts differently when quiet");
+        return false;
+    }
+    return true;
+}
+
+// Background reclaim with random watermarks, sometimes on top of local replacement, large pages or a
+// zswap pool, and sometimes with a first access far past the end of its process that the daemon may
+// reclaim (caught by a sanitizer build of the fuzzer).
+// Every fault either finds a free frame or reclaims one itself, the daemon cannot be blamed for more
+// refaults than the pages it evicted, and the quiet run must count the same.
+bool check_kswapd(const Workload *workload, const char *description) {
+    Workload shifted = *workload;
+    int *shifted_trace = NULL;
+    int first_pid = workload->trace_len > 0 ? workload->exec_trace[0] : 0;
+    if (first_pid >= 1 && first_pid <= workload->num_procs && rand() % 4 == 0) {
+        size_t bytes = ((size_t)workload->trace_len * 2 + 2) * sizeof(int);
+        shifted_trace = (int *)malloc(bytes);
+        memcpy(shifted_trace, workload->exec_trace, bytes);
+        shifted_trace[1] = workload->mem_sizes[first_pid - 1] + (1 + rand() % 8) * 10 * PAGE_SIZE;
+        shifted.exec_trace = shifted_trace;
+        workload = &shifted;
+    }
+    sim_options.zswap_frames = rand() % 3 == 0 ? 1 + rand() % (NUM_FRAMES - 1) : 0;
+    sim_options.replacement_scope = sim_options.zswap_frames == 0 && rand() % 3 == 0 ? LOCAL_REPLACEMENT : GLOBAL_REPLACEMENT;
+    if (sim_options.zswap_frames == 0 && rand() % 3 == 0) {
+        sim_options.huge_page_frames = 2;
+        for (int i = 0; i < MAX_PROCESSES; i++) {
+            sim_options.large_page_procs[i] = rand() % 2;
+        }
+    }
+    int usable_frames = NUM_FRAMES - sim_options.zswap_frames;
+    sim_options.kswapd = true;
+    sim_options.low_watermark = 1 + rand() % usable_frames;
+    sim_options.high_watermark = sim_options.low_watermark + rand() % (usable_frames - sim_options.low_watermark + 1);
+    sim_options.kswapd_batch = 1 + rand() % 3;
+    ReplacementAlgo algo = rand() % 2 ? LRU : FIFO;
+    freopen(NULL_DEVICE, "w", stdout);
+    run_simulation_logic(algo, workload->num_procs, workload->mem_sizes, workload->exec_trace, workload->trace_len);
+    SimulationStats table_stats = sim_stats;
+    bool consistent = sim_stats.free_frame_faults + sim_stats.direct_reclaims == sim_stats.page_faults &&
+                      sim_stats.kswapd_refaults <= sim_stats.kswapd_reclaimed;
+
+    sim_options.quiet = true;
+    run_simulation_logic(algo, workload->num_procs, workload->mem_sizes, workload->exec_trace, workload->trace_len);
+    sim_options.quiet = false;
+    sim_options.kswapd = false;
+    sim_options.zswap_frames = 0;
+    sim_options.replacement_scope = GLOBAL_REPLACEMENT;
+    sim_options.huge_page_frames = 0;
+    memset(sim_options.large_page_procs, 0, sizeof(sim_options.large_page_procs));
+    bool same = same_counters(&table_stats, &sim_stats) && table_stats.direct_reclaims == sim_stats.direct_reclaims &&
+                table_stats.kswapd_reclaimed == sim_stats.kswapd_reclaimed &&
+                table_stats.kswapd_refaults == sim_stats.kswapd_refaults;
+    free(shifted_trace);
+    if (!consistent || !same) {
+        fprintf(stderr, "Run of %s with watermarks %d-%d %s\n", description, sim_options.low_watermark,
+                sim_options.high_watermark, !consistent ? "miscounts the faults" : "counts differently when quiet");
+        return false;
+    }
+    return true;
+}
+
+// A curve that samples every page is a plain simulation of each of its memory sizes, so at NUM_FRAMES
+// it must count what the engine counts when the same records are streamed through simulate_access().
+// A sampled curve can only see fewer references than there are, and miss at most all of them.
+bool check_mrc(const Workload *workload, const char *description) {
+    ReplacementAlgo algo = rand() % 2 ? LRU : FIFO;
+    int frames[2] = {NUM_FRAMES, 1 + rand() % (2 * NUM_FRAMES)};
+    double rate = (1 + rand() % 100) / 100.0;
+    MissRatioCurve exact, sampled;
+    if (!mrc_init(&exact, algo, 1.0, workload->num_procs, workload->mem_sizes, frames, 2) ||
+        !mrc_init(&sampled, algo, rate, workload->num_procs, workload->mem_sizes, frames, 2)) {
+        fprintf(stderr, "Could not allocate the curves of %s\n", description);
+        return false;
+    }
+    initialize_simulation(workload->num_procs, workload->mem_sizes);
+    for (int n = 0; n < workload->trace_len; n++) {
+        int pid = workload->exec_trace[2 * n], address = workload->exec_trace[2 * n + 1];
+        simulate_access(algo, workload->num_procs, pid, address, n);
+        mrc_access(&exact, pid, address);
+        mrc_access(&sampled, pid, address);
+    }
+    free_page_tables(workload->num_procs);
+
+    bool same = exact.accesses == sim_stats.accesses && exact.points[0].misses == sim_stats.page_faults &&
+                exact.sampled == exact.references;
+    bool bounded = sampled.accesses == exact.accesses && sampled.references == exact.references &&
+                   sampled.sampled <= sampled.references;
+    for (int p = 0; p < 2; p++) {
+        bounded = bounded && sampled.points[p].misses <= sampled.sampled;
+    }
+    mrc_destroy(&exact);
+    mrc_destroy(&sampled);
+    if (!same || !bounded) {
+        fprintf(stderr, "Fault rate curve of %s with %s %s\n", description, algo == LRU ? "LRU" : "FIFO",
+                !same ? "does not count like the engine" : "samples more than it reads");
+        return false;
+    }
+    return true;
+}
+
+// Copies a built-in input into a workload with the terminator pair the engines may read
+Workload copy_input(int num_procs, const int mem_sizes[], const int exec_trace[], int trace_len) {
+    Workload workload;
+    workload.num_procs = num_procs;
+    workload.trace_len = trace_len;
+    workload.mem_sizes = (int *)malloc(num_procs * sizeof(int));
+    workload.exec_trace = (int *)calloc((size_t)trace_len * 2 + 2, sizeof(int));
+    memcpy(workload.mem_sizes, mem_sizes, num_procs * sizeof(int));
+    memcpy(workload.exec_trace, exec_trace, (size_t)trace_len * 2 * sizeof(int));
+    return workload;
+}
+
+// Random trace with invalid pids, out of bounds addresses and early terminators mixed in
+Workload random_case(void) {
+    if (rand() % 2 == 0) {
+        WorkloadSpec spec = default_workload_spec();
+        spec.model = (AccessModel)(rand() % 5);
+        spec.num_procs = 1 + rand() % MAX_PROCESSES;
+        spec.trace_len = rand() % 300;
+        spec.seed = rand();
+        spec.max_memory = 3000 + rand() % 30000;
+        spec.burst_length = 1 + rand() % 4;
+        spec.segfault_rate = (rand() % 4) / 40.0;
+        Workload workload;
+        if (generate_workload(&spec, &workload)) return workload;
+    }
+
+    int num_procs = 1 + rand() % MAX_PROCESSES;
+    int trace_len = rand() % 120;
+    Workload workload;
+    workload.num_procs = num_procs;
+    workload.trace_len = trace_len;
+    workload.mem_sizes = (int *)malloc(num_procs * sizeof(int));
+    workload.exec_trace = (int *)calloc((size_t)trace_len * 2 + 2, sizeof(int));
+    for (int i = 0; i < num_procs; i++) {
+        workload.mem_sizes[i] = rand() % 25000;
+    }
+    for (int n = 0; n < trace_len; n++) {
+        int pid = 1 + rand() % (num_procs + 2); // Some pids are past num_procs
+        if (rand() % 200 == 0) pid = 0;        // Early end of the trace
+        int memory_size = pid >= 1 && pid <= num_procs ? workload.mem_sizes[pid - 1] : 10000;
+        workload.exec_trace[2 * n] = pid;
+        workload.exec_trace[2 * n + 1] = rand() % (memory_size + 3000);
+    }
+    return workload;
+}
+
+// The engine only has 7 frames here, which leaves most of the vector scan code unused,
+// so the scans are also compared with their scalar versions on random columns of every length.
+int check_scan_kernels(int rounds) {
+    enum { MAX_COLUMN = 70 };
+    int owners[MAX_COLUMN], keys[MAX_COLUMN], pages[MAX_COLUMN];
+    bool eligible[MAX_COLUMN];
+    for (int n = 0; n < rounds; n++) {
+        int count = rand() % (MAX_COLUMN + 1);
+        for (int i = 0; i < count; i++) {
+            owners[i] = rand() % 4 - 1; // Small ranges so matches and ties are common
+            pages[i] = rand() % 3;
+            keys[i] = rand() % 2 == 0 ? rand() % 5 : rand() - RAND_MAX / 2;
+            eligible[i] = rand() % 4 != 0;
+        }
+        int value = rand() % 4 - 1, page = rand() % 3;
+        const bool *mask = rand() % 2 == 0 ? eligible : NULL;
+        if (scan_find_value(owners, value, count) != scan_find_value_scalar(owners, value, count) ||
+            scan_find_pair(owners, value, pages, page, count) != scan_find_pair_scalar(owners, value, pages, page, count) ||
+            scan_count_value(owners, value, count) != scan_count_value_scalar(owners, value, count) ||
+            scan_min_index(keys, owners, mask, count) != scan_min_index_scalar(keys, owners, mask, count)) {
+            fprintf(stderr, "Frame scan mismatch on a column of %d frames (round %d)\n", count, n);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    int iterations = 2000;
+    unsigned seed = 1;
+    const char *seed_dir = "../Desired outputs";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--iterations") == 0) iterations = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0) seed = (unsigned)strtoul(argv[i + 1], NULL, 10);
+        else if (strcmp(argv[i], "--seed-dir") == 0) seed_dir = argv[i + 1];
+        else {
+            fprintf(stderr, "Usage: %s [--iterations N] [--seed N] [--seed-dir DIR]\n", argv[0]);
+            return 1;
+        }
+    }
+    srand(seed);
+
+    // Seed cases: the built-in inputs, and the published expected tables for test case 00
+    struct { int num_procs; int *mem_sizes; int *exec_trace; int trace_len; } inputs[] = {
+        {5,  inputP1Mem00, inputP1Exec00, 12},
+        {5,  inputP1Mem01, inputP1Exec01, 6},
+        {5,  inputP1Mem02, inputP1Exec02, 9},
+        {10, inputP1Mem03, inputP1Exec03, 9},
+        {20, inputP1Mem04, inputP1Exec04, 35},
+        {3,  inputP1Mem05, inputP1Exec05, 18}
+    };
+    int failures = check_scan_kernels(iterations * 10) ? 0 : 1;
+    for (int i = 0; i < 6; i++) {
+        Workload workload = copy_input(inputs[i].num_procs, inputs[i].mem_sizes, inputs[i].exec_trace, inputs[i].trace_len);
+        char description[32];
+        sprintf(description, "built-in input %02d", i);
+        if (!check_case(&workload, description)) failures++;
+
+        if (i == 0) {
+            const char *names[] = {"fifo00.out", "lru00.out"};
+            const ReplacementAlgo algos[] = {FIFO, LRU};
+            for (int a = 0; a < 2; a++) {
+                char desired[512];
+                snprintf(desired, sizeof(desired), "%s/%s", seed_dir, names[a]);
+                run_engine(ENGINE_OUTPUT, false, algos[a], &workload);
+                if (!same_output(desired, ENGINE_OUTPUT)) {
+                    fprintf(stderr, "Engine does not reproduce %s\n", desired);
+                    failures++;
+                }
+            }
+        }
+        free_workload(&workload);
+    }
+
+    for (int n = 0; n < iterations && failures == 0; n++) {
+        Workload workload = random_case();
+        char description[32];
+        sprintf(description, "random case %d", n);
+        if (!check_case(&workload, description) || !check_contiguous(&workload, description) ||
+            !check_cache(&workload, description) || !check_tiers(&workload, description) ||
+            !check_zswap(&workload, description) || !check_local(&workload, description) ||
+            !check_kswapd(&workload, description) ||
+            !check_mrc(&workload, description)) {
+            failures++;
+        }
+        free_workload(&workload);
+    }
+
+    remove(REFERENCE_OUTPUT);
+    remove(ENGINE_OUTPUT);
+    fprintf(stderr, "%s: %d random cases, seed %u\n", failures == 0 ? "PASS" : "FAIL", iterations, seed);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "workload.h"
+
+void print_usage(const char *program_name) {
+    fprintf(stderr, "Usage: %s [options]\n", program_name);
+    fprintf(stderr, "  --model NAME      uniform, zipf, sequential, loop or phases (default zipf)\n");
+    fprintf(stderr, "  --procs N         Number of processes (default 5)\n");
+    fprintf(stderr, "  --length N        Number of accesses (default 1000)\n");
+    fprintf(stderr, "  --seed N          Random seed (default 1)\n");
+    fprintf(stderr, "  --min-mem N       Smallest process memory size in bytes (default 2000)\n");
+    fprintf(stderr, "  --max-mem N       Largest process memory size in bytes (default 12000)\n");
+    fprintf(stderr, "  --zipf S          Zipf exponent of the hot set (default 1.0)\n");
+    fprintf(stderr, "  --loop-pages N    Pages cycled by the loop model (default 3)\n");
+    fprintf(stderr, "  --phase N         Accesses per phase of the phases model (default 100)\n");
+    fprintf(stderr, "  --burst N         Accesses a process makes in a row (default 1)\n");
+    fprintf(stderr, "  --segv RATE       Fraction of out of bounds accesses (default 0)\n");
+    fprintf(stderr, "  --format FMT      text (trace file) or c (arrays like inputs_part1.c)\n");
+    fprintf(stderr, "  --out FILE        Output file (default standard output)\n");
+}
+
+bool parse_model(const char *name, AccessModel *model) {
+    const char *names[] = {"uniform", "zipf", "sequential", "loop", "phases"};
+    const AccessModel models[] = {MODEL_UNIFORM, MODEL_ZIPF, MODEL_SEQUENTIAL, MODEL_LOOP, MODEL_PHASES};
+    for (int i = 0; i < 5; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *model = models[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char *argv[]) {
+    WorkloadSpec spec = default_workload_spec();
+    const char *format = "text";
+    const char *out_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+        const char *option = argv[i - 1];
+        bool ok = true;
+        if (strcmp(option, "--model") == 0) ok = parse_model(value, &spec.model);
+        else if (strcmp(option, "--procs") == 0) spec.num_procs = atoi(value);
+        else if (strcmp(option, "--length") == 0) spec.trace_len = atoi(value);
+        else if (strcmp(option, "--seed") == 0) spec.seed = strtoul(value, NULL, 10);
+        else if (strcmp(option, "--min-mem") == 0) spec.min_memory = atoi(value);
+        else if (strcmp(option, "--max-mem") == 0) spec.max_memory = atoi(value);
+        else if (strcmp(option, "--zipf") == 0) spec.zipf_exponent = atof(value);
+        else if (strcmp(option, "--loop-pages") == 0) spec.loop_pages = atoi(value);
+        else if (strcmp(option, "--phase") == 0) spec.phase_length = atoi(value);
+        else if (strcmp(option, "--burst") == 0) spec.burst_length = atoi(value);
+        else if (strcmp(option, "--segv") == 0) spec.segfault_rate = atof(value);
+        else if (strcmp(option, "--format") == 0) format = value;
+        else if (strcmp(option, "--out") == 0) out_path = value;
+        else ok = false;
+        if (!ok) {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    Workload workload;
+    if (!generate_workload(&spec, &workload)) {
+        fprintf(stderr, "Invalid workload parameters\n");
+        return 1;
+    }
+
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (out == NULL) {
+        perror("Error opening output file");
+        free_workload(&workload);
+        return 1;
+    }
+    bool written;
+    if (strcmp(format, "c") == 0) {
+        written = write_workload_c(out, &workload, "Gen");
+    } else {
+        written = write_workload_text(out, &workload);
+    }
+    if (out != stdout) fclose(out);
+    free_workload(&workload);
+    return written ? 0 : 1;
+}
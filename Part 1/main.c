@@ -1,8 +1,520 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include "p1_simulator.h"
 #include "inputs_part1.h"
+#include "workload.h"
+#include "pipeline.h"
+#include "mrc.h"
+
+void print_usage(const char *program_name) {
+    fprintf(stderr, "Usage: %s [options]\n", program_name);
+    fprintf(stderr, "  --stats               Append run statistics to every output file\n");
+    fprintf(stderr, "  --trace FILE          Simulate a generated trace file instead of the built-in inputs\n");
+    fprintf(stderr, "  --pipeline            With --trace, decode, simulate and print on three threads\n");
+    fprintf(stderr, "  --stream N            Read the trace record by record (from --trace or standard input)\n");
+    fprintf(stderr, "                        and print fault rate and resident frames every N accesses\n");
+    fprintf(stderr, "  --policy NAME         Replacement policy of the stream and the sweep, fifo or lru (default lru)\n");
+    fprintf(stderr, "  --levels N            Model an N-level page table walk\n");
+    fprintf(stderr, "  --pt-bits N           Index bits per page table level (default 4)\n");
+    fprintf(stderr, "  --huge-frames N       Frames per large page (power of two)\n");
+    fprintf(stderr, "  --large-procs LIST    Comma separated pids backed by large pages, or \"all\"\n");
+    fprintf(stderr, "  --prefetch K          Read ahead K pages on faults of strided processes\n");
+    fprintf(stderr, "  --local MODE          Local replacement with equal, proportional or priority quotas\n");
+    fprintf(stderr, "  --priorities LIST     Comma separated weights in pid order for priority quotas\n");
+    fprintf(stderr, "  --alloc NAME          Contiguous allocation instead of paging: first, best, next or buddy\n");
+    fprintf(stderr, "  --compact             With --alloc, compact memory when a process fits only the free total\n");
+    fprintf(stderr, "  --cache               Run every access through L1, L2 and LLC caches (512 B, 2 KB, 8 KB)\n");
+    fprintf(stderr, "  --cache-level SPEC    Replace the default levels, repeatable: size:line:ways[:lru|fifo|random]\n");
+    fprintf(stderr, "  --cache-pollute P     Percent of the cached lines lost whenever the trace switches process\n");
+    fprintf(stderr, "  --tiers LIST          Memory nodes from the fastest, as frames:latency_ns, like 3:80,2:140,2:300\n");
+    fprintf(stderr, "  --placement NAME      Node of a new page, first-touch (default) or interleave\n");
+    fprintf(stderr, "  --migrate N           Promote hot pages to faster nodes every N accesses\n");
+    fprintf(stderr, "  --hot-threshold T     Accesses a page needs between passes to be promoted (default 2)\n");
+    fprintf(stderr, "  --zswap N             Give the last N frames to a pool of compressed evicted pages\n");
+    fprintf(stderr, "  --zswap-ratio R       Compression ratio of the pool (default 3.0)\n");
+    fprintf(stderr, "  --zswap-latency NS    Time to decompress a page from the pool (default 4000)\n");
+    fprintf(stderr, "  --disk-latency NS     Time to read a page from the backing store (default 100000)\n");
+    fprintf(stderr, "  --zswap-sweep         With --trace, print faults and latency for every pool size\n");
+    fprintf(stderr, "  --kswapd LOW:HIGH[:B] Reclaim in the background below LOW free frames up to HIGH, B pages per step\n");
+    fprintf(stderr, "  --mrc RATE            Approximate fault rate curve of a trace (from --trace or standard input),\n");
+    fprintf(stderr, "                        following a RATE fraction of the pages, like 0.01\n");
+    fprintf(stderr, "  --mrc-exact           With --mrc, also follow every page and print the error of the curve\n");
+}
+
+// Marks the processes listed in text (like "1,5,20" or "all") as backed by large pages.
+bool parse_large_procs(const char *text) {
+    if (strcmp(text, "all") == 0) {
+        for (int i = 0; i < MAX_PROCESSES; i++) {
+            sim_options.large_page_procs[i] = true;
+        }
+        return true;
+    }
+    char list[256];
+    strncpy(list, text, sizeof(list) - 1);
+    list[sizeof(list) - 1] = '\0';
+    for (char *item = strtok(list, ","); item != NULL; item = strtok(NULL, ",")) {
+        int pid = atoi(item);
+        if (pid < 1 || pid > MAX_PROCESSES) {
+            return false;
+        }
+        sim_options.large_page_procs[pid - 1] = true;
+    }
+    return true;
+}
+
+// Reads the per-process weights used by priority quotas, like "4,1,1".
+bool parse_priorities(const char *text) {
+    char list[256];
+    strncpy(list, text, sizeof(list) - 1);
+    list[sizeof(list) - 1] = '\0';
+    int pid = 1;
+    for (char *item = strtok(list, ","); item != NULL; item = strtok(NULL, ",")) {
+        if (pid > MAX_PROCESSES || atoi(item) < 1) {
+            return false;
+        }
+        sim_options.priorities[pid - 1] = atoi(item);
+        pid++;
+    }
+    return true;
+}
+
+// Reads the memory nodes, like "3:80,2:140,2:300", fastest first. The last node also takes the frames
+// the list leaves over.
+bool parse_tiers(const char *text) {
+    char list[256];
+    strncpy(list, text, sizeof(list) - 1);
+    list[sizeof(list) - 1] = '\0';
+    int num_tiers = 0, frames = 0;
+    for (char *item = strtok(list, ","); item != NULL; item = strtok(NULL, ",")) {
+        MemoryTier tier;
+        if (num_tiers == MAX_TIERS || sscanf(item, "%d:%d", &tier.frames, &tier.latency) != 2 ||
+            tier.frames < 1 || tier.latency < 1 ||
+            (num_tiers > 0 && tier.latency < sim_options.tiers[num_tiers - 1].latency)) {
+            return false;
+        }
+        frames += tier.frames;
+        sim_options.tiers[num_tiers++] = tier;
+    }
+    sim_options.num_tiers = num_tiers;
+    return num_tiers > 0 && frames <= NUM_FRAMES;
+}
+
+// Reads the command line into sim_options. Any option also turns on the statistics block.
+bool parse_options(int argc, char *argv[], bool *print_stats, const char **trace_path, bool *pipelined,
+                   int *stream_window, ReplacementAlgo *stream_policy, bool *zswap_sweep, double *mrc_rate,
+                   bool *mrc_exact) {
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--stats") == 0) {
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--trace") == 0 && has_value) {
+            *trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--pipeline") == 0) {
+            *pipelined = true;
+        } else if (strcmp(argv[i], "--stream") == 0 && has_value) {
+            *stream_window = atoi(argv[++i]);
+            if (*stream_window < 1) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--policy") == 0 && has_value) {
+            const char *policy = argv[++i];
+            if (strcmp(policy, "fifo") == 0) {
+                *stream_policy = FIFO;
+            } else if (strcmp(policy, "lru") == 0) {
+                *stream_policy = LRU;
+            } else {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--levels") == 0 && has_value) {
+            sim_options.page_table_levels = atoi(argv[++i]);
+            if (sim_options.page_table_levels < 0) {
+                return false;
+            }
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--pt-bits") == 0 && has_value) {
+            sim_options.page_table_bits = atoi(argv[++i]);
+            if (sim_options.page_table_bits < 1 || sim_options.page_table_bits > 16) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--huge-frames") == 0 && has_value) {
+            int frames = atoi(argv[++i]);
+            // Large pages are placed in aligned groups, so the size must be a power of two
+            if (frames < 1 || frames > NUM_FRAMES || (frames & (frames - 1)) != 0) {
+                return false;
+            }
+            sim_options.huge_page_frames = frames;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--large-procs") == 0 && has_value) {
+            if (!parse_large_procs(argv[++i])) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--prefetch") == 0 && has_value) {
+            sim_options.prefetch_depth = atoi(argv[++i]);
+            if (sim_options.prefetch_depth < 0) {
+                return false;
+            }
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--local") == 0 && has_value) {
+            const char *mode = argv[++i];
+            sim_options.replacement_scope = LOCAL_REPLACEMENT;
+            if (strcmp(mode, "equal") == 0) {
+                sim_options.frame_allocation = ALLOC_EQUAL;
+            } else if (strcmp(mode, "proportional") == 0) {
+                sim_options.frame_allocation = ALLOC_PROPORTIONAL;
+            } else if (strcmp(mode, "priority") == 0) {
+                sim_options.frame_allocation = ALLOC_PRIORITY;
+            } else {
+                return false;
+            }
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--priorities") == 0 && has_value) {
+            if (!parse_priorities(argv[++i])) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--alloc") == 0 && has_value) {
+            if (!parse_alloc_strategy(argv[++i], &sim_options.alloc_strategy)) {
+                return false;
+            }
+            sim_options.contiguous = true;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--compact") == 0) {
+            sim_options.compaction = true;
+        } else if (strcmp(argv[i], "--cache") == 0) {
+            sim_options.cache = true;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--cache-level") == 0 && has_value) {
+            if (sim_options.num_cache_levels == CACHE_LEVELS ||
+                !parse_cache_level(argv[++i], &sim_options.cache_levels[sim_options.num_cache_levels])) {
+                return false;
+            }
+            sim_options.num_cache_levels++;
+            sim_options.cache = true;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--tiers") == 0 && has_value) {
+            if (!parse_tiers(argv[++i])) {
+                return false;
+            }
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--placement") == 0 && has_value) {
+            const char *placement = argv[++i];
+            if (strcmp(placement, "first-touch") == 0) {
+                sim_options.placement = PLACE_FIRST_TOUCH;
+            } else if (strcmp(placement, "interleave") == 0) {
+                sim_options.placement = PLACE_INTERLEAVE;
+            } else {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--migrate") == 0 && has_value) {
+            sim_options.migrate_interval = atoi(argv[++i]);
+            if (sim_options.migrate_interval < 0) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--hot-threshold") == 0 && has_value) {
+            sim_options.hot_threshold = atoi(argv[++i]);
+            if (sim_options.hot_threshold < 1) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--zswap") == 0 && has_value) {
+            sim_options.zswap_frames = atoi(argv[++i]);
+            if (sim_options.zswap_frames < 1 || sim_options.zswap_frames >= NUM_FRAMES) {
+                return false;
+            }
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--zswap-ratio") == 0 && has_value) {
+            sim_options.zswap_ratio = atof(argv[++i]);
+            if (sim_options.zswap_ratio < 1.0) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--zswap-latency") == 0 && has_value) {
+            sim_options.zswap_latency = atoi(argv[++i]);
+            if (sim_options.zswap_latency < 0) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--disk-latency") == 0 && has_value) {
+            sim_options.disk_latency = atoi(argv[++i]);
+            if (sim_options.disk_latency < 0) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--zswap-sweep") == 0) {
+            *zswap_sweep = true;
+        } else if (strcmp(argv[i], "--mrc") == 0 && has_value) {
+            *mrc_rate = atof(argv[++i]);
+            if (*mrc_rate <= 0.0 || *mrc_rate > 1.0) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--mrc-exact") == 0) {
+            *mrc_exact = true;
+        } else if (strcmp(argv[i], "--kswapd") == 0 && has_value) {
+            sim_options.kswapd_batch = 1;
+            if (sscanf(argv[++i], "%d:%d:%d", &sim_options.low_watermark, &sim_options.high_watermark,
+                       &sim_options.kswapd_batch) < 2 || sim_options.low_watermark < 1 ||
+                sim_options.high_watermark < sim_options.low_watermark || sim_options.kswapd_batch < 1) {
+                return false;
+            }
+            sim_options.kswapd = true;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--cache-pollute") == 0 && has_value) {
+            sim_options.cache_pollution = atoi(argv[++i]);
+            if (sim_options.cache_pollution < 0 || sim_options.cache_pollution > 100) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    // Partitions replace frames, so the paging features and the frame based loops do not apply to them
+    // Page numbers are split into levels * bits index bits, which must fit in an int
+    if (sim_options.page_table_levels >= 31 || sim_options.page_table_levels * sim_options.page_table_bits >= 31) {
+        return false;
+    }
+    if (sim_options.contiguous && (sim_options.page_table_levels > 0 || sim_options.huge_page_frames > 1 ||
+                                   sim_options.prefetch_depth > 0 || sim_options.replacement_scope != GLOBAL_REPLACEMENT ||
+                                   sim_options.num_tiers > 0 || *pipelined || *stream_window > 0)) {
+        return false;
+    }
+    // The pool frames are outside the large page groups and the quotas, which cover all the frames
+    if ((sim_options.zswap_frames > 0 || *zswap_sweep) &&
+        (sim_options.huge_page_frames > 1 || sim_options.replacement_scope != GLOBAL_REPLACEMENT || sim_options.contiguous)) {
+        return false;
+    }
+    if (*zswap_sweep && (*trace_path == NULL || *pipelined || *stream_window > 0)) {
+        return false;
+    }
+    if ((*mrc_rate > 0.0 || *mrc_exact) && (*mrc_rate == 0.0 || *pipelined || *stream_window > 0 || *zswap_sweep)) {
+        return false;
+    }
+    // The daemon can only free the frames that hold pages, never the pool frames
+    if (sim_options.kswapd && (sim_options.contiguous || *zswap_sweep ||
+                               sim_options.high_watermark > NUM_FRAMES - sim_options.zswap_frames)) {
+        return false;
+    }
+    return true;
+}
+
+// Runs a trace with every pool size, from no pool to all frames but one (in 16 steps when NUM_FRAMES is
+// raised), and prints one line per size.
+// Without a pool every fault reads the backing store; a bigger pool turns more of them into
+// decompressions but leaves fewer frames to the pages, so it also faults more.
+int run_zswap_sweep(const char *path, ReplacementAlgo algo) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        perror("Error opening trace file");
+        return 1;
+    }
+    Workload workload;
+    bool loaded = load_workload_text(file, &workload);
+    fclose(file);
+    if (!loaded) {
+        fprintf(stderr, "Invalid trace file: %s\n", path);
+        return 1;
+    }
+
+    printf("%-6s %-10s %-10s %-10s %-10s %-12s %s\n", "pool", "capacity", "faults", "pool hits", "disk reads",
+           "fault us", "ns/access");
+    sim_options.quiet = true;
+    int step = NUM_FRAMES > 16 ? NUM_FRAMES / 16 : 1;
+    for (int frames = 0; frames < NUM_FRAMES; frames += step) {
+        sim_options.zswap_frames = frames;
+        run_simulation_logic(algo, workload.num_procs, workload.mem_sizes, workload.exec_trace, workload.trace_len);
+        int capacity = NUM_FRAMES;
+        long long hits = 0, misses = sim_stats.page_faults;
+        double fault_latency = sim_options.disk_latency;
+        if (frames > 0) {
+            capacity = NUM_FRAMES - frames + sim_zswap.capacity;
+            hits = sim_zswap.hits;
+            misses = sim_zswap.misses;
+            fault_latency = zswap_fault_latency(&sim_zswap);
+        }
+        double per_access = sim_stats.accesses > 0 ? fault_latency * sim_stats.page_faults / sim_stats.accesses : 0.0;
+        printf("%-6d %-10d %-10lld %-10lld %-10lld %-12.1f %.0f\n", frames, capacity, sim_stats.page_faults, hits, misses,
+               fault_latency / 1000.0, per_access);
+    }
+    free_workload(&workload);
+    return 0;
+}
+
+// Reads a trace record by record into a sampled fault rate curve, and into an exact one when asked.
+// Only the sampled pages are kept, so memory use does not grow with the trace.
+int run_mrc(FILE *input, ReplacementAlgo algo, double rate, bool exact) {
+    int num_procs, declared_len;
+    int mem_sizes[MAX_PROCESSES];
+    if (!read_trace_header(input, &num_procs, &declared_len, mem_sizes)) {
+        fprintf(stderr, "Invalid trace header\n");
+        return 1;
+    }
+    int frames[MRC_MAX_POINTS];
+    int num_points = mrc_default_frames(num_procs, mem_sizes, frames);
+    MissRatioCurve sampled, full;
+    bool ready = mrc_init(&sampled, algo, rate, num_procs, mem_sizes, frames, num_points) &&
+                 (!exact || mrc_init(&full, algo, 1.0, num_procs, mem_sizes, frames, num_points));
+    if (!ready) {
+        fprintf(stderr, "Could not allocate the curve\n");
+        mrc_destroy(&sampled);
+        return 1;
+    }
+
+    int pid, address;
+    while (read_trace_record(input, &pid, &address)) {
+        mrc_access(&sampled, pid, address);
+        if (exact) mrc_access(&full, pid, address);
+    }
+    if (!feof(input)) {
+        fprintf(stderr, "Invalid trace record, the curve stops there\n");
+    }
+    mrc_print(&sampled, exact ? &full : NULL, stdout);
+    mrc_destroy(&sampled);
+    if (exact) mrc_destroy(&full);
+    return 0;
+}
+
+// Runs both algorithms on a trace file, writing fifo_trace.out and lru_trace.out.
+int run_trace_file(const char *path, bool print_stats) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        perror("Error opening trace file");
+        return 1;
+    }
+    Workload workload;
+    bool loaded = load_workload_text(file, &workload);
+    fclose(file);
+    if (!loaded) {
+        fprintf(stderr, "Invalid trace file: %s\n", path);
+        return 1;
+    }
+
+    const char *filenames[] = {"fifo_trace.out", "lru_trace.out"};
+    const ReplacementAlgo algos[] = {FIFO, LRU};
+    for (int i = 0; i < 2; i++) {
+        freopen(filenames[i], "w", stdout);
+        print_header(workload.num_procs);
+        run_simulation_logic(algos[i], workload.num_procs, workload.mem_sizes, workload.exec_trace, workload.trace_len);
+        if (print_stats) print_statistics(workload.num_procs);
+        fclose(stdout);
+    }
+    free_workload(&workload);
+    return 0;
+}
+
+// Same as run_trace_file(), but each run decodes, simulates and prints on its own thread.
+// The trace is read again for every policy instead of being loaded into memory.
+int run_trace_file_pipelined(const char *path, bool print_stats) {
+    const char *filenames[] = {"fifo_trace.out", "lru_trace.out"};
+    const ReplacementAlgo algos[] = {FIFO, LRU};
+    for (int i = 0; i < 2; i++) {
+        FILE *file = fopen(path, "r");
+        if (file == NULL) {
+            perror("Error opening trace file");
+            return 1;
+        }
+        int num_procs, trace_len;
+        int mem_sizes[MAX_PROCESSES];
+        if (!read_trace_header(file, &num_procs, &trace_len, mem_sizes)) {
+            fprintf(stderr, "Invalid trace file: %s\n", path);
+            fclose(file);
+            return 1;
+        }
+        freopen(filenames[i], "w", stdout);
+        print_header(num_procs);
+        bool completed = run_pipelined_trace(file, algos[i], num_procs, mem_sizes, trace_len);
+        if (completed && print_stats) print_statistics(num_procs);
+        fclose(stdout);
+        fclose(file);
+        if (!completed) {
+            fprintf(stderr, "Could not start the pipeline\n");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Frame times are renumbered when they reach it
+#define STREAM_TIME_LIMIT INT_MAX
+
+// Prints the line of one window of the stream: counts since the previous line, state at its end.
+void print_stream_window(long long records, const SimulationStats *window_start, int num_procs) {
+    long long accesses = sim_stats.accesses - window_start->accesses;
+    long long faults = sim_stats.page_faults - window_start->page_faults;
+    double fault_rate = accesses > 0 ? (double)faults / accesses : 0.0;
+    printf("%-12lld %-10lld %-10lld %-10.3f %-10d %lld\n", records, accesses, faults, fault_rate, resident_frames(),
+           num_procs - sim_stats.segfaults);
+    fflush(stdout); // A reader at the other end of a pipe sees every window as soon as it closes
+}
+
+// Simulates a trace as its records arrive, printing one line per window of records.
+// Only the simulator state is kept, so memory use does not grow with the stream. The trace_len of
+// the header is ignored and the stream ends with the input. Record n is stamped with time n,
+// as the first record is in the table runs, less the epoch the frame times were last renumbered at,
+// so the times fit in an int however long the stream runs.
+int run_stream(FILE *input, ReplacementAlgo algo, int window, bool print_stats) {
+    int num_procs, declared_len;
+    int mem_sizes[MAX_PROCESSES];
+    if (!read_trace_header(input, &num_procs, &declared_len, mem_sizes)) {
+        fprintf(stderr, "Invalid stream header\n");
+        return 1;
+    }
+    initialize_simulation(num_procs, mem_sizes);
+    printf("%-12s %-10s %-10s %-10s %-10s %s\n", "records", "accesses", "faults", "fault rate", "resident", "live procs");
+
+    SimulationStats window_start = sim_stats;
+    long long records = 0;
+    long long epoch = 0;
+    int pid, address;
+    while (read_trace_record(input, &pid, &address)) {
+        if (records - epoch == STREAM_TIME_LIMIT) {
+            epoch = records - compact_frame_times();
+        }
+        simulate_access(algo, num_procs, pid, address, (int)(records - epoch));
+        records++;
+        if (records % window == 0) {
+            print_stream_window(records, &window_start, num_procs);
+            window_start = sim_stats;
+        }
+    }
+    if (records % window != 0) {
+        print_stream_window(records, &window_start, num_procs); // The last, shorter window
+    }
+    if (!feof(input)) {
+        fprintf(stderr, "Invalid record after %lld records, the stream stops there\n", records);
+    }
+    if (print_stats) print_statistics(num_procs);
+    free_page_tables(num_procs);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    bool print_stats = false;
+    const char *trace_path = NULL;
+    bool pipelined = false;
+    int stream_window = 0;
+    ReplacementAlgo stream_policy = LRU;
+    bool zswap_sweep = false;
+    double mrc_rate = 0.0;
+    bool mrc_exact = false;
+    if (!parse_options(argc, argv, &print_stats, &trace_path, &pipelined, &stream_window, &stream_policy, &zswap_sweep,
+                       &mrc_rate, &mrc_exact)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (zswap_sweep) {
+        return run_zswap_sweep(trace_path, stream_policy);
+    }
+    if (stream_window > 0 || mrc_rate > 0.0) {
+        FILE *input = trace_path != NULL ? fopen(trace_path, "r") : stdin;
+        if (input == NULL) {
+            perror("Error opening trace file");
+            return 1;
+        }
+        int status = mrc_rate > 0.0 ? run_mrc(input, stream_policy, mrc_rate, mrc_exact)
+                                    : run_stream(input, stream_policy, stream_window, print_stats);
+        if (input != stdin) fclose(input);
+        return status;
+    }
+    if (trace_path != NULL) {
+        return pipelined ? run_trace_file_pipelined(trace_path, print_stats) : run_trace_file(trace_path, print_stats);
+    }
 
-int main() {
     struct TestCase {
         int num_procs;
         int* mem_sizes;
@@ -28,12 +540,14 @@ int main() {
         freopen(filename, "w", stdout);
         print_header(current_test.num_procs);
         run_simulation_logic(FIFO, current_test.num_procs, current_test.mem_sizes, current_test.exec_trace, current_test.trace_len);
+        if (print_stats) print_statistics(current_test.num_procs);
         fclose(stdout);
 
         sprintf(filename, "lru%02d.out", i);
         freopen(filename, "w", stdout);
         print_header(current_test.num_procs);
         run_simulation_logic(LRU, current_test.num_procs, current_test.mem_sizes, current_test.exec_trace, current_test.trace_len);
+        if (print_stats) print_statistics(current_test.num_procs);
         fclose(stdout);
     }
     
@@ -0,0 +1,237 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mrc.h"
+
+// --- Sampling ---
+
+// Finalizer of splitmix64, spreads neighbouring pages of a process over the whole hash range
+static unsigned long long hash_key(int pid, int page) {
+    unsigned long long x = ((unsigned long long)(unsigned int)pid << 32) | (unsigned int)page;
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static bool sampled_hash(const MissRatioCurve *curve, unsigned long long hash) {
+    return (unsigned int)(hash & ((1u << MRC_HASH_BITS) - 1)) < curve->threshold;
+}
+
+// --- Miniature Memories ---
+
+static bool mini_init(MiniMemory *memory, int frames, double rate) {
+    memset(memory, 0, sizeof(MiniMemory));
+    memory->frames = frames;
+    memory->slots = (int)(frames * rate + 0.5);
+    if (memory->slots < 1) memory->slots = 1;
+    int buckets = 1;
+    while (buckets < 2 * memory->slots) buckets *= 2;
+    memory->bucket_mask = buckets - 1;
+    memory->head = memory->tail = memory->free_slot = -1;
+    memory->pids = (int *)malloc(memory->slots * sizeof(int));
+    memory->pages = (int *)malloc(memory->slots * sizeof(int));
+    memory->prev = (int *)malloc(memory->slots * sizeof(int));
+    memory->next = (int *)malloc(memory->slots * sizeof(int));
+    memory->chain = (int *)malloc(memory->slots * sizeof(int));
+    memory->buckets = (int *)malloc(buckets * sizeof(int));
+    if (!memory->pids || !memory->pages || !memory->prev || !memory->next || !memory->chain || !memory->buckets) {
+        return false;
+    }
+    for (int b = 0; b < buckets; b++) {
+        memory->buckets[b] = -1;
+    }
+    return true;
+}
+
+static void mini_destroy(MiniMemory *memory) {
+    free(memory->pids);
+    free(memory->pages);
+    free(memory->prev);
+    free(memory->next);
+    free(memory->chain);
+    free(memory->buckets);
+    memset(memory, 0, sizeof(MiniMemory));
+}
+
+static int *bucket_of(MiniMemory *memory, unsigned long long hash) {
+    // The low bits decided the sampling, the high ones pick the bucket
+    return &memory->buckets[(hash >> 32) & memory->bucket_mask];
+}
+
+static int find_slot(MiniMemory *memory, int pid, int page, unsigned long long hash) {
+    for (int s = *bucket_of(memory, hash); s != -1; s = memory->chain[s]) {
+        if (memory->pids[s] == pid && memory->pages[s] == page) return s;
+    }
+    return -1;
+}
+
+static void unlink_slot(MiniMemory *memory, int s) {
+    if (memory->prev[s] != -1) memory->next[memory->prev[s]] = memory->next[s];
+    else memory->head = memory->next[s];
+    if (memory->next[s] != -1) memory->prev[memory->next[s]] = memory->prev[s];
+    else memory->tail = memory->prev[s];
+}
+
+static void push_front(MiniMemory *memory, int s) {
+    memory->prev[s] = -1;
+    memory->next[s] = memory->head;
+    if (memory->head != -1) memory->prev[memory->head] = s;
+    memory->head = s;
+    if (memory->tail == -1) memory->tail = s;
+}
+
+// Takes a slot out of the list and of its hash bucket
+static void remove_slot(MiniMemory *memory, int s) {
+    unlink_slot(memory, s);
+    int *link = bucket_of(memory, hash_key(memory->pids[s], memory->pages[s]));
+    while (*link != s) link = &memory->chain[*link];
+    *link = memory->chain[s];
+    memory->count--;
+}
+
+static void mini_access(MiniMemory *memory, ReplacementAlgo algo, int pid, int page, unsigned long long hash) {
+    int s = find_slot(memory, pid, page, hash);
+    if (s != -1) {
+        if (algo == LRU) {
+            unlink_slot(memory, s);
+            push_front(memory, s);
+        }
+        return;
+    }
+    memory->misses++;
+    if (memory->count == memory->slots) {
+        s = memory->tail; // Least recently used, or loaded first
+        remove_slot(memory, s);
+    } else if (memory->free_slot != -1) {
+        s = memory->free_slot;
+        memory->free_slot = memory->next[s];
+    } else {
+        s = memory->count;
+    }
+    memory->pids[s] = pid;
+    memory->pages[s] = page;
+    int *bucket = bucket_of(memory, hash);
+    memory->chain[s] = *bucket;
+    *bucket = s;
+    push_front(memory, s);
+    memory->count++;
+}
+
+// Frees the pages of an ended process. Slots past count can be in use then, so freed ones are chained.
+static void mini_drop_process(MiniMemory *memory, int pid) {
+    int s = memory->head;
+    while (s != -1) {
+        int following = memory->next[s];
+        if (memory->pids[s] == pid) {
+            remove_slot(memory, s);
+            memory->next[s] = memory->free_slot;
+            memory->free_slot = s;
+        }
+        s = following;
+    }
+}
+
+// --- Curve ---
+
+int mrc_default_frames(int num_procs, const int mem_sizes[], int frames[]) {
+    int total_pages = 0;
+    for (int i = 0; i < num_procs; i++) {
+        total_pages += mem_sizes[i] > 0 ? (mem_sizes[i] - 1) / PAGE_SIZE + 1 : 0;
+    }
+    if (total_pages < 1) total_pages = 1;
+    int num_points = total_pages < MRC_MAX_POINTS ? total_pages : MRC_MAX_POINTS;
+    for (int p = 0; p < num_points; p++) {
+        frames[p] = (int)((long)total_pages * (p + 1) / num_points);
+    }
+    return num_points;
+}
+
+bool mrc_init(MissRatioCurve *curve, ReplacementAlgo algo, double rate, int num_procs, const int mem_sizes[],
+              const int frames[], int num_points) {
+    memset(curve, 0, sizeof(MissRatioCurve));
+    if (rate <= 0.0 || rate > 1.0 || num_procs < 1 || num_procs > MAX_PROCESSES || num_points < 1 ||
+        num_points > MRC_MAX_POINTS) {
+        return false;
+    }
+    curve->algo = algo;
+    curve->rate = rate;
+    curve->threshold = rate >= 1.0 ? 1u << MRC_HASH_BITS : (unsigned int)(rate * (1u << MRC_HASH_BITS));
+    curve->num_procs = num_procs;
+    memcpy(curve->mem_sizes, mem_sizes, num_procs * sizeof(int));
+    curve->num_points = num_points;
+    bool ok = true;
+    for (int p = 0; p < num_points; p++) {
+        ok = ok && frames[p] >= 1 && mini_init(&curve->points[p], frames[p], rate);
+    }
+    if (!ok) mrc_destroy(curve);
+    return ok;
+}
+
+void mrc_destroy(MissRatioCurve *curve) {
+    for (int p = 0; p < MRC_MAX_POINTS; p++) {
+        mini_destroy(&curve->points[p]);
+    }
+    curve->num_points = 0;
+}
+
+void mrc_access(MissRatioCurve *curve, int pid, int address) {
+    if (pid < 1 || pid > curve->num_procs || curve->terminated[pid - 1]) {
+        return;
+    }
+    curve->accesses++;
+    if (address >= curve->mem_sizes[pid - 1]) {
+        curve->terminated[pid - 1] = true;
+        for (int p = 0; p < curve->num_points; p++) {
+            mini_drop_process(&curve->points[p], pid);
+        }
+        return;
+    }
+    curve->references++;
+    int page = address / PAGE_SIZE;
+    unsigned long long hash = hash_key(pid, page);
+    if (!sampled_hash(curve, hash)) {
+        return;
+    }
+    curve->sampled++;
+    for (int p = 0; p < curve->num_points; p++) {
+        mini_access(&curve->points[p], curve->algo, pid, page, hash);
+    }
+}
+
+double mrc_faults(const MissRatioCurve *curve, int point) {
+    if (curve->sampled == 0) return 0.0;
+    return (double)curve->points[point].misses / curve->sampled * curve->references;
+}
+
+double mrc_fault_rate(const MissRatioCurve *curve, int point) {
+    return curve->accesses > 0 ? mrc_faults(curve, point) / curve->accesses : 0.0;
+}
+
+void mrc_print(const MissRatioCurve *curve, const MissRatioCurve *exact, FILE *out) {
+    fprintf(out, "%-8s %-8s %-12s", "frames", "modeled", "faults");
+    if (exact != NULL) fprintf(out, " %-10s %-10s %s\n", "fault rate", "exact", "error");
+    else fprintf(out, " %s\n", "fault rate");
+    double total_error = 0.0, max_error = 0.0;
+    for (int p = 0; p < curve->num_points; p++) {
+        const MiniMemory *point = &curve->points[p];
+        fprintf(out, "%-8d %-8d %-12.0f", point->frames, point->slots, mrc_faults(curve, p));
+        if (exact != NULL) {
+            double error = mrc_fault_rate(curve, p) - mrc_fault_rate(exact, p);
+            fprintf(out, " %-10.4f %-10.4f %+.4f\n", mrc_fault_rate(curve, p), mrc_fault_rate(exact, p), error);
+            total_error += fabs(error);
+            if (fabs(error) > max_error) max_error = fabs(error);
+        } else {
+            fprintf(out, " %.4f\n", mrc_fault_rate(curve, p));
+        }
+    }
+    fprintf(out, "%-26s %g\n", "sampling rate", curve->rate);
+    fprintf(out, "%-26s %ld\n", "accesses", curve->accesses);
+    fprintf(out, "%-26s %ld\n", "sampled references", curve->sampled);
+    if (exact != NULL) {
+        fprintf(out, "%-26s %.4f\n", "mean absolute error", total_error / curve->num_points);
+        fprintf(out, "%-26s %.4f\n", "max absolute error", max_error);
+    }
+}
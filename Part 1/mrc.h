@@ -0,0 +1,65 @@
+#ifndef MRC_H
+#define MRC_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "p1_simulator.h"
+
+// Approximate miss ratio curves of huge traces with spatial sampling, as in SHARDS. A (pid, page) key
+// is sampled when its hash falls below rate * 2^24, so a page is either followed on every access or
+// never. The sampled references go through miniature memories of rate * frames pages, one per point
+// of the curve, whose fault rate approximates that of the full memory (miniature simulation). That
+// works for FIFO as well as LRU, and memory use only grows with the sampled pages.
+// Records follow the stream semantics of simulate_access(): invalid pids and ended processes are
+// skipped, and an access past the end of a process ends it and frees its pages.
+
+#define MRC_MAX_POINTS 32
+#define MRC_HASH_BITS 24
+
+// One point of the curve: a memory of `frames` frames, modeled with `slots` pages
+typedef struct {
+    int frames;
+    int slots;
+    int count;
+    int head, tail;   // Most recently used (LRU) or newest (FIFO) page first, -1 when empty
+    int free_slot;    // Slots freed by ended processes, chained through next
+    int *pids;
+    int *pages;
+    int *prev;
+    int *next;
+    int *chain;       // Next slot in the same hash bucket
+    int *buckets;     // First slot of every bucket, -1 when empty
+    int bucket_mask;
+    long misses;
+} MiniMemory;
+
+typedef struct {
+    ReplacementAlgo algo;
+    double rate;
+    unsigned int threshold;   // Sampled when the hash of the key is below it
+    int num_procs;
+    int mem_sizes[MAX_PROCESSES];
+    bool terminated[MAX_PROCESSES];
+    long accesses;            // Accesses the engine counts, segmentation faults included
+    long references;          // Accesses to a page
+    long sampled;             // Page references whose key was sampled
+    int num_points;
+    MiniMemory points[MRC_MAX_POINTS];
+} MissRatioCurve;
+
+// Up to MRC_MAX_POINTS frame counts spread evenly up to every page of every process, which is where
+// the curve reaches its cold misses. Returns the number of points.
+int mrc_default_frames(int num_procs, const int mem_sizes[], int frames[]);
+bool mrc_init(MissRatioCurve *curve, ReplacementAlgo algo, double rate, int num_procs, const int mem_sizes[],
+              const int frames[], int num_points);
+void mrc_destroy(MissRatioCurve *curve);
+
+void mrc_access(MissRatioCurve *curve, int pid, int address);
+// Faults of the full memory of one point, scaled from the sampled ones
+double mrc_faults(const MissRatioCurve *curve, int point);
+double mrc_fault_rate(const MissRatioCurve *curve, int point);
+
+// Prints the curve. With an exact curve of the same points, adds its fault rate and the error.
+void mrc_print(const MissRatioCurve *curve, const MissRatioCurve *exact, FILE *out);
+
+#endif // MRC_H
@@ -0,0 +1,70 @@
+// Template for one specialized simulation loop, included by p1_simulator.c once per kernel.
+// Before including it, define:
+//   KERNEL_NAME   name of the generated function
+//   KERNEL_LRU    1 for LRU replacement, 0 for FIFO
+//   KERNEL_TABLE  1 to print the state table, 0 for a quiet run
+// The kernel covers the default configuration only (global replacement, base pages, no page table walk
+// and no prefetching), so the loop is the plain algorithm with nothing left to decide per access.
+
+static void KERNEL_NAME(int num_procs, const int exec_trace[], int trace_len) {
+    int execution_pointer = load_first_access(num_procs, exec_trace, trace_len);
+
+    for (int time_step = 0; time_step < trace_len; time_step++) {
+#if KERNEL_TABLE
+        PROFILE_CALL(PROFILE_PRINT_STATE, print_state(time_step, num_procs));
+#endif
+
+        // Stop if we have reached the end of the instruction list
+        if (exec_trace[execution_pointer] == 0 || execution_pointer >= trace_len * 2) {
+            break;
+        }
+        int current_pid = exec_trace[execution_pointer];
+        int current_address = exec_trace[execution_pointer + 1];
+        int time_of_the_event = time_step + 1;
+        execution_pointer = execution_pointer + 2;
+
+        if (current_pid < 1 || current_pid > num_procs || processes[current_pid - 1].terminated == true) {
+            continue;
+        }
+        sim_stats.accesses++;
+
+        if (current_address >= processes[current_pid - 1].memory_size) {
+            processes[current_pid - 1].terminated = true;
+            sim_stats.segfaults++;
+            for (int i = 0; i < NUM_FRAMES; i++) {
+                if (physical_memory.process_id[i] == current_pid) {
+                    physical_memory.process_id[i] = -1;
+                }
+            }
+            continue;
+        }
+
+        int needed_page = current_address / PAGE_SIZE;
+        int frame_index;
+        PROFILE_CALL(PROFILE_LOOKUP, frame_index = find_page_in_memory(current_pid, needed_page));
+        if (frame_index != -1) {
+#if KERNEL_LRU
+            physical_memory.last_access_time[frame_index] = time_of_the_event;
+#endif
+            continue; // FIFO ignores hits
+        }
+
+        sim_stats.page_faults++;
+        sim_stats.process_faults[current_pid - 1]++;
+        PROFILE_CALL(PROFILE_FREE_FRAME, frame_index = find_free_frame());
+        if (frame_index == -1) {
+#if KERNEL_LRU
+            PROFILE_CALL(PROFILE_VICTIM, frame_index = scan_min_index(physical_memory.last_access_time,
+                                                                      physical_memory.process_id, NULL, NUM_FRAMES));
+#else
+            PROFILE_CALL(PROFILE_VICTIM, frame_index = scan_min_index(physical_memory.load_time,
+                                                                      physical_memory.process_id, NULL, NUM_FRAMES));
+#endif
+        }
+        load_page_into_frame(frame_index, current_pid, needed_page, time_of_the_event);
+    }
+}
+
+#undef KERNEL_NAME
+#undef KERNEL_LRU
+#undef KERNEL_TABLE
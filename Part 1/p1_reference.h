@@ -0,0 +1,11 @@
+#ifndef P1_REFERENCE_H
+#define P1_REFERENCE_H
+
+#include "p1_simulator.h"
+
+// The original engine, kept unchanged as the oracle for optimized engines.
+// It always uses 7 frames and ignores sim_options.
+void reference_print_header(int num_procs);
+void run_reference_simulation(ReplacementAlgo algo, int num_procs, const int mem_sizes[], const int exec_trace[], int trace_len);
+
+#endif
@@ -5,100 +5,426 @@
 #include <limits.h>
 #include "inputs_part1.h"
 #include "p1_simulator.h"
-
-// --- Configuration ---
-#define PAGE_SIZE (3 * 1000)
-#define NUM_FRAMES 7
-#define MAX_PROCESSES 20
+#include "frame_scan.h"
+#include "profile.h"
 
 // --- Global State ---
-Frame physical_memory[NUM_FRAMES]; // Represents the physical memory frames
+FrameTable physical_memory; // Represents the physical memory frames
 ProcessInfo processes[MAX_PROCESSES]; // Holds information about each process
 
+SimulatorOptions sim_options = { .page_table_levels = 0, .page_table_bits = 4, .huge_page_frames = 0, .hot_threshold = 2,
+                                 .zswap_ratio = 3.0, .zswap_latency = 4000, .disk_latency = 100000,
+                                 .low_watermark = 1, .high_watermark = 2, .kswapd_batch = 1 };
+SimulationStats sim_stats;
+Allocator sim_partitions;
+CacheHierarchy sim_cache;
+ZswapPool sim_zswap;
+bool kswapd_awake; // The reclaim daemon is between its low and high watermark
+int quota_procs;   // Processes compute_frame_quotas() shared the frames between
+
 // --- Helper Functions ---
 
 // Searches physical memory to see if a specific page for a specific process is already loaded.
 int find_page_in_memory(int pid, int page_num) {
-    for (int i = 0; i < NUM_FRAMES; i++) {
-        // Get the frame we are currently looking at
-        Frame current_frame = physical_memory[i];
-        
-        // Check if this frame belongs to the process we want
-        if (current_frame.process_id == pid) {
-            // If it does, check if it has the page we want
-            if (current_frame.page_number == page_num) {
-                return i; // Return the index of the frame
+    // Returns the index of the frame, or -1 if the page is not loaded
+    return scan_find_pair(physical_memory.process_id, pid, physical_memory.page_number, page_num, NUM_FRAMES);
+}
+
+// Finds the first available frame in physical memory.
+int find_free_frame() {
+    // A free frame is one with a process ID of -1
+    return scan_find_value(physical_memory.process_id, -1, NUM_FRAMES);
+}
+
+// Finds the first aligned group of free frames large enough to hold a large page.
+int find_free_block(int frames_needed) {
+    for (int start = 0; start + frames_needed <= NUM_FRAMES; start += frames_needed) {
+        int free_count = 0;
+        while (free_count < frames_needed && physical_memory.process_id[start + free_count] == -1) {
+            free_count++;
+        }
+        if (free_count == frames_needed) {
+            return start;
+        }
+    }
+    return -1; // No aligned group is completely free
+}
+
+// Implements the FIFO page replacement algorithm to find the page that has been in memory the longest.
+// Only frames marked in candidates are considered, and free frames are never chosen.
+// On equal load times the frame with the smaller ID is chosen.
+int find_victim_fifo(const bool candidates[]) {
+    return scan_min_index(physical_memory.load_time, physical_memory.process_id, candidates, NUM_FRAMES);
+}
+
+// Implements the LRU page replacement algorithm to find the page that has not been accessed for the longest time.
+// Only frames marked in candidates are considered, and free frames are never chosen.
+// Tie-breaking rule: on equal access times the frame with the smaller ID is chosen.
+int find_victim_lru(const bool candidates[]) {
+    return scan_min_index(physical_memory.last_access_time, physical_memory.process_id, candidates, NUM_FRAMES);
+}
+
+int find_victim(ReplacementAlgo algo, const bool candidates[]) {
+    if (algo == FIFO) {
+        return find_victim_fifo(candidates);
+    }
+    return find_victim_lru(candidates);
+}
+
+// Counts the frames currently held by a process.
+int count_frames_of(int pid) {
+    return scan_count_value(physical_memory.process_id, pid, NUM_FRAMES);
+}
+
+// --- Local Replacement ---
+
+// Splits the frames between the processes in proportion to their weights (largest remainder method).
+// Every process gets at least one frame, so with more processes than frames the quotas overlap.
+void compute_frame_quotas(int num_procs) {
+    quota_procs = num_procs;
+    long weights[MAX_PROCESSES];
+    long total_weight = 0;
+    for (int i = 0; i < num_procs; i++) {
+        if (sim_options.frame_allocation == ALLOC_PROPORTIONAL) {
+            weights[i] = processes[i].memory_size > 0 ? processes[i].memory_size : 1;
+        } else if (sim_options.frame_allocation == ALLOC_PRIORITY) {
+            weights[i] = sim_options.priorities[i] > 0 ? sim_options.priorities[i] : 1;
+        } else {
+            weights[i] = 1;
+        }
+        total_weight += weights[i];
+    }
+
+    int assigned = 0;
+    long remainders[MAX_PROCESSES];
+    for (int i = 0; i < num_procs; i++) {
+        processes[i].frame_quota = (int)(NUM_FRAMES * weights[i] / total_weight);
+        remainders[i] = NUM_FRAMES * weights[i] % total_weight;
+        assigned += processes[i].frame_quota;
+    }
+    // Hand out the frames lost to rounding, largest remainder first (lower pid on ties)
+    while (assigned < NUM_FRAMES) {
+        int best = 0;
+        for (int i = 1; i < num_procs; i++) {
+            if (remainders[i] > remainders[best]) {
+                best = i;
             }
         }
+        processes[best].frame_quota++;
+        remainders[best] = -1;
+        assigned++;
     }
+    for (int i = 0; i < num_procs; i++) {
+        if (processes[i].frame_quota < 1) {
+            processes[i].frame_quota = 1;
+        }
+    }
+}
 
-    return -1;
+// Tells whether a faulting process may grow into a free frame.
+bool may_take_free_frame(int pid) {
+    if (sim_options.replacement_scope == GLOBAL_REPLACEMENT) {
+        return true;
+    }
+    return count_frames_of(pid) < processes[pid - 1].frame_quota;
 }
 
-// Finds the first available frame in physical memory.
-int find_free_frame() {
+// Marks the frames a faulting process may take its victim from.
+// Global replacement allows every frame. Local replacement keeps the search inside the process's own
+// frames once it reached its quota. Below the quota it reclaims from processes that are above theirs.
+// A frame of a pid without a quota (the first access of the trace is loaded even for an invalid pid)
+// is always over quota.
+void select_victim_candidates(int pid, bool candidates[]) {
     for (int i = 0; i < NUM_FRAMES; i++) {
-        // A free frame is one with a process ID of -1
-        if (physical_memory[i].process_id == -1) {
-            return i; // Return the index of the first free one we find
+        candidates[i] = physical_memory.process_id[i] != ZSWAP_FRAME;
+    }
+    if (sim_options.replacement_scope == GLOBAL_REPLACEMENT) {
+        return;
+    }
+
+    int owned = count_frames_of(pid);
+    bool found = false;
+    if (owned < processes[pid - 1].frame_quota) {
+        for (int i = 0; i < NUM_FRAMES; i++) {
+            int owner = physical_memory.process_id[i];
+            bool has_quota = owner >= 1 && owner <= quota_procs;
+            candidates[i] = owner != -1 && owner != ZSWAP_FRAME && owner != pid &&
+                            (!has_quota || count_frames_of(owner) > processes[owner - 1].frame_quota);
+            found = found || candidates[i];
+        }
+    }
+    if (!found && owned > 0) {
+        for (int i = 0; i < NUM_FRAMES; i++) {
+            candidates[i] = physical_memory.process_id[i] == pid;
+        }
+        found = true;
+    }
+    if (!found) {
+        // Nobody is over quota and the process owns nothing, so fall back to a global victim
+        for (int i = 0; i < NUM_FRAMES; i++) {
+            candidates[i] = true;
         }
     }
-    return -1; // No free frames were found
 }
 
-// Implements the FIFO page replacement algorithm to find the page that has been in memory the longest.
-int find_victim_fifo() {
-    int frame_to_replace = -1;
+// --- Memory Tiers ---
 
-    int smallest_load_time = INT_MAX;
-    
-    for (int i = 0; i < NUM_FRAMES; i++) {
-        // If the load time of this frame is smaller than the smallest we've seen so far...
-        if (physical_memory[i].load_time < smallest_load_time) {
-            // ...then this is our new candidate to be replaced.
-            smallest_load_time = physical_memory[i].load_time;
-            frame_to_replace = i;
+// Returns the first frame of a node. Past the last node this is NUM_FRAMES, so the last node ends
+// with memory and takes the frames its count left over.
+int tier_first_frame(int tier) {
+    if (tier >= sim_options.num_tiers) {
+        return NUM_FRAMES;
+    }
+    int first = 0;
+    for (int t = 0; t < tier; t++) {
+        first += sim_options.tiers[t].frames;
+    }
+    return first;
+}
+
+// Returns the node holding a frame.
+int tier_of_frame(int frame_index) {
+    int tier = 0;
+    while (frame_index >= tier_first_frame(tier + 1)) {
+        tier++;
+    }
+    return tier;
+}
+
+int find_free_frame_in_tier(int tier) {
+    int first = tier_first_frame(tier);
+    int index = scan_find_value(physical_memory.process_id + first, -1, tier_first_frame(tier + 1) - first);
+    return index == -1 ? -1 : first + index;
+}
+
+// Finds the free frame a new page goes to. First touch fills the nodes from the fastest one, like a
+// process allocating next to its CPU and spilling to the farther nodes. Interleave starts each page
+// on a different node so the pages of a process spread evenly over all of them.
+int find_free_frame_for(int pid, int page_num) {
+    if (sim_options.num_tiers == 0) {
+        return find_free_frame();
+    }
+    int first = sim_options.placement == PLACE_INTERLEAVE ? (pid + page_num) % sim_options.num_tiers : 0;
+    for (int n = 0; n < sim_options.num_tiers; n++) {
+        int frame_index = find_free_frame_in_tier((first + n) % sim_options.num_tiers);
+        if (frame_index != -1) {
+            return frame_index;
         }
     }
-    return frame_to_replace;
+    return -1;
 }
 
-// Implements the LRU page replacement algorithm to find the page that has not been accessed for the longest time.
-int find_victim_lru() {
-    int frame_to_replace = -1;
+// Charges an access to the node of the frame that served it.
+void charge_tier_access(int frame_index) {
+    int tier = tier_of_frame(frame_index);
+    sim_stats.access_latency += sim_options.tiers[tier].latency;
+    sim_stats.tier_accesses[tier]++;
+    physical_memory.hotness[frame_index]++;
+}
 
-    int smallest_access_time = INT_MAX;
+// Exchanges the contents of two frames, one of which may be free. The page keeps its load and
+// access times, so migrating it does not change its place in the FIFO or LRU order.
+void swap_frames(int a, int b) {
+    int process_id = physical_memory.process_id[a];
+    int page_number = physical_memory.page_number[a];
+    int load_time = physical_memory.load_time[a];
+    int last_access_time = physical_memory.last_access_time[a];
+    bool prefetched = physical_memory.prefetched[a];
+    int hotness = physical_memory.hotness[a];
+    physical_memory.process_id[a] = physical_memory.process_id[b];
+    physical_memory.page_number[a] = physical_memory.page_number[b];
+    physical_memory.load_time[a] = physical_memory.load_time[b];
+    physical_memory.last_access_time[a] = physical_memory.last_access_time[b];
+    physical_memory.prefetched[a] = physical_memory.prefetched[b];
+    physical_memory.hotness[a] = physical_memory.hotness[b];
+    physical_memory.process_id[b] = process_id;
+    physical_memory.page_number[b] = page_number;
+    physical_memory.load_time[b] = load_time;
+    physical_memory.last_access_time[b] = last_access_time;
+    physical_memory.prefetched[b] = prefetched;
+    physical_memory.hotness[b] = hotness;
+}
 
-    for (int i = 0; i < NUM_FRAMES; i++) {
-        // If the last access time of this frame is smaller than the smallest we've seen...
-        if (physical_memory[i].last_access_time < smallest_access_time) {
-            // ...then this is our new candidate.
-            smallest_access_time = physical_memory[i].last_access_time;
-            frame_to_replace = i;
-        } else if (physical_memory[i].last_access_time == smallest_access_time) {
-            // Tie-breaking rule: choose the frame with the smaller ID.
-            if (frame_to_replace == -1 || physical_memory[i].frame_id < frame_to_replace) {
-                frame_to_replace = i;
+// Promotes the pages that became hot on a slower node. A hot page moves to the fastest node with a
+// free frame, or else trades places with the coldest page of the faster nodes when that one is
+// colder, which demotes it. Large pages stay where they are. Every hotness is then halved, so a page
+// has to keep being used to stay hot.
+void migrate_pages(void) {
+    for (int f = tier_first_frame(1); f < NUM_FRAMES; f++) {
+        if (physical_memory.process_id[f] == -1 || physical_memory.large_page[f] ||
+            physical_memory.hotness[f] < sim_options.hot_threshold) {
+            continue;
+        }
+        int tier = tier_of_frame(f);
+        int target = -1;
+        for (int t = 0; t < tier && target == -1; t++) {
+            target = find_free_frame_in_tier(t);
+        }
+        if (target == -1) {
+            for (int i = 0; i < tier_first_frame(tier); i++) {
+                if (physical_memory.process_id[i] != -1 && !physical_memory.large_page[i] &&
+                    physical_memory.hotness[i] < physical_memory.hotness[f] &&
+                    (target == -1 || physical_memory.hotness[i] < physical_memory.hotness[target])) {
+                    target = i;
+                }
+            }
+            if (target == -1) {
+                continue;
             }
+            sim_stats.demotions++;
         }
+        swap_frames(f, target);
+        sim_stats.promotions++;
+    }
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        physical_memory.hotness[i] /= 2;
     }
-    return frame_to_replace;
 }
 
 // Updates a frame in physical memory with the new page information.
 void load_page_into_frame(int frame_id, int pid, int page_num, int current_time) {
-    physical_memory[frame_id].process_id = pid;
-    physical_memory[frame_id].page_number = page_num;
-    physical_memory[frame_id].load_time = current_time;
-    physical_memory[frame_id].last_access_time = current_time;
+    physical_memory.process_id[frame_id] = pid;
+    physical_memory.page_number[frame_id] = page_num;
+    physical_memory.load_time[frame_id] = current_time;
+    physical_memory.last_access_time[frame_id] = current_time;
+    physical_memory.large_page[frame_id] = false;
+    physical_memory.prefetched[frame_id] = false;
+    physical_memory.hotness[frame_id] = 0;
+}
+
+// Replaces every time by its rank among the times of the same column (ties stay ties), so the
+// replacement order is unchanged but the times restart near 0
+static void rank_times(int times[]) {
+    int ranks[NUM_FRAMES];
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        ranks[i] = 0;
+        for (int j = 0; j < NUM_FRAMES; j++) {
+            if (times[j] < times[i]) ranks[i]++;
+        }
+    }
+    memcpy(times, ranks, sizeof(ranks));
+}
+
+int compact_frame_times(void) {
+    rank_times(physical_memory.load_time);
+    rank_times(physical_memory.last_access_time);
+    return NUM_FRAMES;
+}
+
+// Fills a group of contiguous frames with one large page.
+void load_large_page(int first_frame, int frames_needed, int pid, int page_num, int current_time) {
+    for (int i = first_frame; i < first_frame + frames_needed; i++) {
+        load_page_into_frame(i, pid, page_num, current_time);
+        physical_memory.large_page[i] = true;
+    }
+}
+
+// Counts a prefetched page that leaves memory without having been used, and compresses the page
+// into the zswap pool when there is one.
+void note_eviction(int frame_index) {
+    if (physical_memory.process_id[frame_index] != -1 && physical_memory.prefetched[frame_index]) {
+        sim_stats.prefetch_unused++;
+    }
+    if (sim_options.zswap_frames > 0 && physical_memory.process_id[frame_index] > 0) {
+        zswap_store(&sim_zswap, physical_memory.process_id[frame_index], physical_memory.page_number[frame_index]);
+    }
+}
+
+// Frees every frame holding the page stored in the given frame (all of them for a large page).
+void evict_page(int frame_index) {
+    int pid = physical_memory.process_id[frame_index];
+    int page_num = physical_memory.page_number[frame_index];
+    note_eviction(frame_index);
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        if (physical_memory.process_id[i] == pid && physical_memory.page_number[i] == page_num) {
+            physical_memory.process_id[i] = -1;
+            physical_memory.large_page[i] = false;
+        }
+    }
+}
+
+// Returns how many base frames one page of this process takes.
+int frames_per_page(int pid) {
+    if (sim_options.huge_page_frames > 1 && pid >= 1 && pid <= MAX_PROCESSES && sim_options.large_page_procs[pid - 1]) {
+        return sim_options.huge_page_frames;
+    }
+    return 1;
+}
+
+// --- Page Table Accounting ---
+
+PageTableNode *create_page_table_node(int num_entries, bool has_children) {
+    PageTableNode *node = (PageTableNode *)calloc(1, sizeof(PageTableNode));
+    node->num_entries = num_entries;
+    if (has_children) {
+        node->children = (PageTableNode **)calloc(num_entries, sizeof(PageTableNode *));
+    }
+    sim_stats.page_table_nodes++;
+    sim_stats.page_table_bytes += (long)num_entries * PTE_SIZE;
+    return node;
+}
+
+void free_page_table_node(PageTableNode *node) {
+    if (node == NULL) {
+        return;
+    }
+    if (node->children != NULL) {
+        for (int i = 0; i < node->num_entries; i++) {
+            free_page_table_node(node->children[i]);
+        }
+        free(node->children);
+    }
+    free(node);
+}
+
+// Walks the page table of a process for one translation, allocating the missing levels on the way.
+// Large pages are mapped one level above the last one, so their walks are one step shorter.
+void walk_page_table(int pid, int page_num) {
+    if (sim_options.page_table_levels <= 0 || pid < 1 || pid > MAX_PROCESSES) {
+        return;
+    }
+    ProcessInfo *proc = &processes[pid - 1];
+    int levels = sim_options.page_table_levels;
+    if (frames_per_page(pid) > 1 && levels > 1) {
+        levels--;
+    }
+    int bits = sim_options.page_table_bits;
+    int mask = (1 << bits) - 1;
+
+    if (proc->page_table == NULL) {
+        // The root is sized to cover the whole address space of the process
+        int page_bytes = PAGE_SIZE * frames_per_page(pid);
+        int highest_page = proc->memory_size > 0 ? (proc->memory_size - 1) / page_bytes : 0;
+        int root_entries = (highest_page >> (bits * (levels - 1))) + 1;
+        proc->page_table = create_page_table_node(root_entries, levels > 1);
+    }
+
+    PageTableNode *node = proc->page_table;
+    if (page_num < 0 || (page_num >> (bits * (levels - 1))) >= node->num_entries) {
+        return; // Outside the address space the root covers
+    }
+    for (int depth = 0; depth < levels; depth++) {
+        sim_stats.walk_steps++; // One memory reference per level
+        if (depth == levels - 1) {
+            break; // The last level holds the page table entry itself
+        }
+        int index = page_num >> (bits * (levels - 1 - depth));
+        if (depth > 0) {
+            index = index & mask;
+        }
+        if (node->children[index] == NULL) {
+            node->children[index] = create_page_table_node(1 << bits, depth + 1 < levels - 1);
+        }
+        node = node->children[index];
+    }
 }
 
 // Initializes the simulation state with the given number of processes and their memory sizes.
 void initialize_simulation(int num_procs, const int mem_sizes[]) {
     // Set all frames to be free
     for (int i = 0; i < NUM_FRAMES; i++) {
-        physical_memory[i].frame_id = i;
-        physical_memory[i].process_id = -1; // -1 means free
+        physical_memory.process_id[i] = -1; // -1 means free
+        physical_memory.large_page[i] = false;
     }
     // Set up the processes for this test case
     for (int i = 0; i < num_procs; i++) {
@@ -106,7 +432,179 @@ void initialize_simulation(int num_procs, const int mem_sizes[]) {
         processes[i].memory_size = mem_sizes[i];
         processes[i].terminated = false;
         processes[i].sigsegv_printed = false;
+        processes[i].page_table = NULL;
+        processes[i].last_page = -1;
+        processes[i].stride = 0;
+        processes[i].stride_confirmed = false;
+    }
+    // Refaults are tracked per page of every process, up to the page of its last valid address
+    kswapd_awake = false;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        free(processes[i].reclaimed);
+        processes[i].reclaimed = NULL;
+        if (sim_options.kswapd && i < num_procs && mem_sizes[i] > 0) {
+            processes[i].reclaimed = (bool *)calloc(mem_sizes[i] / PAGE_SIZE + 1, sizeof(bool));
+        }
+    }
+    memset(&sim_stats, 0, sizeof(sim_stats));
+    if (sim_options.replacement_scope == LOCAL_REPLACEMENT) {
+        compute_frame_quotas(num_procs);
+    }
+    if (sim_options.cache) {
+        CacheLevelConfig levels[CACHE_LEVELS];
+        int num_levels = sim_options.num_cache_levels;
+        if (num_levels > 0) {
+            memcpy(levels, sim_options.cache_levels, sizeof(levels));
+        } else {
+            cache_default_levels(levels);
+            num_levels = CACHE_LEVELS;
+        }
+        cache_destroy(&sim_cache);
+        cache_init(&sim_cache, levels, num_levels, num_procs, sim_options.cache_pollution);
+    }
+    if (sim_options.zswap_frames > 0) {
+        for (int i = NUM_FRAMES - sim_options.zswap_frames; i < NUM_FRAMES; i++) {
+            physical_memory.process_id[i] = ZSWAP_FRAME;
+        }
+        zswap_destroy(&sim_zswap);
+        zswap_init(&sim_zswap, sim_options.zswap_frames, sim_options.zswap_ratio, sim_options.zswap_latency,
+                   sim_options.disk_latency);
+    }
+}
+
+// Releases the page tables built during a run.
+void free_page_tables(int num_procs) {
+    for (int i = 0; i < num_procs; i++) {
+        free_page_table_node(processes[i].page_table);
+        processes[i].page_table = NULL;
+    }
+}
+
+// --- Prefetching ---
+
+// Follows the page changes of a process to detect sequential or strided access.
+void update_stride(int pid, int page_num) {
+    ProcessInfo *proc = &processes[pid - 1];
+    if (proc->last_page != -1 && page_num != proc->last_page) {
+        int delta = page_num - proc->last_page;
+        proc->stride_confirmed = (delta == proc->stride);
+        proc->stride = delta;
     }
+    proc->last_page = page_num;
+}
+
+// Reads ahead the next pages of a strided process after a fault.
+// Prefetched pages go into free frames first, then into the policy's coldest frame,
+// but never over the page that has just been faulted in.
+void prefetch_pages(ReplacementAlgo algo, int pid, int page_num, int faulted_frame, int current_time) {
+    ProcessInfo *proc = &processes[pid - 1];
+    if (sim_options.prefetch_depth <= 0 || !proc->stride_confirmed || frames_per_page(pid) > 1) {
+        return;
+    }
+    int highest_page = (proc->memory_size - 1) / PAGE_SIZE;
+
+    for (int k = 1; k <= sim_options.prefetch_depth; k++) {
+        int next_page = page_num + proc->stride * k;
+        if (next_page < 0 || next_page > highest_page) {
+            break; // The stream runs out of the address space
+        }
+        if (find_page_in_memory(pid, next_page) != -1) {
+            continue;
+        }
+        int frame_index = may_take_free_frame(pid) ? find_free_frame_for(pid, next_page) : -1;
+        if (frame_index == -1) {
+            bool candidates[NUM_FRAMES];
+            select_victim_candidates(pid, candidates);
+            candidates[faulted_frame] = false; // Never replace the page that has just been faulted in
+            frame_index = find_victim(algo, candidates);
+            if (frame_index == -1) {
+                break;
+            }
+            if (physical_memory.large_page[frame_index]) {
+                evict_page(frame_index);
+            } else {
+                note_eviction(frame_index);
+            }
+            if (!physical_memory.prefetched[frame_index]) {
+                sim_stats.prefetch_evictions++;
+            }
+        }
+        if (sim_options.zswap_frames > 0) {
+            zswap_forget(&sim_zswap, pid, next_page);
+        }
+        load_page_into_frame(frame_index, pid, next_page, current_time);
+        physical_memory.prefetched[frame_index] = true;
+        sim_stats.prefetches++;
+    }
+}
+
+// Handles a page fault by placing the page in free frames or replacing a victim.
+void handle_page_fault(ReplacementAlgo algo, int pid, int page_num, int current_time) {
+    int frames_needed = frames_per_page(pid);
+    bool candidates[NUM_FRAMES];
+    sim_stats.page_faults++;
+    sim_stats.process_faults[pid - 1]++;
+    if (sim_options.zswap_frames > 0) {
+        zswap_load(&sim_zswap, pid, page_num);
+    }
+    if (processes[pid - 1].reclaimed != NULL && processes[pid - 1].reclaimed[page_num]) {
+        processes[pid - 1].reclaimed[page_num] = false;
+        sim_stats.kswapd_refaults++;
+    }
+
+    if (frames_needed == 1) {
+        // First, check if there is a free frame we can use
+        int frame_index;
+        PROFILE_CALL(PROFILE_FREE_FRAME, frame_index = may_take_free_frame(pid) ? find_free_frame_for(pid, page_num) : -1);
+        if (frame_index != -1) {
+            sim_stats.free_frame_faults++;
+        } else {
+            // Memory is full (or the process is at its quota). We must replace a page.
+            sim_stats.direct_reclaims++;
+            PROFILE_CALL(PROFILE_VICTIM, select_victim_candidates(pid, candidates); frame_index = find_victim(algo, candidates));
+            // A victim that is part of a large page takes the whole large page with it
+            if (physical_memory.large_page[frame_index]) {
+                evict_page(frame_index);
+            } else {
+                note_eviction(frame_index);
+            }
+        }
+        load_page_into_frame(frame_index, pid, page_num, current_time);
+        prefetch_pages(algo, pid, page_num, frame_index, current_time);
+        return;
+    }
+
+    // A large page needs an aligned group of frames, so keep evicting until one group is free
+    sim_stats.large_page_faults++;
+    int usable_frames = NUM_FRAMES - (NUM_FRAMES % frames_needed);
+    int first_frame = may_take_free_frame(pid) ? find_free_block(frames_needed) : -1;
+    if (first_frame != -1) {
+        sim_stats.free_frame_faults++;
+    } else {
+        sim_stats.direct_reclaims++;
+    }
+    while (first_frame == -1) {
+        select_victim_candidates(pid, candidates);
+        for (int i = usable_frames; i < NUM_FRAMES; i++) {
+            candidates[i] = false; // The tail frames cannot be part of an aligned group
+        }
+        int victim_frame_index = find_victim(algo, candidates);
+        if (victim_frame_index == -1) {
+            // Only the unusable tail is eligible, so reclaim from anyone
+            for (int i = 0; i < usable_frames; i++) {
+                candidates[i] = true;
+            }
+            victim_frame_index = find_victim(algo, candidates);
+        }
+        int group_start = victim_frame_index - (victim_frame_index % frames_needed);
+        for (int i = group_start; i < group_start + frames_needed; i++) {
+            if (physical_memory.process_id[i] != -1) {
+                evict_page(i);
+            }
+        }
+        first_frame = find_free_block(frames_needed);
+    }
+    load_large_page(first_frame, frames_needed, pid, page_num, current_time);
 }
 
 // Prints the header of the output table.
@@ -123,80 +621,95 @@ void print_header(int num_procs) {
     printf("\n");
 }
 
-// Prints one row of the output table, representing the system state at a specific time.
-void print_state(int current_time, int num_procs) {
+// Orders the (page, frame) pairs of one process by page number, keeping frame order on equal pages.
+int compare_page_frame(const void *a, const void *b) {
+    const int *left = (const int *)a;
+    const int *right = (const int *)b;
+    if (left[0] != right[0]) {
+        return left[0] < right[0] ? -1 : 1;
+    }
+    return (left[1] > right[1]) - (left[1] < right[1]);
+}
+
+// Prints one row of the output table from a view of the frame table and of the terminated processes.
+// sigsegv_printed (index pid-1) remembers which terminations have been shown already.
+void print_frame_row(int current_time, int num_procs, const int process_id[], const int page_number[],
+                     const bool terminated[], bool sigsegv_printed[]) {
     printf("%-5d ", current_time);
     printf("%-3s", ""); // The empty "inst" column
 
     // loop through each process and print its column
     for (int i = 1; i <= num_procs; i++) {
-        char string_for_this_column[100];
+        // Room for "F<id>," for every frame, so one process can own the whole memory
+        char string_for_this_column[NUM_FRAMES * 12 + 8];
         strcpy(string_for_this_column, ""); // Make sure the string is empty to start
         
         // CHeck if the proccess has terminated due to segmentation fault
-        ProcessInfo current_process_info = processes[i-1];
-        if (current_process_info.terminated == true) {
+        if (terminated[i-1] == true) {
             // Only print SIGSEGV one time
-            if (current_process_info.sigsegv_printed == false) {
+            if (sigsegv_printed[i-1] == false) {
                 strcpy(string_for_this_column, "SIGSEGV");
-                processes[i-1].sigsegv_printed = true; // Prevent "SIGSEGV" from being printed more than once
+                sigsegv_printed[i-1] = true; // Prevent "SIGSEGV" from being printed more than once
             }
         } else {
-            // If the process is not terminated, find its frames
-            int frames_this_process_owns[NUM_FRAMES];
-            int pages_in_those_frames[NUM_FRAMES];
+            // If the process is not terminated, find its frames as (page, frame) pairs
+            int pages_and_frames[NUM_FRAMES][2];
             int number_of_frames_found = 0;
 
-            for(int j = 0; j < NUM_FRAMES; j++) {
-                if (physical_memory[j].process_id == i) {
-                    frames_this_process_owns[number_of_frames_found] = physical_memory[j].frame_id;
-                    pages_in_those_frames[number_of_frames_found] = physical_memory[j].page_number;
-                    number_of_frames_found = number_of_frames_found + 1;
-                }
+            int j = scan_find_value(process_id, i, NUM_FRAMES);
+            while (j != -1) {
+                pages_and_frames[number_of_frames_found][0] = page_number[j];
+                pages_and_frames[number_of_frames_found][1] = j;
+                number_of_frames_found = number_of_frames_found + 1;
+                int next = scan_find_value(process_id + j + 1, i, NUM_FRAMES - j - 1);
+                j = next == -1 ? -1 : j + 1 + next;
             }
 
-            // Bubble sort the frames based on the page number
-            for (int k = 0; k < number_of_frames_found - 1; k++) {
-                for (int l = 0; l < number_of_frames_found - k - 1; l++) {
-                    if (pages_in_those_frames[l] > pages_in_those_frames[l+1]) {
-                        // Swap the pages
-                        int temp_p = pages_in_those_frames[l];
-                        pages_in_those_frames[l] = pages_in_those_frames[l+1];
-                        pages_in_those_frames[l+1] = temp_p;
-                        // Swap the frames
-                        int temp_f = frames_this_process_owns[l];
-                        frames_this_process_owns[l] = frames_this_process_owns[l+1];
-                        frames_this_process_owns[l+1] = temp_f;
-                    }
-                }
-            }
+            // Sort the frames based on the page number
+            qsort(pages_and_frames, number_of_frames_found, sizeof(pages_and_frames[0]), compare_page_frame);
             
             // Build the final string like "F1,F5,F6"
+            size_t length = 0;
             for(int k = 0; k < number_of_frames_found; k++) {
-                char temp_string[10];
-                if (k < number_of_frames_found - 1) {
-                    // If it's not the last one, add a comma
-                    sprintf(temp_string, "F%d,", frames_this_process_owns[k]);
-                } else {
-                    // If it is the last one, no comma
-                    sprintf(temp_string, "F%d", frames_this_process_owns[k]);
-                }
-                strcat(string_for_this_column, temp_string);
+                // If it's not the last one, add a comma
+                const char *separator = k < number_of_frames_found - 1 ? "," : "";
+                length += sprintf(string_for_this_column + length, "F%d%s", pages_and_frames[k][1], separator);
             }
         }
         // Print the final string for the column, with padding
         printf(" %-18s", string_for_this_column);
     }
     printf("\n");
+}
+
+// Prints one row of the output table, representing the system state at a specific time.
+void print_state(int current_time, int num_procs) {
+    bool terminated[MAX_PROCESSES] = {false}, sigsegv_printed[MAX_PROCESSES] = {false};
+    for (int i = 0; i < num_procs; i++) {
+        terminated[i] = processes[i].terminated;
+        sigsegv_printed[i] = processes[i].sigsegv_printed;
+    }
+    print_frame_row(current_time, num_procs, physical_memory.process_id, physical_memory.page_number, terminated, sigsegv_printed);
+    for (int i = 0; i < num_procs; i++) {
+        processes[i].sigsegv_printed = sigsegv_printed[i];
+    }
     // Make sure everything is written to the file right away
     fflush(stdout);
 }
 
-// The main simulation engine
-void run_simulation_logic(ReplacementAlgo algo, int num_procs, const int mem_sizes[], const int exec_trace[], int trace_len) {
-    // Reset everything for this new simulation run
-    initialize_simulation(num_procs, mem_sizes);
+// Copies what one row of the output table shows, so it can be printed later by another thread.
+void capture_state(int current_time, int num_procs, StateSnapshot *snapshot) {
+    snapshot->time = current_time;
+    memcpy(snapshot->process_id, physical_memory.process_id, sizeof(snapshot->process_id));
+    memcpy(snapshot->page_number, physical_memory.page_number, sizeof(snapshot->page_number));
+    for (int i = 0; i < num_procs; i++) {
+        snapshot->terminated[i] = processes[i].terminated;
+    }
+}
 
+// Loads the page of the first access into frame 0 before the first state is printed.
+// Returns the position of the next instruction in the execution list.
+int load_first_access(int num_procs, const int exec_trace[], int trace_len) {
     // This pointer keeps track of where we are in the execution list
     int execution_pointer = 0;
 
@@ -205,17 +718,175 @@ void run_simulation_logic(ReplacementAlgo algo, int num_procs, const int mem_siz
     if (trace_len > 0) {
         int first_pid = exec_trace[execution_pointer];
         int first_address = exec_trace[execution_pointer + 1];
-        int first_page = first_address / PAGE_SIZE;
+        int first_page = first_address / (PAGE_SIZE * frames_per_page(first_pid));
         // Place the first page of the first process into the first physical frame (frame 0) at time 0.
-        load_page_into_frame(0, first_pid, first_page, 0);
+        if (frames_per_page(first_pid) > 1) {
+            load_large_page(0, frames_per_page(first_pid), first_pid, first_page, 0);
+            sim_stats.large_page_faults++;
+        } else {
+            load_page_into_frame(0, first_pid, first_page, 0);
+        }
+        sim_stats.accesses++;
+        sim_stats.page_faults++;
+        sim_stats.free_frame_faults++;
+        if (sim_options.zswap_frames > 0) {
+            zswap_load(&sim_zswap, first_pid, first_page);
+        }
+        if (first_pid >= 1 && first_pid <= num_procs) {
+            // An address past the end of the process is loaded for the table but has no page table entry
+            if (first_address < processes[first_pid - 1].memory_size) {
+                walk_page_table(first_pid, first_page);
+            }
+            sim_stats.process_faults[first_pid - 1]++;
+            update_stride(first_pid, first_page);
+            if (sim_options.num_tiers > 0) {
+                charge_tier_access(0);
+            }
+            if (sim_options.cache) {
+                cache_switch(&sim_cache, first_pid);
+                cache_access(&sim_cache, first_pid, first_address % (PAGE_SIZE * frames_per_page(first_pid)));
+            }
+        }
         // Advance the instruction pointer so the main loop starts with the next instruction.
         execution_pointer = execution_pointer + 2;
     }
 
+    return execution_pointer;
+}
+
+// --- Background Reclaim ---
+
+// Runs the reclaim daemon, like kswapd, at the end of a time step. It wakes when the free frames fall
+// below the low watermark and evicts the pages the replacement policy would pick from all the frames,
+// whatever the replacement scope, kswapd_batch per step until the high watermark is reached. Faults
+// then find a free frame instead of evicting on their own.
+void run_kswapd(ReplacementAlgo algo, int num_procs) {
+    int free_frames = count_frames_of(-1);
+    if (!kswapd_awake && free_frames < sim_options.low_watermark) {
+        kswapd_awake = true;
+        sim_stats.kswapd_wakeups++;
+    }
+    if (!kswapd_awake) {
+        return;
+    }
+    sim_stats.kswapd_steps++;
+    bool candidates[NUM_FRAMES];
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        candidates[i] = physical_memory.process_id[i] != ZSWAP_FRAME;
+    }
+    for (int n = 0; n < sim_options.kswapd_batch && free_frames < sim_options.high_watermark; n++) {
+        int victim = find_victim(algo, candidates);
+        if (victim == -1) {
+            break;
+        }
+        int pid = physical_memory.process_id[victim];
+        int page = physical_memory.page_number[victim];
+        // The first access of the trace is loaded even past the end of its process, where no refault can follow
+        if (pid >= 1 && pid <= num_procs && processes[pid - 1].reclaimed != NULL &&
+            page <= (processes[pid - 1].memory_size - 1) / PAGE_SIZE) {
+            processes[pid - 1].reclaimed[page] = true;
+        }
+        evict_page(victim);
+        sim_stats.kswapd_reclaimed++;
+        free_frames = count_frames_of(-1); // A large page frees all of its frames
+    }
+    if (free_frames >= sim_options.high_watermark) {
+        kswapd_awake = false;
+    }
+}
+
+// Applies one memory access to the simulator state. The access is stamped with current_time.
+// This is the step the general loop runs for every instruction, and what streaming mode feeds record by record.
+void simulate_access(ReplacementAlgo algo, int num_procs, int current_pid, int current_address, int time_of_the_event) {
+    // Check if the process ID is valid or if the process has already been terminated
+    if (current_pid < 1 || current_pid > num_procs || processes[current_pid - 1].terminated == true) {
+         // If so, just skip the instruction
+         if (sim_options.kswapd) {
+             run_kswapd(algo, num_procs);
+         }
+         return;
+    }
+    sim_stats.accesses++;
+    if (sim_options.cache) {
+        cache_switch(&sim_cache, current_pid);
+    }
+    
+    // Check for Segmentation Fault (accessing memory outside the process's allowed space)
+    if (current_address >= processes[current_pid - 1].memory_size) {
+        processes[current_pid - 1].terminated = true;
+        sim_stats.segfaults++;
+        // When a process dies, all its frames become free
+        int i;
+        for (i = 0; i < NUM_FRAMES; i++) {
+            if (physical_memory.process_id[i] == current_pid) {
+                physical_memory.process_id[i] = -1; // Mark as free
+                physical_memory.large_page[i] = false;
+            }
+        }
+        if (sim_options.zswap_frames > 0) {
+            zswap_drop_process(&sim_zswap, current_pid);
+        }
+    } else {
+        // If the access is valid, figure out which page is needed
+        int needed_page = current_address / (PAGE_SIZE * frames_per_page(current_pid));
+        walk_page_table(current_pid, needed_page);
+        update_stride(current_pid, needed_page);
+        
+        // See if that page is already in a frame (a "page hit")
+        int frame_index;
+        PROFILE_CALL(PROFILE_LOOKUP, frame_index = find_page_in_memory(current_pid, needed_page));
+        
+        if (frame_index != -1) {
+            // This is a PAGE HIT. We just need to update the last access time for LRU.
+            physical_memory.last_access_time[frame_index] = time_of_the_event;
+            if (physical_memory.prefetched[frame_index]) {
+                physical_memory.prefetched[frame_index] = false;
+                sim_stats.prefetch_hits++;
+            }
+            if (physical_memory.large_page[frame_index]) {
+                // Keep every frame of the large page equally recent
+                for (int i = frame_index; i < frame_index + frames_per_page(current_pid); i++) {
+                    physical_memory.last_access_time[i] = time_of_the_event;
+                }
+            }
+        } else {
+            // This is a PAGE FAULT. The page is not in memory.
+            handle_page_fault(algo, current_pid, needed_page, time_of_the_event);
+            frame_index = find_page_in_memory(current_pid, needed_page);
+        }
+        if (sim_options.num_tiers > 0 && frame_index != -1) {
+            charge_tier_access(frame_index);
+        }
+        if (sim_options.cache && frame_index != -1) {
+            // A large page starts at its first frame and spans the next ones
+            int page_bytes = PAGE_SIZE * frames_per_page(current_pid);
+            cache_access(&sim_cache, current_pid, frame_index * PAGE_SIZE + current_address % page_bytes);
+        }
+    }
+    if (sim_options.num_tiers > 0 && sim_options.migrate_interval > 0 &&
+        sim_stats.accesses % sim_options.migrate_interval == 0) {
+        migrate_pages();
+    }
+    if (sim_options.kswapd) {
+        run_kswapd(algo, num_procs);
+    }
+}
+
+// Counts the frames holding a page.
+int resident_frames(void) {
+    return NUM_FRAMES - count_frames_of(-1) - count_frames_of(ZSWAP_FRAME);
+}
+
+// The general simulation loop, used whenever an optional feature is enabled.
+void run_generic_simulation(ReplacementAlgo algo, int num_procs, const int exec_trace[], int trace_len) {
+    int execution_pointer = load_first_access(num_procs, exec_trace, trace_len);
+
     // Main loop for each time step
     for (int time_step = 0; time_step < trace_len; time_step++) {
         // First, print the state of memory as it is at the start of this time step
-        print_state(time_step, num_procs);
+        if (!sim_options.quiet) {
+            PROFILE_CALL(PROFILE_PRINT_STATE, print_state(time_step, num_procs));
+        }
 
         // Stop if we have reached the end of the instruction list
         if (exec_trace[execution_pointer] == 0 || execution_pointer >= trace_len * 2) {
@@ -227,58 +898,214 @@ void run_simulation_logic(ReplacementAlgo algo, int num_procs, const int mem_siz
         int current_address = exec_trace[execution_pointer + 1];
         
         // Any memory event (load or access) that happens now is marked with the *next* time step's time
-        int time_of_the_event = time_step + 1;
+        simulate_access(algo, num_procs, current_pid, current_address, time_step + 1);
 
-        // Check if the process ID is valid or if the process has already been terminated
-        if (current_pid > num_procs || processes[current_pid - 1].terminated == true) {
-             // If so, just skip to the next instruction
-             execution_pointer = execution_pointer + 2;
-             continue;
-        }
-        
-        // Check for Segmentation Fault (accessing memory outside the process's allowed space)
-        if (current_address >= processes[current_pid - 1].memory_size) {
-            processes[current_pid - 1].terminated = true;
-            // When a process dies, all its frames become free
-            int i;
-            for (i = 0; i < NUM_FRAMES; i++) {
-                if (physical_memory[i].process_id == current_pid) {
-                    physical_memory[i].process_id = -1; // Mark as free
-                }
-            }
-        } else {
-            // If the access is valid, figure out which page is needed
-            int needed_page = current_address / PAGE_SIZE;
-            
-            // See if that page is already in a frame (a "page hit")
-            int frame_index = find_page_in_memory(current_pid, needed_page);
-            
-            if (frame_index != -1) {
-                // This is a PAGE HIT. We just need to update the last access time for LRU.
-                physical_memory[frame_index].last_access_time = time_of_the_event;
-            } else {
-                // This is a PAGE FAULT. The page is not in memory.
-                
-                // First, check if there is a free frame we can use
-                int free_frame_index = find_free_frame();
-                
-                if (free_frame_index != -1) {
-                    // A free frame exists, so we use it.
-                    load_page_into_frame(free_frame_index, current_pid, needed_page, time_of_the_event);
-                } else {
-                    // Memory is full. We must replace a page.
-                    int victim_frame_index;
-                    if (algo == FIFO) {
-                        victim_frame_index = find_victim_fifo();
-                    } else {
-                        victim_frame_index = find_victim_lru();
-                    }
-                    // Load our new page into the victim's frame
-                    load_page_into_frame(victim_frame_index, current_pid, needed_page, time_of_the_event);
-                }
-            }
-        }
         // Move our pointer to the next instruction for the next time step
         execution_pointer = execution_pointer + 2;
     }
 }
+
+// --- Contiguous Allocation ---
+
+// Prints one row of the output table with the partition of every process, as first and last byte address
+void print_partition_row(int current_time, int num_procs) {
+    printf("%-5d ", current_time);
+    printf("%-3s", ""); // The empty "inst" column
+    for (int i = 1; i <= num_procs; i++) {
+        char column[32] = "";
+        const Partition *partition = allocator_find(&sim_partitions, i);
+        if (processes[i - 1].terminated) {
+            if (!processes[i - 1].sigsegv_printed) {
+                strcpy(column, "SIGSEGV");
+                processes[i - 1].sigsegv_printed = true;
+            }
+        } else if (partition != NULL) {
+            sprintf(column, "[%d-%d]", partition->start, partition->start + partition->size - 1);
+        }
+        printf(" %-18s", column);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+// One access under contiguous allocation. The partition is requested on every access until it fits,
+// and given back when the process is terminated or makes its last access of the trace.
+void contiguous_access(int num_procs, int pid, int address, bool last_access) {
+    if (pid < 1 || pid > num_procs || processes[pid - 1].terminated) {
+        return;
+    }
+    sim_stats.accesses++;
+    if (allocator_find(&sim_partitions, pid) == NULL &&
+        allocator_alloc(&sim_partitions, pid, processes[pid - 1].memory_size) == -1) {
+        sim_stats.rejected_accesses++;
+        return;
+    }
+    if (sim_options.cache) {
+        cache_switch(&sim_cache, pid);
+    }
+    if (address >= processes[pid - 1].memory_size) {
+        processes[pid - 1].terminated = true;
+        sim_stats.segfaults++;
+        allocator_free(&sim_partitions, pid);
+        return;
+    }
+    if (sim_options.cache) {
+        cache_access(&sim_cache, pid, allocator_find(&sim_partitions, pid)->start + address);
+    }
+    if (last_access) {
+        allocator_free(&sim_partitions, pid);
+    }
+}
+
+// The loop of the contiguous model. Row n shows the partitions after record n, like the paging tables.
+void run_contiguous_simulation(int num_procs, const int exec_trace[], int trace_len) {
+    allocator_destroy(&sim_partitions);
+    allocator_init(&sim_partitions, sim_options.alloc_strategy, NUM_FRAMES * PAGE_SIZE, sim_options.compaction);
+
+    // Record of the last access of each process, where its partition is freed
+    int last_record[MAX_PROCESSES];
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        last_record[i] = -1;
+    }
+    for (int record = 0; record < trace_len && exec_trace[2 * record] != 0; record++) {
+        int pid = exec_trace[2 * record];
+        if (pid >= 1 && pid <= num_procs) last_record[pid - 1] = record;
+    }
+
+    for (int record = 0; record < trace_len && exec_trace[2 * record] != 0; record++) {
+        int pid = exec_trace[2 * record];
+        bool last_access = pid >= 1 && pid <= num_procs && last_record[pid - 1] == record;
+        contiguous_access(num_procs, pid, exec_trace[2 * record + 1], last_access);
+        allocator_sample(&sim_partitions);
+        if (!sim_options.quiet) {
+            print_partition_row(record, num_procs);
+        }
+    }
+}
+
+// --- Specialized Kernels ---
+// One loop per (replacement policy, output mode) for the default configuration, generated from p1_kernel.h.
+// The policy and the output mode are fixed inside each loop, so nothing is decided per access.
+
+#define KERNEL_NAME run_fifo_table
+#define KERNEL_LRU 0
+#define KERNEL_TABLE 1
+#include "p1_kernel.h"
+
+#define KERNEL_NAME run_fifo_quiet
+#define KERNEL_LRU 0
+#define KERNEL_TABLE 0
+#include "p1_kernel.h"
+
+#define KERNEL_NAME run_lru_table
+#define KERNEL_LRU 1
+#define KERNEL_TABLE 1
+#include "p1_kernel.h"
+
+#define KERNEL_NAME run_lru_quiet
+#define KERNEL_LRU 1
+#define KERNEL_TABLE 0
+#include "p1_kernel.h"
+
+typedef void (*SimulationKernel)(int num_procs, const int exec_trace[], int trace_len);
+
+// Tells whether any optional feature is on, which needs the general loop.
+bool uses_optional_features(void) {
+    bool large_pages = false;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        large_pages = large_pages || sim_options.large_page_procs[i];
+    }
+    return sim_options.page_table_levels > 0 || (sim_options.huge_page_frames > 1 && large_pages) ||
+           sim_options.prefetch_depth > 0 || sim_options.replacement_scope != GLOBAL_REPLACEMENT ||
+           sim_options.cache || sim_options.num_tiers > 0 || sim_options.zswap_frames > 0 ||
+           sim_options.kswapd || sim_options.force_generic;
+}
+
+// The main simulation engine. It picks the loop for this run once and then hands the whole trace to it.
+void run_simulation_logic(ReplacementAlgo algo, int num_procs, const int mem_sizes[], const int exec_trace[], int trace_len) {
+    // Reset everything for this new simulation run
+    initialize_simulation(num_procs, mem_sizes);
+
+    if (sim_options.contiguous) {
+        PROFILE_CALL(PROFILE_RUN, run_contiguous_simulation(num_procs, exec_trace, trace_len));
+    } else if (uses_optional_features()) {
+        PROFILE_CALL(PROFILE_RUN, run_generic_simulation(algo, num_procs, exec_trace, trace_len));
+    } else {
+        const SimulationKernel kernels[2][2] = {
+            {run_fifo_table, run_fifo_quiet},
+            {run_lru_table, run_lru_quiet}
+        };
+        PROFILE_CALL(PROFILE_RUN, kernels[algo == LRU][sim_options.quiet](num_procs, exec_trace, trace_len));
+    }
+
+    free_page_tables(num_procs);
+}
+
+// Prints the counters collected by the last run, after the state table.
+void print_statistics(int num_procs) {
+    printf("\n--- Statistics ---\n");
+    printf("%-26s %lld\n", "accesses", sim_stats.accesses);
+    printf("%-26s %lld\n", "page faults", sim_stats.page_faults);
+    printf("%-26s %lld\n", "large page faults", sim_stats.large_page_faults);
+    printf("%-26s %lld\n", "segmentation faults", sim_stats.segfaults);
+    if (sim_options.page_table_levels > 0) {
+        double steps_per_access = sim_stats.accesses > 0 ? (double)sim_stats.walk_steps / sim_stats.accesses : 0.0;
+        printf("%-26s %lld\n", "page walk steps", sim_stats.walk_steps);
+        printf("%-26s %.2f\n", "walk steps per access", steps_per_access);
+        printf("%-26s %lld\n", "page table nodes", sim_stats.page_table_nodes);
+        printf("%-26s %lld\n", "page table bytes", sim_stats.page_table_bytes);
+    }
+    if (sim_options.prefetch_depth > 0) {
+        // Accuracy: used prefetches over issued ones. Coverage: faults avoided over faults that would have happened.
+        long long would_be_faults = sim_stats.page_faults + sim_stats.prefetch_hits;
+        printf("%-26s %lld\n", "prefetches", sim_stats.prefetches);
+        printf("%-26s %lld\n", "prefetch hits", sim_stats.prefetch_hits);
+        printf("%-26s %.2f\n", "prefetch accuracy", sim_stats.prefetches > 0 ? (double)sim_stats.prefetch_hits / sim_stats.prefetches : 0.0);
+        printf("%-26s %.2f\n", "prefetch coverage", would_be_faults > 0 ? (double)sim_stats.prefetch_hits / would_be_faults : 0.0);
+        printf("%-26s %lld\n", "unused prefetches evicted", sim_stats.prefetch_unused);
+        printf("%-26s %lld\n", "prefetch pollution", sim_stats.prefetch_evictions);
+    }
+    if (sim_options.contiguous) {
+        allocator_print_stats(&sim_partitions, stdout);
+        printf("%-26s %lld\n", "rejected accesses", sim_stats.rejected_accesses);
+    }
+    if (sim_options.cache) {
+        cache_print_stats(&sim_cache, stdout);
+    }
+    if (sim_options.num_tiers > 0) {
+        long long memory_accesses = 0;
+        printf("%-8s %-8s %-8s %s\n", "node", "frames", "latency", "accesses");
+        for (int t = 0; t < sim_options.num_tiers; t++) {
+            printf("%-8d %-8d %-8d %lld\n", t, tier_first_frame(t + 1) - tier_first_frame(t), sim_options.tiers[t].latency,
+                   sim_stats.tier_accesses[t]);
+            memory_accesses += sim_stats.tier_accesses[t];
+        }
+        double average = memory_accesses > 0 ? (double)sim_stats.access_latency / memory_accesses : 0.0;
+        printf("%-26s %s\n", "placement", sim_options.placement == PLACE_INTERLEAVE ? "interleave" : "first touch");
+        printf("%-26s %.1f ns\n", "average access latency", average);
+        printf("%-26s %.2fx\n", "slowdown vs fastest node", average / sim_options.tiers[0].latency);
+        printf("%-26s %lld\n", "promotions", sim_stats.promotions);
+        printf("%-26s %lld\n", "demotions", sim_stats.demotions);
+        printf("%-26s %lld bytes\n", "migration traffic", (sim_stats.promotions + sim_stats.demotions) * PAGE_SIZE);
+    }
+    if (sim_options.zswap_frames > 0) {
+        zswap_print_stats(&sim_zswap, NUM_FRAMES, stdout);
+    }
+    if (sim_options.kswapd) {
+        printf("%-26s %d-%d free frames, %d per step\n", "watermarks", sim_options.low_watermark,
+               sim_options.high_watermark, sim_options.kswapd_batch);
+        printf("%-26s %lld\n", "faults with a free frame", sim_stats.free_frame_faults);
+        printf("%-26s %lld\n", "direct reclaims", sim_stats.direct_reclaims);
+        printf("%-26s %lld\n", "kswapd wakeups", sim_stats.kswapd_wakeups);
+        printf("%-26s %lld\n", "kswapd active steps", sim_stats.kswapd_steps);
+        printf("%-26s %lld\n", "pages reclaimed", sim_stats.kswapd_reclaimed);
+        printf("%-26s %lld\n", "refaults", sim_stats.kswapd_refaults);
+    }
+    if (sim_options.replacement_scope == LOCAL_REPLACEMENT) {
+        printf("%-8s %-8s %s\n", "pid", "quota", "faults");
+        for (int i = 0; i < num_procs; i++) {
+            printf("%-8d %-8d %lld\n", i + 1, processes[i].frame_quota, sim_stats.process_faults[i]);
+        }
+    }
+    fflush(stdout);
+}
@@ -2,25 +2,173 @@
 #define P1_SIMULATOR_H
 
 #include <stdbool.h>
+#include "allocator.h"
+#include "cache.h"
+#include "zswap.h"
+
+// --- Configuration ---
+// NUM_FRAMES and MAX_PROCESSES can be raised from the compiler command line for large generated workloads
+#define PAGE_SIZE (3 * 1000)
+#ifndef NUM_FRAMES
+#define NUM_FRAMES 7
+#endif
+#ifndef MAX_PROCESSES
+#define MAX_PROCESSES 20
+#endif
+
+// Size in bytes of one page table entry, used for the page table overhead estimate
+#define PTE_SIZE 8
+
+// process_id of the frames given to the compressed swap pool, which never hold a page
+#define ZSWAP_FRAME (-2)
+
+// Memory nodes of a tiered machine (local DRAM, remote DRAM, CXL attached memory...)
+#define MAX_TIERS 4
 
 typedef enum { FIFO, LRU } ReplacementAlgo;
+typedef enum { GLOBAL_REPLACEMENT, LOCAL_REPLACEMENT } ReplacementScope;
+typedef enum { ALLOC_EQUAL, ALLOC_PROPORTIONAL, ALLOC_PRIORITY } FrameAllocation;
+typedef enum { PLACE_FIRST_TOUCH, PLACE_INTERLEAVE } TierPlacement;
 
+// One memory node. The nodes split the frames in order: node 0 holds the first frames, and so on.
 typedef struct {
-    int frame_id;
-    int process_id;
-    int page_number;
-    int load_time;
-    int last_access_time;
-} Frame;
+    int frames;
+    int latency; // Nanoseconds per access
+} MemoryTier;
+
+// The frame table is kept as one array per field (structure of arrays) and the frame id is the index.
+// Lookups and victim searches only read one or two fields, so they scan contiguous memory and can be
+// vectorized (see frame_scan.c), which matters when NUM_FRAMES is raised to thousands of frames.
+typedef struct {
+    int process_id[NUM_FRAMES];       // -1 for a free frame
+    int page_number[NUM_FRAMES];
+    int load_time[NUM_FRAMES];
+    int last_access_time[NUM_FRAMES];
+    bool large_page[NUM_FRAMES]; // Frame is one of the contiguous frames backing a large page
+    bool prefetched[NUM_FRAMES]; // Loaded by the prefetcher and not used by the process yet
+    int hotness[NUM_FRAMES];     // Accesses since the last migration pass, halved by every pass
+} FrameTable;
+
+// One node of a process's multi-level page table (only used for walk and overhead accounting)
+typedef struct PageTableNode {
+    int num_entries;
+    struct PageTableNode **children; // NULL for the last level
+} PageTableNode;
 
 typedef struct {
     int pid;
     int memory_size;
     bool terminated;
     bool sigsegv_printed;
+    PageTableNode *page_table; // Root of the page table, NULL when walks are not modeled
+
+    // Stride detection for the prefetcher
+    int last_page;
+    int stride;
+    bool stride_confirmed; // The last two page changes had the same stride
+
+    int frame_quota; // Frames the process may hold under local replacement
+
+    bool *reclaimed; // Per page: evicted by the reclaim daemon and not faulted back yet (NULL without it)
 } ProcessInfo;
 
+// Optional features, all disabled by default so the standard output files are unchanged.
+typedef struct {
+    int page_table_levels;  // Levels of the page table walk (0 = no walk accounting)
+    int page_table_bits;    // Index bits per page table level below the root
+    int huge_page_frames;   // Base frames backing one large page (power of two, 0 or 1 = disabled)
+    bool large_page_procs[MAX_PROCESSES]; // Processes (index pid-1) backed by large pages
+    int prefetch_depth;     // Pages read ahead on a fault of a strided process (0 = disabled)
+    ReplacementScope replacement_scope;
+    FrameAllocation frame_allocation;  // How quotas are split under local replacement
+    int priorities[MAX_PROCESSES];     // Weights for ALLOC_PRIORITY (index pid-1, default 1)
+    bool quiet;             // Skip the state table (benchmarks only need the counters)
+    bool force_generic;     // Run the general loop even without optional features (for the fuzzer)
+    // Contiguous allocation instead of paging: a process holds a partition of NUM_FRAMES * PAGE_SIZE
+    // bytes of memory from its first to its last access in the trace, and never faults
+    bool contiguous;
+    AllocStrategy alloc_strategy;
+    bool compaction;
+    // CPU caches on the physical address of every access (the frame or partition it resolves to)
+    bool cache;
+    int num_cache_levels;   // 0 for the default hierarchy of cache_default_levels()
+    CacheLevelConfig cache_levels[CACHE_LEVELS];
+    int cache_pollution;    // Percent of the cached lines lost whenever the trace switches process
+    // Tiered memory: frames are split between nodes of different latency (num_tiers 0 = one flat pool)
+    int num_tiers;
+    MemoryTier tiers[MAX_TIERS]; // In frame order, the last node also takes any frames left over
+    TierPlacement placement;     // Where a faulting page goes while free frames remain
+    int migrate_interval;        // Accesses between migration passes (0 = pages never move)
+    int hot_threshold;           // Hotness a page needs to be promoted to a faster node
+    // Compressed swap: the last zswap_frames frames hold evicted pages compressed (0 = disabled)
+    int zswap_frames;
+    double zswap_ratio;          // Compression ratio, pages per pool frame
+    int zswap_latency;           // Nanoseconds to decompress a page from the pool
+    int disk_latency;            // Nanoseconds to read a page from the backing store
+    // Background reclaim: after a time step with fewer than low_watermark free frames, a daemon evicts
+    // the pages the replacement policy would pick, kswapd_batch per step, until high_watermark are free
+    bool kswapd;
+    int low_watermark;
+    int high_watermark;
+    int kswapd_batch;
+} SimulatorOptions;
+
+// Counters collected during one call to run_simulation_logic(), 64-bit so unbounded streams cannot overflow them
+typedef struct {
+    long long accesses;
+    long long page_faults;
+    long long large_page_faults;
+    long long segfaults;
+    long long walk_steps;         // Page table levels read by all translations
+    long long page_table_nodes;   // Page table nodes allocated by all processes
+    long long page_table_bytes;   // Memory taken by those nodes
+    long long prefetches;         // Pages loaded by the prefetcher
+    long long prefetch_hits;      // Prefetched pages that were used before being evicted
+    long long prefetch_unused;    // Prefetched pages evicted without ever being used
+    long long prefetch_evictions; // Resident pages evicted to make room for prefetches
+    long long rejected_accesses;  // Accesses of processes whose partition did not fit
+    long long access_latency;     // Nanoseconds spent by all accesses in their memory node
+    long long tier_accesses[MAX_TIERS];
+    long long promotions;         // Pages moved to a faster node
+    long long demotions;          // Pages moved to a slower node to make room for a promotion
+    long long free_frame_faults;  // Faults that found a free frame
+    long long direct_reclaims;    // Faults that had to evict a victim themselves
+    long long kswapd_wakeups;
+    long long kswapd_steps;       // Time steps the daemon spent reclaiming
+    long long kswapd_reclaimed;   // Pages the daemon evicted
+    long long kswapd_refaults;    // Faults on pages the daemon evicted, the cost of reclaiming too early
+    long long process_faults[MAX_PROCESSES];
+} SimulationStats;
+
+// What one row of the output table shows, copied out of the simulator state
+typedef struct {
+    int time; // -1 marks the end of a run
+    int process_id[NUM_FRAMES];
+    int page_number[NUM_FRAMES];
+    bool terminated[MAX_PROCESSES];
+} StateSnapshot;
+
+extern SimulatorOptions sim_options;
+extern SimulationStats sim_stats;
+extern Allocator sim_partitions; // Partitions of the last contiguous run
+extern CacheHierarchy sim_cache; // Caches of the last run with sim_options.cache
+extern ZswapPool sim_zswap;      // Compressed pool of the last run with sim_options.zswap_frames
+
 void run_simulation_logic(ReplacementAlgo algo, int num_procs, const int mem_sizes[], const int exec_trace[], int trace_len);
 void print_header(int num_procs);
+void print_statistics(int num_procs);
+
+// Step by step use of the engine, for inputs that are not materialized as an exec_trace array
+void initialize_simulation(int num_procs, const int mem_sizes[]);
+void simulate_access(ReplacementAlgo algo, int num_procs, int pid, int address, int time);
+int resident_frames(void);
+// Renumbers the load and access times of the frames in the same order, for streams that run past
+// INT_MAX time steps. Later accesses must be stamped with at least the returned time.
+int compact_frame_times(void);
+int load_first_access(int num_procs, const int exec_trace[], int trace_len);
+void capture_state(int current_time, int num_procs, StateSnapshot *snapshot);
+void print_frame_row(int current_time, int num_procs, const int process_id[], const int page_number[],
+                     const bool terminated[], bool sigsegv_printed[]);
+void free_page_tables(int num_procs);
 
-#endif
\ No newline at end of file
+#endif
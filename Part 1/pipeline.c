@@ -0,0 +1,155 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include "pipeline.h"
+#include "spsc_ring.h"
+#include "workload.h"
+
+// Records go from the decoder to the simulation in batches, so the ring is touched once per batch
+#define RECORD_BATCH 256
+#define RECORD_RING_SLOTS 64
+#define ROW_RING_SLOTS 1024
+
+typedef struct {
+    int count;
+    bool last; // No batch follows this one
+    int records[RECORD_BATCH * 2]; // (pid, address) pairs
+} RecordBatch;
+
+typedef struct {
+    FILE *input;
+    int trace_len;
+    int num_procs;
+    SpscRing records; // Decoder -> simulation
+    SpscRing rows;    // Simulation -> renderer
+} Pipeline;
+
+// Reads up to trace_len records, like load_workload_text() would.
+static void *decoder_stage(void *arg) {
+    Pipeline *pipeline = (Pipeline *)arg;
+    int remaining = pipeline->trace_len;
+    bool last = false;
+    while (!last) {
+        RecordBatch *batch = (RecordBatch *)ring_reserve(&pipeline->records);
+        batch->count = 0;
+        while (batch->count < RECORD_BATCH && remaining > 0 &&
+               read_trace_record(pipeline->input, &batch->records[2 * batch->count], &batch->records[2 * batch->count + 1])) {
+            batch->count++;
+            remaining--;
+        }
+        last = batch->count < RECORD_BATCH || remaining == 0;
+        batch->last = last;
+        ring_publish(&pipeline->records);
+    }
+    return NULL;
+}
+
+// Prints the rows as they arrive. It is the only thread writing to stdout during the run.
+static void *renderer_stage(void *arg) {
+    Pipeline *pipeline = (Pipeline *)arg;
+    bool sigsegv_printed[MAX_PROCESSES] = {false};
+    while (true) {
+        const StateSnapshot *row = (const StateSnapshot *)ring_peek(&pipeline->rows);
+        if (row->time == -1) {
+            ring_release(&pipeline->rows);
+            break;
+        }
+        print_frame_row(row->time, pipeline->num_procs, row->process_id, row->page_number, row->terminated, sigsegv_printed);
+        ring_release(&pipeline->rows);
+    }
+    fflush(stdout);
+    return NULL;
+}
+
+// Simulation side reader of the record batches
+typedef struct {
+    SpscRing *ring;
+    const RecordBatch *batch;
+    int index;
+} RecordReader;
+
+static bool next_record(RecordReader *reader, int *pid, int *address) {
+    while (true) {
+        if (reader->batch == NULL) {
+            reader->batch = (const RecordBatch *)ring_peek(reader->ring);
+            reader->index = 0;
+        }
+        if (reader->index < reader->batch->count) {
+            *pid = reader->batch->records[2 * reader->index];
+            *address = reader->batch->records[2 * reader->index + 1];
+            reader->index++;
+            return true;
+        }
+        if (reader->batch->last) {
+            return false; // The batch stays in the ring, the decoder has finished anyway
+        }
+        ring_release(reader->ring);
+        reader->batch = NULL;
+    }
+}
+
+// Releases batches until the decoder has published its last one, so it is not left waiting for room
+static void drain_records(RecordReader *reader) {
+    while (reader->batch == NULL || !reader->batch->last) {
+        if (reader->batch != NULL) {
+            ring_release(reader->ring);
+        }
+        reader->batch = (const RecordBatch *)ring_peek(reader->ring);
+    }
+}
+
+static void publish_row(Pipeline *pipeline, int time) {
+    StateSnapshot *row = (StateSnapshot *)ring_reserve(&pipeline->rows);
+    capture_state(time, pipeline->num_procs, row);
+    row->time = time;
+    ring_publish(&pipeline->rows);
+}
+
+bool run_pipelined_trace(FILE *input, ReplacementAlgo algo, int num_procs, const int mem_sizes[], int trace_len) {
+    Pipeline pipeline = { .input = input, .trace_len = trace_len, .num_procs = num_procs };
+    if (!ring_init(&pipeline.records, RECORD_RING_SLOTS, sizeof(RecordBatch)) ||
+        !ring_init(&pipeline.rows, ROW_RING_SLOTS, sizeof(StateSnapshot))) {
+        ring_destroy(&pipeline.records);
+        ring_destroy(&pipeline.rows);
+        return false;
+    }
+    fflush(stdout); // Anything printed before (the header) goes out ahead of the renderer's rows
+
+    pthread_t decoder, renderer;
+    RecordReader reader = { &pipeline.records, NULL, 0 };
+    bool started = pthread_create(&decoder, NULL, decoder_stage, &pipeline) == 0;
+    if (started && pthread_create(&renderer, NULL, renderer_stage, &pipeline) != 0) {
+        drain_records(&reader);
+        pthread_join(decoder, NULL);
+        started = false;
+    }
+    if (!started) {
+        ring_destroy(&pipeline.records);
+        ring_destroy(&pipeline.rows);
+        return false;
+    }
+
+    // The same steps as the general loop of run_simulation_logic(), fed from the decoder
+    initialize_simulation(num_procs, mem_sizes);
+    int first[2];
+    if (next_record(&reader, &first[0], &first[1])) {
+        load_first_access(num_procs, first, 1);
+        for (int time_step = 0; ; time_step++) {
+            publish_row(&pipeline, time_step);
+            int pid, address;
+            if (!next_record(&reader, &pid, &address) || pid == 0) {
+                break;
+            }
+            simulate_access(algo, num_procs, pid, address, time_step + 1);
+        }
+    }
+    publish_row(&pipeline, -1);
+    free_page_tables(num_procs);
+
+    // A trace stopped by a pid 0 leaves batches behind
+    drain_records(&reader);
+    pthread_join(decoder, NULL);
+    pthread_join(renderer, NULL);
+    ring_destroy(&pipeline.records);
+    ring_destroy(&pipeline.rows);
+    return true;
+}
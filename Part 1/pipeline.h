@@ -0,0 +1,14 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "p1_simulator.h"
+
+// Replays the records of a text trace (positioned after its header) with one policy on three threads:
+// a decoder reading the records, the simulation on the calling thread, and a renderer printing the table.
+// The table written to stdout is the same as print_header() callers get from run_simulation_logic().
+// Returns false, with nothing simulated, when the buffers cannot be allocated or a thread cannot start.
+bool run_pipelined_trace(FILE *input, ReplacementAlgo algo, int num_procs, const int mem_sizes[], int trace_len);
+
+#endif
@@ -0,0 +1,51 @@
+#include <stdlib.h>
+#include <sched.h>
+#include "spsc_ring.h"
+
+bool ring_init(SpscRing *ring, size_t capacity, size_t slot_size) {
+    // Round up to a power of two so positions map to slots with a mask
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    ring->slots = (unsigned char *)malloc(rounded * slot_size);
+    ring->slot_size = slot_size;
+    ring->capacity = rounded;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    return ring->slots != NULL;
+}
+
+void ring_destroy(SpscRing *ring) {
+    free(ring->slots);
+    ring->slots = NULL;
+}
+
+// Waits for a free slot and returns it. Nothing is visible to the consumer before ring_publish().
+void *ring_reserve(SpscRing *ring) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    while (tail - atomic_load_explicit(&ring->head, memory_order_acquire) == ring->capacity) {
+        sched_yield(); // Full: the consumer is behind
+    }
+    return ring->slots + (tail & (ring->capacity - 1)) * ring->slot_size;
+}
+
+void ring_publish(SpscRing *ring) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+// Waits for a published slot and returns the oldest one.
+const void *ring_peek(SpscRing *ring) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    while (atomic_load_explicit(&ring->tail, memory_order_acquire) == head) {
+        sched_yield(); // Empty: the producer is behind
+    }
+    return ring->slots + (head & (ring->capacity - 1)) * ring->slot_size;
+}
+
+// Hands the slot returned by ring_peek() back to the producer.
+void ring_release(SpscRing *ring) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
@@ -0,0 +1,30 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Lock-free ring of fixed-size slots between exactly one producer thread and one consumer thread.
+// Slots are filled and read in place: the producer reserves a slot, writes it and publishes it,
+// the consumer peeks at the oldest slot and releases it when done. Both sides wait by yielding.
+typedef struct {
+    unsigned char *slots;
+    size_t slot_size;
+    size_t capacity;                    // Power of two
+    _Alignas(64) atomic_size_t head;    // Next slot to read, only written by the consumer
+    _Alignas(64) atomic_size_t tail;    // Next slot to write, only written by the producer
+} SpscRing;
+
+bool ring_init(SpscRing *ring, size_t capacity, size_t slot_size);
+void ring_destroy(SpscRing *ring);
+
+// Producer side
+void *ring_reserve(SpscRing *ring);
+void ring_publish(SpscRing *ring);
+
+// Consumer side
+const void *ring_peek(SpscRing *ring);
+void ring_release(SpscRing *ring);
+
+#endif
@@ -0,0 +1,266 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "p1_simulator.h"
+#include "workload.h"
+
+// --- Random Numbers ---
+// A small xorshift generator so the same seed gives the same trace on every platform.
+
+static unsigned long long rng_state;
+
+static void seed_random(unsigned long seed) {
+    rng_state = (unsigned long long)seed * 0x9E3779B97F4A7C15ULL + 1;
+}
+
+static unsigned long long next_random(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+// Uniform number in [0, 1)
+static double random_unit(void) {
+    return (next_random() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Uniform integer in [0, n)
+static int random_below(int n) {
+    return (int)(next_random() % (unsigned long long)n);
+}
+
+// --- Per-process Generator State ---
+
+typedef struct {
+    int pages;
+    int cursor;      // Next page for the sequential and loop models
+    double *cdf;     // Cumulative Zipf probabilities by rank
+    int *rank_page;  // Page that holds each popularity rank
+} ProcessStream;
+
+static bool setup_stream(ProcessStream *stream, const WorkloadSpec *spec, int memory_size) {
+    memset(stream, 0, sizeof(*stream));
+    stream->pages = (memory_size + PAGE_SIZE - 1) / PAGE_SIZE;
+    if (stream->pages < 1) stream->pages = 1;
+    if (spec->model != MODEL_ZIPF && spec->model != MODEL_PHASES) {
+        return true;
+    }
+
+    stream->cdf = (double *)malloc(stream->pages * sizeof(double));
+    stream->rank_page = (int *)malloc(stream->pages * sizeof(int));
+    if (!stream->cdf || !stream->rank_page) return false;
+
+    double total = 0.0;
+    for (int rank = 0; rank < stream->pages; rank++) {
+        total += 1.0 / pow(rank + 1, spec->zipf_exponent);
+        stream->cdf[rank] = total;
+        stream->rank_page[rank] = rank;
+    }
+    for (int rank = 0; rank < stream->pages; rank++) {
+        stream->cdf[rank] /= total;
+    }
+    // Scatter the hot pages over the address space
+    for (int i = stream->pages - 1; i > 0; i--) {
+        int j = random_below(i + 1);
+        int temp = stream->rank_page[i];
+        stream->rank_page[i] = stream->rank_page[j];
+        stream->rank_page[j] = temp;
+    }
+    return true;
+}
+
+static int zipf_page(const ProcessStream *stream) {
+    double u = random_unit();
+    int low = 0, high = stream->pages - 1;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (stream->cdf[mid] < u) low = mid + 1; else high = mid;
+    }
+    return stream->rank_page[low];
+}
+
+static int next_page(ProcessStream *stream, const WorkloadSpec *spec, int access_index) {
+    switch (spec->model) {
+        case MODEL_ZIPF:
+            return zipf_page(stream);
+        case MODEL_SEQUENTIAL: {
+            int page = stream->cursor;
+            stream->cursor = (stream->cursor + 1) % stream->pages;
+            return page;
+        }
+        case MODEL_LOOP: {
+            int loop = spec->loop_pages < stream->pages ? spec->loop_pages : stream->pages;
+            if (loop < 1) loop = 1;
+            int page = stream->cursor % loop;
+            stream->cursor = (page + 1) % loop;
+            return page;
+        }
+        case MODEL_PHASES: {
+            // Every phase moves the whole hot set by a third of the address space
+            int phase = spec->phase_length > 0 ? access_index / spec->phase_length : 0;
+            int shift = phase * (stream->pages / 3 + 1);
+            return (zipf_page(stream) + shift) % stream->pages;
+        }
+        case MODEL_UNIFORM:
+        default:
+            return random_below(stream->pages);
+    }
+}
+
+// --- Generation ---
+
+WorkloadSpec default_workload_spec(void) {
+    WorkloadSpec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.model = MODEL_ZIPF;
+    spec.num_procs = 5;
+    spec.trace_len = 1000;
+    spec.seed = 1;
+    spec.min_memory = 2000;
+    spec.max_memory = 12000;
+    spec.zipf_exponent = 1.0;
+    spec.loop_pages = 3;
+    spec.phase_length = 100;
+    spec.burst_length = 1;
+    spec.segfault_rate = 0.0;
+    return spec;
+}
+
+bool generate_workload(const WorkloadSpec *spec, Workload *workload) {
+    if (spec->num_procs < 1 || spec->trace_len < 0 || spec->min_memory < 1 || spec->max_memory < spec->min_memory) {
+        return false;
+    }
+    seed_random(spec->seed);
+
+    workload->num_procs = spec->num_procs;
+    workload->trace_len = spec->trace_len;
+    workload->mem_sizes = (int *)malloc(spec->num_procs * sizeof(int));
+    // One extra pair as a terminator, since the simulator peeks one pair past the end
+    workload->exec_trace = (int *)calloc((size_t)spec->trace_len * 2 + 2, sizeof(int));
+    ProcessStream *streams = (ProcessStream *)calloc(spec->num_procs, sizeof(ProcessStream));
+    if (!workload->mem_sizes || !workload->exec_trace || !streams) {
+        free(streams);
+        free_workload(workload);
+        return false;
+    }
+
+    // Memory sizes come first so every model sees the same processes for a given seed
+    for (int i = 0; i < spec->num_procs; i++) {
+        workload->mem_sizes[i] = spec->min_memory + random_below(spec->max_memory - spec->min_memory + 1);
+    }
+    bool ok = true;
+    for (int i = 0; i < spec->num_procs && ok; i++) {
+        ok = setup_stream(&streams[i], spec, workload->mem_sizes[i]);
+    }
+
+    int burst = spec->burst_length > 0 ? spec->burst_length : 1;
+    int pid = 1;
+    for (int n = 0; n < spec->trace_len && ok; n++) {
+        if (n % burst == 0) {
+            pid = 1 + random_below(spec->num_procs);
+        }
+        int memory_size = workload->mem_sizes[pid - 1];
+        int address;
+        if (spec->segfault_rate > 0.0 && random_unit() < spec->segfault_rate) {
+            address = memory_size + random_below(PAGE_SIZE);
+        } else {
+            int page = next_page(&streams[pid - 1], spec, n);
+            int page_bytes = memory_size - page * PAGE_SIZE;
+            if (page_bytes > PAGE_SIZE) page_bytes = PAGE_SIZE;
+            address = page * PAGE_SIZE + random_below(page_bytes);
+        }
+        workload->exec_trace[2 * n] = pid;
+        workload->exec_trace[2 * n + 1] = address;
+    }
+
+    for (int i = 0; i < spec->num_procs; i++) {
+        free(streams[i].cdf);
+        free(streams[i].rank_page);
+    }
+    free(streams);
+    if (!ok) free_workload(workload);
+    return ok;
+}
+
+void free_workload(Workload *workload) {
+    free(workload->mem_sizes);
+    free(workload->exec_trace);
+    workload->mem_sizes = NULL;
+    workload->exec_trace = NULL;
+    workload->num_procs = 0;
+    workload->trace_len = 0;
+}
+
+// --- Input and Output ---
+
+bool write_workload_text(FILE *file, const Workload *workload) {
+    fprintf(file, "%d %d\n", workload->num_procs, workload->trace_len);
+    for (int i = 0; i < workload->num_procs; i++) {
+        fprintf(file, "%d%c", workload->mem_sizes[i], i == workload->num_procs - 1 ? '\n' : ' ');
+    }
+    for (int n = 0; n < workload->trace_len; n++) {
+        fprintf(file, "%d %d\n", workload->exec_trace[2 * n], workload->exec_trace[2 * n + 1]);
+    }
+    return ferror(file) == 0;
+}
+
+// Writes the arrays in the style of inputs_part1.c, e.g. inputP1MemGen[] and inputP1ExecGen[]
+bool write_workload_c(FILE *file, const Workload *workload, const char *suffix) {
+    fprintf(file, "int inputP1Mem%s[] = {", suffix);
+    for (int i = 0; i < workload->num_procs; i++) {
+        fprintf(file, "%s%d", i == 0 ? "" : ", ", workload->mem_sizes[i]);
+    }
+    fprintf(file, "};\nint inputP1Exec%s[] = {", suffix);
+    for (int n = 0; n < workload->trace_len; n++) {
+        fprintf(file, "%s%s%d, %d", n == 0 ? "" : ",", n % 6 == 0 ? "\n    " : " ",
+                workload->exec_trace[2 * n], workload->exec_trace[2 * n + 1]);
+    }
+    fprintf(file, "};\n");
+    return ferror(file) == 0;
+}
+
+// Reads "num_procs trace_len" and the memory sizes. mem_sizes must hold MAX_PROCESSES values.
+bool read_trace_header(FILE *file, int *num_procs, int *trace_len, int mem_sizes[]) {
+    if (fscanf(file, "%d %d", num_procs, trace_len) != 2 || *num_procs < 1 || *num_procs > MAX_PROCESSES || *trace_len < 0) {
+        return false;
+    }
+    for (int i = 0; i < *num_procs; i++) {
+        if (fscanf(file, "%d", &mem_sizes[i]) != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reads the next "pid address" pair, false at the end of the input or on a malformed record.
+// A pid of 0 ends a trace and pids past num_procs are skipped by the engines, but negative pids
+// are no process at all and are rejected here.
+bool read_trace_record(FILE *file, int *pid, int *address) {
+    return fscanf(file, "%d %d", pid, address) == 2 && *pid >= 0;
+}
+
+bool load_workload_text(FILE *file, Workload *workload) {
+    memset(workload, 0, sizeof(*workload));
+    int num_procs, trace_len;
+    int mem_sizes[MAX_PROCESSES];
+    if (!read_trace_header(file, &num_procs, &trace_len, mem_sizes)) {
+        return false;
+    }
+    workload->num_procs = num_procs;
+    workload->trace_len = trace_len;
+    workload->mem_sizes = (int *)malloc(num_procs * sizeof(int));
+    workload->exec_trace = (int *)calloc((size_t)trace_len * 2 + 2, sizeof(int));
+    if (!workload->mem_sizes || !workload->exec_trace) {
+        free_workload(workload);
+        return false;
+    }
+    memcpy(workload->mem_sizes, mem_sizes, num_procs * sizeof(int));
+    for (int n = 0; n < trace_len * 2; n++) {
+        if (fscanf(file, "%d", &workload->exec_trace[n]) != 1 || (n % 2 == 0 && workload->exec_trace[n] < 0)) {
+            free_workload(workload);
+            return false;
+        }
+    }
+    return true;
+}
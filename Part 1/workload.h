@@ -0,0 +1,53 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+// Page access models for generated traces
+typedef enum {
+    MODEL_UNIFORM,    // Any page of the process with the same probability
+    MODEL_ZIPF,       // A small hot set of pages takes most of the accesses
+    MODEL_SEQUENTIAL, // Each process scans its address space page after page
+    MODEL_LOOP,       // Each process cycles over its first loop_pages pages
+    MODEL_PHASES      // Zipfian hot set that moves to other pages every phase_length accesses
+} AccessModel;
+
+typedef struct {
+    AccessModel model;
+    int num_procs;
+    int trace_len;        // Number of (pid, address) pairs
+    unsigned long seed;
+    int min_memory;       // Range of the process memory sizes in bytes
+    int max_memory;
+    double zipf_exponent;
+    int loop_pages;
+    int phase_length;
+    int burst_length;     // Accesses a process makes in a row before another one is picked
+    double segfault_rate; // Fraction of accesses that fall outside the process's memory
+} WorkloadSpec;
+
+// A trace in the same layout as the arrays in inputs_part1.c
+typedef struct {
+    int num_procs;
+    int *mem_sizes;
+    int *exec_trace; // trace_len (pid, address) pairs followed by a (0, 0) terminator
+    int trace_len;
+} Workload;
+
+WorkloadSpec default_workload_spec(void);
+bool generate_workload(const WorkloadSpec *spec, Workload *workload);
+void free_workload(Workload *workload);
+
+// Text format: "num_procs trace_len", the memory sizes, then one "pid address" pair per access.
+// Records with a negative pid make the trace invalid.
+bool write_workload_text(FILE *file, const Workload *workload);
+bool write_workload_c(FILE *file, const Workload *workload, const char *suffix);
+bool load_workload_text(FILE *file, Workload *workload);
+
+// Record by record reading of the same format, for streams whose length is not known in advance.
+// The input ends at the first record that cannot be read.
+bool read_trace_header(FILE *file, int *num_procs, int *trace_len, int mem_sizes[]);
+bool read_trace_record(FILE *file, int *pid, int *address);
+
+#endif
@@ -0,0 +1,89 @@
+#include <stdlib.h>
+#include <string.h>
+#include "zswap.h"
+
+bool zswap_init(ZswapPool *pool, int frames, double ratio, int load_latency, int store_latency) {
+    memset(pool, 0, sizeof(ZswapPool));
+    pool->frames = frames;
+    pool->ratio = ratio;
+    pool->capacity = (int)(frames * ratio);
+    pool->load_latency = load_latency;
+    pool->store_latency = store_latency;
+    if (pool->capacity < 1) return false;
+    pool->entries = (ZswapEntry *)malloc(pool->capacity * sizeof(ZswapEntry));
+    return pool->entries != NULL;
+}
+
+void zswap_destroy(ZswapPool *pool) {
+    free(pool->entries);
+    memset(pool, 0, sizeof(ZswapPool));
+}
+
+static void remove_entry(ZswapPool *pool, int index) {
+    memmove(&pool->entries[index], &pool->entries[index + 1], (pool->count - index - 1) * sizeof(ZswapEntry));
+    pool->count--;
+}
+
+void zswap_store(ZswapPool *pool, int pid, int page) {
+    if (pool->capacity < 1) return;
+    if (pool->count == pool->capacity) {
+        remove_entry(pool, 0);
+        pool->writebacks++;
+    }
+    pool->entries[pool->count++] = (ZswapEntry){pid, page};
+    pool->stores++;
+    if (pool->count > pool->peak) pool->peak = pool->count;
+}
+
+static int find_entry(const ZswapPool *pool, int pid, int page) {
+    for (int i = 0; i < pool->count; i++) {
+        if (pool->entries[i].pid == pid && pool->entries[i].page == page) return i;
+    }
+    return -1;
+}
+
+bool zswap_load(ZswapPool *pool, int pid, int page) {
+    int index = find_entry(pool, pid, page);
+    if (index == -1) {
+        pool->misses++;
+        return false;
+    }
+    remove_entry(pool, index);
+    pool->hits++;
+    return true;
+}
+
+void zswap_forget(ZswapPool *pool, int pid, int page) {
+    int index = find_entry(pool, pid, page);
+    if (index != -1) remove_entry(pool, index);
+}
+
+void zswap_drop_process(ZswapPool *pool, int pid) {
+    int kept = 0;
+    for (int i = 0; i < pool->count; i++) {
+        if (pool->entries[i].pid != pid) pool->entries[kept++] = pool->entries[i];
+    }
+    pool->count = kept;
+}
+
+double zswap_fault_latency(const ZswapPool *pool) {
+    long long faults = pool->hits + pool->misses;
+    double total = (double)pool->hits * pool->load_latency + (double)pool->misses * pool->store_latency;
+    return faults > 0 ? total / faults : 0.0;
+}
+
+void zswap_print_stats(const ZswapPool *pool, int total_frames, FILE *out) {
+    // Pages memory can keep without going to the store: the frames left to pages plus the pool contents
+    int effective = total_frames - pool->frames + pool->capacity;
+    long long faults = pool->hits + pool->misses;
+    fprintf(out, "%-26s %d frames, %d pages at %.1f:1\n", "zswap pool", pool->frames, pool->capacity, pool->ratio);
+    fprintf(out, "%-26s %d pages (%+.0f%%)\n", "effective capacity", effective,
+            total_frames > 0 ? 100.0 * (effective - total_frames) / total_frames : 0.0);
+    fprintf(out, "%-26s %lld\n", "pages compressed", pool->stores);
+    fprintf(out, "%-26s %lld\n", "pool hits", pool->hits);
+    fprintf(out, "%-26s %lld\n", "backing store reads", pool->misses);
+    fprintf(out, "%-26s %lld\n", "writebacks", pool->writebacks);
+    fprintf(out, "%-26s %d\n", "peak pool pages", pool->peak);
+    fprintf(out, "%-26s %.1f%%\n", "pool hit rate", faults > 0 ? 100.0 * pool->hits / faults : 0.0);
+    fprintf(out, "%-26s %.1f us\n", "average fault latency", zswap_fault_latency(pool) / 1000.0);
+}
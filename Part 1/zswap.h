@@ -0,0 +1,50 @@
+#ifndef ZSWAP_H
+#define ZSWAP_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+// Compressed swap cache in front of the backing store, like Linux zswap. A few physical frames are
+// given to a pool that holds evicted pages compressed. A fault on a page still in the pool only pays
+// for the decompression; the pool keeps its pages oldest first and writes the oldest one back to the
+// store when a new page does not fit.
+
+typedef struct {
+    int pid;
+    int page;
+} ZswapEntry;
+
+typedef struct {
+    int frames;           // Physical frames taken by the pool
+    double ratio;         // Compressed pages per frame
+    int capacity;         // Compressed pages the pool holds
+    int count;
+    ZswapEntry *entries;  // Oldest first
+    int load_latency;     // Nanoseconds to decompress a page
+    int store_latency;    // Nanoseconds to read a page from the backing store
+
+    long long stores;     // Evicted pages compressed into the pool
+    long long hits;       // Faults served from the pool
+    long long misses;     // Faults read from the backing store
+    long long writebacks; // Pages pushed out to the backing store to make room
+    int peak;             // Most compressed pages held at once
+} ZswapPool;
+
+bool zswap_init(ZswapPool *pool, int frames, double ratio, int load_latency, int store_latency);
+void zswap_destroy(ZswapPool *pool);
+
+// Compresses an evicted page into the pool
+void zswap_store(ZswapPool *pool, int pid, int page);
+// Looks up a faulting page. Returns true, and takes the page out of the pool, when it was there.
+bool zswap_load(ZswapPool *pool, int pid, int page);
+// Forgets a page read from the backing store some other way (by the prefetcher)
+void zswap_forget(ZswapPool *pool, int pid, int page);
+// Forgets the pages of a process that has ended
+void zswap_drop_process(ZswapPool *pool, int pid);
+
+// Average time of one fault in nanoseconds
+double zswap_fault_latency(const ZswapPool *pool);
+// total_frames is the whole memory, pool included, to report the capacity gained
+void zswap_print_stats(const ZswapPool *pool, int total_frames, FILE *out);
+
+#endif // ZSWAP_H
@@ -0,0 +1,220 @@
+#include <time.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+#include "p2_simulator.h"
+#include "workload.h"
+
+#ifdef _WIN32
+    #define NULL_DEVICE "NUL"
+#else
+    #define NULL_DEVICE "/dev/null"
+#endif
+
+// --- Allocation Counting ---
+// The bench target links with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc so every allocation
+// made by the simulator passes through these counters.
+
+long allocation_count = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    allocation_count++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    allocation_count++;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size) {
+    allocation_count++;
+    return __real_realloc(pointer, size);
+}
+
+// --- Measurements ---
+
+double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+long peak_rss_kb(void) {
+#ifndef _WIN32
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Instruction mixes that are benchmarked (weights of LOAD/STORE, JUMP, EXEC, BLOCK)
+typedef struct {
+    const char *name;
+    int load, jump, exec, block;
+} BenchMix;
+
+// Writes a generated program store of num_programs programs of the given length to a temporary file
+// and times program_store_load() on it, median of the repeats
+void bench_store_load(int num_programs, int length, int repeats) {
+    ProgramSpec spec = default_program_spec();
+    spec.num_programs = num_programs;
+    spec.length = length;
+    spec.seed = 42;
+    ProgramStore programs;
+    FILE *file = tmpfile();
+    if (file == NULL || !generate_program_store(&spec, &programs) || !program_store_write(file, &programs)) {
+        fprintf(stderr, "Could not write the program store\n");
+        if (file != NULL) fclose(file);
+        return;
+    }
+    long bytes = ftell(file);
+    program_store_destroy(&programs);
+
+    double *times = (double *)malloc(repeats * sizeof(double));
+    bool loaded = true;
+    for (int r = 0; loaded && r < repeats; r++) {
+        rewind(file);
+        double start = now_seconds();
+        loaded = program_store_load(file, &programs);
+        times[r] = now_seconds() - start;
+        program_store_destroy(&programs);
+    }
+    fclose(file);
+    if (loaded) {
+        qsort(times, repeats, sizeof(double), compare_doubles);
+        double median = times[repeats / 2];
+        fprintf(stderr, "program store load: %d programs, %ld instructions, %.1f MB in %.1f ms (%.0f instructions/sec)\n",
+                num_programs, (long)num_programs * length, bytes / 1e6, median * 1e3,
+                median > 0 ? (double)num_programs * length / median : 0.0);
+    } else {
+        fprintf(stderr, "Could not load the program store\n");
+    }
+    free(times);
+}
+
+void print_usage(const char *program_name) {
+    fprintf(stderr, "Usage: %s [options]\n", program_name);
+    fprintf(stderr, "  --runs N       Simulations per timed repeat (default 2000)\n");
+    fprintf(stderr, "  --length N     Instructions per generated program (default 40)\n");
+    fprintf(stderr, "  --repeats N    Timed repeats per case (default 5)\n");
+    fprintf(stderr, "  --label TEXT   Value of the label column, e.g. a commit id\n");
+    fprintf(stderr, "  --csv FILE     Results file (default bench_part2.csv)\n");
+}
+
+int main(int argc, char *argv[]) {
+    int runs = 2000;
+    int length = 40;
+    int repeats = 5;
+    const char *label = "local";
+    const char *csv_path = "bench_part2.csv";
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--runs") == 0) runs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--length") == 0) length = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--repeats") == 0) repeats = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--label") == 0) label = argv[++i];
+        else if (strcmp(argv[i], "--csv") == 0) csv_path = argv[++i];
+        else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (runs < 1 || repeats < 1 || length < 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    BenchMix mixes[] = {
+        {"memory", 85, 5, 5, 5},
+        {"balanced", 60, 10, 10, 20},
+        {"io", 40, 5, 10, 45},
+        {"spawn", 50, 10, 30, 10}
+    };
+    int num_mixes = sizeof(mixes) / sizeof(mixes[0]);
+
+    FILE *csv = fopen(csv_path, "w");
+    if (csv == NULL) {
+        perror("Error opening results file");
+        return 1;
+    }
+    fprintf(csv, "label,mix,runs,repeats,median_sec,min_sec,ticks,ticks_per_sec,accesses_per_sec,page_faults,ns_per_fault,peak_rss_kb,allocs_per_tick\n");
+    fprintf(stderr, "%-10s %14s %14s %12s %10s %12s\n", "mix", "ticks/sec", "accesses/sec", "ns/fault", "rss KB", "allocs/tick");
+
+    // The state tables go to the null device, so formatting is measured but not disk writes
+    if (freopen(NULL_DEVICE, "w", stdout) == NULL) {
+        perror("Error opening the null device");
+        fclose(csv);
+        return 1;
+    }
+
+    double *times = (double *)malloc(repeats * sizeof(double));
+    for (int m = 0; m < num_mixes; m++) {
+        ProgramSpec spec = default_program_spec();
+        spec.length = length;
+        spec.load_weight = mixes[m].load;
+        spec.jump_weight = mixes[m].jump;
+        spec.exec_weight = mixes[m].exec;
+        spec.block_weight = mixes[m].block;
+        spec.seed = 42;
+        SimulationInput input;
+        if (!generate_programs(&spec, &input)) {
+            fprintf(stderr, "Could not generate programs for %s\n", mixes[m].name);
+            continue;
+        }
+
+        long ticks = 0, accesses = 0, faults = 0, allocations = 0;
+        for (int r = 0; r < repeats; r++) {
+            ticks = accesses = faults = allocations = 0;
+            double elapsed = 0.0;
+            for (int run = 0; run < runs; run++) {
+                SimulationSystem system;
+                initialize_system_with_input(&system, input);
+                long allocations_before = allocation_count;
+                double start = now_seconds();
+                run_simulation(&system);
+                elapsed += now_seconds() - start;
+                allocations += allocation_count - allocations_before;
+                ticks += system.current_time;
+                accesses += system.stats.memory_accesses;
+                faults += system.stats.page_faults;
+                destroy_system(&system);
+            }
+            times[r] = elapsed;
+        }
+
+        qsort(times, repeats, sizeof(double), compare_doubles);
+        double median = times[repeats / 2];
+        double ticks_per_sec = median > 0 ? ticks / median : 0.0;
+        double accesses_per_sec = median > 0 ? accesses / median : 0.0;
+        double ns_per_fault = faults > 0 ? median * 1e9 / faults : 0.0;
+        double allocs_per_tick = ticks > 0 ? (double)allocations / ticks : 0.0;
+        long rss = peak_rss_kb();
+
+        fprintf(csv, "%s,%s,%d,%d,%.6f,%.6f,%ld,%.0f,%.0f,%ld,%.1f,%ld,%.4f\n", label, mixes[m].name, runs, repeats,
+                median, times[0], ticks, ticks_per_sec, accesses_per_sec, faults, ns_per_fault, rss, allocs_per_tick);
+        fprintf(stderr, "%-10s %14.0f %14.0f %12.1f %10ld %12.4f\n", mixes[m].name, ticks_per_sec,
+                accesses_per_sec, ns_per_fault, rss, allocs_per_tick);
+        free(input.programs);
+    }
+    free(times);
+    fclose(csv);
+    bench_store_load(1000, 1000, repeats);
+    fprintf(stderr, "Results written to %s\n", csv_path);
+    return 0;
+}
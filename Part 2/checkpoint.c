@@ -0,0 +1,513 @@
+#include "checkpoint.h"
+
+// File layout, all values as native ints:
+//   magic, version, MAX_FRAMES, MAX_PROCESSES, MAX_PROGRAM_INSTRUCTIONS
+//   configuration (settings, then the cache levels), counters, clock and creation state, programs, the config.num_frames frames (with their sharers)
+//   the programs are their count and total length, the memory sizes, the starts, then every instruction
+//   under contiguous allocation, the allocator's next-fit address, counters and blocks
+//   with the I/O model, the device settings and every device's queue, slots and counters
+//   with synchronization, every mutex and semaphore with its wait queue
+//   with real-time scheduling, the ready heap (length, tie breaker, entries)
+//   with caches, the hierarchy's state and every level's lines, the access counters as native long longs
+//   with background reclaim, whether the daemon is awake and the pages it evicted
+//   every live PCB (slot number, fields, instructions, page reference times), then -1
+//   every queue as its length followed by pids, then the running and preempted pids (0 = none)
+// Queues only point at PCBs of system->processes, so they are rebuilt from the pids.
+
+#define CHECKPOINT_MAGIC 0x4B433250 // "P2CK"
+#define CHECKPOINT_VERSION 11
+
+_Static_assert(sizeof(SimulationStats) % sizeof(int) == 0, "SimulationStats must only hold int counters");
+_Static_assert(sizeof(AllocatorStats) % sizeof(int) == 0, "AllocatorStats must only hold int counters");
+_Static_assert(sizeof(Partition) == 4 * sizeof(int), "Partition must be four ints");
+_Static_assert(sizeof(DeviceConfig) % sizeof(int) == 0 && sizeof(Device) % sizeof(int) == 0, "Devices must be stored as ints");
+_Static_assert(sizeof(SyncObject) % sizeof(int) == 0, "SyncObject must only hold ints");
+_Static_assert(sizeof(ReadyEntry) == 3 * sizeof(int), "ReadyEntry must be three ints");
+_Static_assert(sizeof(CacheLevelConfig) == 4 * sizeof(int), "CacheLevelConfig must be four ints");
+
+// The messages a PCB can carry, stored by their position (0 = no message)
+static const char *const error_names[] = {"SIGSEGV", "SIGILL", "SIGEOF"};
+#define NUM_ERROR_NAMES (int)(sizeof(error_names) / sizeof(error_names[0]))
+
+static bool write_ints(FILE *file, const int *values, size_t count) {
+    return fwrite(values, sizeof(int), count, file) == count;
+}
+
+static bool read_ints(FILE *file, int *values, size_t count) {
+    return fread(values, sizeof(int), count, file) == count;
+}
+
+static bool write_longs(FILE *file, const long long *values, size_t count) {
+    return fwrite(values, sizeof(long long), count, file) == count;
+}
+
+static bool read_longs(FILE *file, long long *values, size_t count) {
+    return fread(values, sizeof(long long), count, file) == count;
+}
+
+static bool write_int(FILE *file, int value) {
+    return write_ints(file, &value, 1);
+}
+
+static bool read_int(FILE *file, int *value) {
+    return read_ints(file, value, 1);
+}
+
+static bool read_bool(FILE *file, bool *value) {
+    int stored;
+    if (!read_int(file, &stored)) return false;
+    *value = stored != 0;
+    return true;
+}
+
+static int error_code(const char *message) {
+    if (message == NULL) return 0;
+    for (int i = 0; i < NUM_ERROR_NAMES; i++) {
+        if (strcmp(message, error_names[i]) == 0) return i + 1;
+    }
+    return -1;
+}
+
+static bool write_queue(FILE *file, Queue *queue) {
+    bool ok = write_int(file, (int)queueSize(queue));
+    for (size_t i = 0; ok && i < queueSize(queue); i++) {
+        ok = write_int(file, ((PCB *)getQueueNodeAt(queue, i))->pid);
+    }
+    return ok;
+}
+
+// Maps a stored pid back to its PCB. pid 0 stands for no process.
+static bool pcb_of(SimulationSystem *system, int pid, PCB **proc) {
+    *proc = NULL;
+    if (pid == 0) return true;
+    if (pid < 1 || pid > MAX_PROCESSES || system->processes[pid - 1] == NULL) return false;
+    *proc = system->processes[pid - 1];
+    return true;
+}
+
+static bool read_queue(FILE *file, SimulationSystem *system, Queue *queue) {
+    int length;
+    if (!read_int(file, &length) || length < 0 || length > MAX_PROCESSES) return false;
+    for (int i = 0; i < length; i++) {
+        int pid;
+        PCB *proc;
+        if (!read_int(file, &pid) || pid == 0 || !pcb_of(system, pid, &proc)) return false;
+        enqueue(queue, proc);
+    }
+    return true;
+}
+
+// Starts must run from 0 to the total without going back, so every program lies inside the instructions
+static bool read_programs(FILE *file, ProgramStore *programs) {
+    int num_programs, num_instructions;
+    if (!read_int(file, &num_programs) || !read_int(file, &num_instructions) || num_programs < 1 ||
+        num_instructions < 0 || !program_store_reserve(programs, num_programs, num_instructions) ||
+        !read_ints(file, programs->mem_sizes, num_programs) || !read_ints(file, programs->starts, num_programs + 1) ||
+        !read_ints(file, programs->instructions, num_instructions)) {
+        return false;
+    }
+    programs->num_programs = num_programs;
+    if (programs->starts[0] != 0 || programs->starts[num_programs] != num_instructions) return false;
+    for (int p = 0; p < num_programs; p++) {
+        if (programs->starts[p + 1] < programs->starts[p]) return false;
+    }
+    return true;
+}
+
+static bool write_pcb(FILE *file, const PCB *proc) {
+    int code = error_code(proc->error_message);
+    int fields[] = {
+        proc->pid, proc->program_id, (int)proc->state, code, proc->pc, proc->time_in_state,
+        proc->remaining_quantum, proc->blocked_until, proc->memory_size, proc->instruction_count,
+        proc->last_page, proc->stride, proc->stride_confirmed, proc->page_count, proc->suspended_ws,
+        proc->priority, proc->effective_priority, proc->waiting_on, proc->wait_start,
+        proc->period, proc->relative_deadline, proc->release, proc->deadline
+    };
+    return code >= 0 && write_ints(file, fields, sizeof(fields) / sizeof(fields[0])) &&
+           write_ints(file, proc->instructions, proc->instruction_count) &&
+           write_ints(file, proc->page_last_ref, proc->page_count);
+}
+
+// A PCB holds a copy of its program, so it can be no longer than that program
+static PCB *read_pcb(FILE *file, const ProgramStore *programs) {
+    int fields[23];
+    if (!read_ints(file, fields, 23)) return NULL;
+    int code = fields[3];
+    // The pc of a real-time job waiting for its release is -1
+    if (code < 0 || code > NUM_ERROR_NAMES || fields[1] < 0 || fields[1] >= programs->num_programs ||
+        fields[9] < 0 || fields[9] > program_length(programs, fields[1]) || fields[4] < -1 || fields[4] > fields[9] ||
+        fields[8] < 0 || fields[13] != fields[8] / PAGE_SIZE + 1 ||
+        fields[17] < -1 || fields[17] >= NUM_MUTEXES + NUM_SEMAPHORES) {
+        return NULL;
+    }
+    PCB *proc = (PCB *)calloc(1, sizeof(PCB));
+    if (!proc) return NULL;
+    proc->pid = fields[0];
+    proc->program_id = fields[1];
+    proc->state = (ProcessState)fields[2];
+    proc->error_message = code == 0 ? NULL : error_names[code - 1];
+    proc->pc = fields[4];
+    proc->time_in_state = fields[5];
+    proc->remaining_quantum = fields[6];
+    proc->blocked_until = fields[7];
+    proc->memory_size = fields[8];
+    proc->instruction_count = fields[9];
+    proc->last_page = fields[10];
+    proc->stride = fields[11];
+    proc->stride_confirmed = fields[12] != 0;
+    proc->page_count = fields[13];
+    proc->suspended_ws = fields[14];
+    proc->priority = fields[15];
+    proc->effective_priority = fields[16];
+    proc->waiting_on = fields[17];
+    proc->wait_start = fields[18];
+    proc->period = fields[19];
+    proc->relative_deadline = fields[20];
+    proc->release = fields[21];
+    proc->deadline = fields[22];
+    // One spare element so an empty program still gets a buffer
+    proc->instructions = (int *)malloc((proc->instruction_count + 1) * sizeof(int));
+    proc->page_last_ref = (int *)calloc(proc->page_count, sizeof(int));
+    if (!proc->instructions || !proc->page_last_ref ||
+        !read_ints(file, proc->instructions, proc->instruction_count) ||
+        !read_ints(file, proc->page_last_ref, proc->page_count)) {
+        free(proc->instructions);
+        free(proc->page_last_ref);
+        free(proc);
+        return NULL;
+    }
+    return proc;
+}
+
+static bool write_cache(FILE *file, const CacheHierarchy *cache) {
+    int state[] = {cache->clock, (int)cache->random_state, cache->last_owner};
+    bool ok = write_ints(file, state, 3) && write_longs(file, &cache->switches, 1) &&
+              write_longs(file, cache->owner_lost, cache->num_owners);
+    for (int l = 0; ok && l < cache->num_levels; l++) {
+        const CacheLevel *level = &cache->levels[l];
+        size_t lines = level->config.size / level->config.line_size;
+        ok = write_longs(file, &level->accesses, 1) && write_longs(file, &level->misses, 1) &&
+             write_ints(file, level->tags, lines) && write_ints(file, level->owners, lines) &&
+             write_ints(file, level->stamps, lines) && write_longs(file, level->owner_accesses, cache->num_owners) &&
+             write_longs(file, level->owner_misses, cache->num_owners);
+    }
+    return ok;
+}
+
+bool save_checkpoint(const SimulationSystem *system, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) return false;
+
+    const SimulationConfig *config = &system->config;
+    int header[] = {CHECKPOINT_MAGIC, CHECKPOINT_VERSION, MAX_FRAMES, MAX_PROCESSES, MAX_PROGRAM_INSTRUCTIONS};
+    int settings[] = {config->num_frames, config->quantum, config->policy, config->prefetch_depth, config->load_control,
+                      config->ws_window, config->suspend_threshold, config->resume_threshold, config->cow_fork,
+                      config->contiguous, config->alloc_strategy, config->compaction,
+                      config->io_model, config->num_devices, config->io_deadline,
+                      config->sync, config->spin_locks, config->priority_inheritance, config->priority_scheduling,
+                      config->semaphore_initial, config->priorities[0], config->priorities[1], config->priorities[2],
+                      config->priorities[3], config->priorities[4], config->rt_policy,
+                      config->periods[0], config->periods[1], config->periods[2], config->periods[3], config->periods[4],
+                      config->deadlines[0], config->deadlines[1], config->deadlines[2], config->deadlines[3],
+                      config->deadlines[4], config->cache, config->num_cache_levels, config->cache_pollution,
+                      config->kswapd, config->low_watermark, config->high_watermark, config->kswapd_batch};
+    int clock_state[] = {system->current_time, system->next_pid, system->will_be_created, system->finished};
+    bool ok = write_ints(file, header, 5) && write_ints(file, settings, 43) &&
+              write_ints(file, (const int *)config->cache_levels, CACHE_LEVELS * 4) &&
+              write_ints(file, (const int *)&system->stats, sizeof(SimulationStats) / sizeof(int)) &&
+              write_ints(file, clock_state, 4);
+    for (int i = 0; ok && i < MAX_PROCESSES; i++) {
+        ok = write_int(file, system->pre_new_printed[i]);
+    }
+    const ProgramStore *programs = &system->programs;
+    int num_instructions = programs->starts[programs->num_programs];
+    ok = ok && write_int(file, programs->num_programs) && write_int(file, num_instructions) &&
+         write_ints(file, programs->mem_sizes, programs->num_programs) &&
+         write_ints(file, programs->starts, programs->num_programs + 1) &&
+         write_ints(file, programs->instructions, num_instructions);
+    for (int i = 0; ok && i < config->num_frames; i++) {
+        const Frame *frame = &system->physical_memory[i];
+        int fields[] = {frame->process_id, frame->page_number, frame->load_time, frame->last_access_time, frame->prefetched,
+                        (int)frame->sharers};
+        ok = write_ints(file, fields, 6);
+    }
+    if (ok && config->contiguous) {
+        const Allocator *allocator = &system->allocator;
+        ok = write_int(file, allocator->next_fit) &&
+             write_ints(file, (const int *)&allocator->stats, sizeof(AllocatorStats) / sizeof(int)) &&
+             write_int(file, allocator->count) &&
+             write_ints(file, (const int *)allocator->blocks, (size_t)allocator->count * 4);
+    }
+    if (ok && config->io_model) {
+        ok = write_ints(file, (const int *)config->devices, config->num_devices * sizeof(DeviceConfig) / sizeof(int)) &&
+             write_ints(file, (const int *)system->devices, config->num_devices * sizeof(Device) / sizeof(int));
+    }
+    if (ok && config->sync) {
+        ok = write_ints(file, (const int *)system->mutexes, NUM_MUTEXES * sizeof(SyncObject) / sizeof(int)) &&
+             write_ints(file, (const int *)system->semaphores, NUM_SEMAPHORES * sizeof(SyncObject) / sizeof(int));
+    }
+    if (ok && config->rt_policy != RT_NONE) {
+        ok = write_int(file, system->ready_count) && write_int(file, system->ready_seq) &&
+             write_ints(file, (const int *)system->ready_heap, (size_t)system->ready_count * 3);
+    }
+    if (ok && config->cache) {
+        ok = write_cache(file, &system->cache);
+    }
+    if (ok && config->kswapd) {
+        ok = write_int(file, system->kswapd_awake) &&
+             write_ints(file, (const int *)system->reclaimed_pages, MAX_PROCESSES);
+    }
+
+    for (int i = 0; ok && i < MAX_PROCESSES; i++) {
+        if (system->processes[i] != NULL) {
+            ok = write_int(file, i) && write_pcb(file, system->processes[i]);
+        }
+    }
+    ok = ok && write_int(file, -1);
+
+    Queue *queues[] = {system->new_queue, system->ready_queue, system->blocked_queue, system->exit_queue, system->suspended_queue};
+    for (int q = 0; ok && q < 5; q++) {
+        ok = write_queue(file, queues[q]);
+    }
+    ok = ok && write_int(file, system->running_process ? system->running_process->pid : 0) &&
+         write_int(file, system->preempted_process ? system->preempted_process->pid : 0);
+
+    if (fclose(file) != 0) ok = false;
+    return ok;
+}
+
+static bool read_allocator(FILE *file, SimulationSystem *system) {
+    Allocator *allocator = &system->allocator;
+    int count;
+    if (!allocator_init(allocator, system->config.alloc_strategy, system->config.num_frames * PAGE_SIZE, system->config.compaction) ||
+        !read_int(file, &allocator->next_fit) ||
+        !read_ints(file, (int *)&allocator->stats, sizeof(AllocatorStats) / sizeof(int)) ||
+        !read_int(file, &count) || count < 0 || count > allocator->capacity) {
+        return false;
+    }
+    free(allocator->blocks);
+    allocator->blocks = (Partition *)malloc((count + 1) * sizeof(Partition));
+    allocator->count = allocator->room = allocator->blocks != NULL ? count : 0;
+    return allocator->blocks != NULL && read_ints(file, (int *)allocator->blocks, (size_t)count * 4);
+}
+
+static bool read_devices(FILE *file, SimulationSystem *system) {
+    int num_devices = system->config.num_devices;
+    if (!read_ints(file, (int *)system->config.devices, num_devices * sizeof(DeviceConfig) / sizeof(int)) ||
+        !read_ints(file, (int *)system->devices, num_devices * sizeof(Device) / sizeof(int))) {
+        return false;
+    }
+    for (int d = 0; d < num_devices; d++) {
+        const DeviceConfig *device = &system->config.devices[d];
+        system->config.devices[d].name[DEVICE_NAME_LENGTH - 1] = '\0';
+        if (device->concurrency < 1 || device->concurrency > MAX_DEVICE_SLOTS || system->devices[d].queued < 0 ||
+            system->devices[d].queued > MAX_DEVICE_SLOTS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool read_sync_objects(FILE *file, SimulationSystem *system) {
+    if (!read_ints(file, (int *)system->mutexes, NUM_MUTEXES * sizeof(SyncObject) / sizeof(int)) ||
+        !read_ints(file, (int *)system->semaphores, NUM_SEMAPHORES * sizeof(SyncObject) / sizeof(int))) {
+        return false;
+    }
+    for (int i = 0; i < NUM_MUTEXES + NUM_SEMAPHORES; i++) {
+        const SyncObject *object = i < NUM_MUTEXES ? &system->mutexes[i] : &system->semaphores[i - NUM_MUTEXES];
+        if (object->num_waiters < 0 || object->num_waiters > MAX_PROCESSES) return false;
+    }
+    return true;
+}
+
+// The hierarchy is rebuilt from the configuration, then its contents are read over the empty lines
+static bool read_cache(FILE *file, SimulationSystem *system) {
+    CacheHierarchy *cache = &system->cache;
+    int state[3];
+    if (!cache_init(cache, system->config.cache_levels, system->config.num_cache_levels, MAX_PROCESSES,
+                    system->config.cache_pollution) ||
+        !read_ints(file, state, 3) || !read_longs(file, &cache->switches, 1) ||
+        !read_longs(file, cache->owner_lost, cache->num_owners)) {
+        return false;
+    }
+    cache->clock = state[0];
+    cache->random_state = (unsigned int)state[1];
+    cache->last_owner = state[2];
+    for (int l = 0; l < cache->num_levels; l++) {
+        CacheLevel *level = &cache->levels[l];
+        size_t lines = level->config.size / level->config.line_size;
+        if (!read_longs(file, &level->accesses, 1) || !read_longs(file, &level->misses, 1) ||
+            !read_ints(file, level->tags, lines) || !read_ints(file, level->owners, lines) ||
+            !read_ints(file, level->stamps, lines) || !read_longs(file, level->owner_accesses, cache->num_owners) ||
+            !read_longs(file, level->owner_misses, cache->num_owners)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Frames name their owner and sharers by pid, so they are checked once the PCBs are read. A used frame
+// belongs to a live process, and only other live processes share it.
+static bool frames_valid(const SimulationSystem *system) {
+    for (int i = 0; i < system->config.num_frames; i++) {
+        const Frame *frame = &system->physical_memory[i];
+        if (frame->process_id == -1) {
+            if (frame->sharers != 0) return false;
+            continue;
+        }
+        if (frame->process_id < 1 || frame->process_id > MAX_PROCESSES ||
+            system->processes[frame->process_id - 1] == NULL || frame->page_number < 0) {
+            return false;
+        }
+        for (int bit = 0; bit < 32; bit++) {
+            if ((frame->sharers & (1u << bit)) != 0 &&
+                (bit >= MAX_PROCESSES || bit + 1 == frame->process_id || system->processes[bit] == NULL)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Heap entries name their process by pid, so they are checked once the PCBs are read
+static bool read_ready_heap(FILE *file, SimulationSystem *system) {
+    return read_int(file, &system->ready_count) && system->ready_count >= 0 && system->ready_count <= MAX_PROCESSES &&
+           read_int(file, &system->ready_seq) &&
+           read_ints(file, (int *)system->ready_heap, (size_t)system->ready_count * 3);
+}
+
+static bool read_system(FILE *file, SimulationSystem *system) {
+    int header[5];
+    if (!read_ints(file, header, 5) || header[0] != CHECKPOINT_MAGIC || header[1] != CHECKPOINT_VERSION ||
+        header[2] != MAX_FRAMES || header[3] != MAX_PROCESSES || header[4] != MAX_PROGRAM_INSTRUCTIONS) {
+        return false;
+    }
+
+    int settings[43], clock_state[4];
+    if (!read_ints(file, settings, 43) ||
+        !read_ints(file, (int *)system->config.cache_levels, CACHE_LEVELS * 4) ||
+        !read_ints(file, (int *)&system->stats, sizeof(SimulationStats) / sizeof(int)) ||
+        !read_ints(file, clock_state, 4)) {
+        return false;
+    }
+    if (settings[0] < 1 || settings[0] > MAX_FRAMES || (settings[2] != POLICY_LRU && settings[2] != POLICY_FIFO) ||
+        settings[10] < FIT_FIRST || settings[10] > FIT_BUDDY || settings[13] < 0 || settings[13] > MAX_DEVICES ||
+        (settings[12] != 0 && settings[13] < 1) || settings[25] < RT_NONE || settings[25] > RT_RM ||
+        settings[37] < 0 || settings[37] > CACHE_LEVELS || settings[41] < settings[40] || settings[42] < 1) {
+        return false;
+    }
+    system->config.num_frames = settings[0];
+    system->config.quantum = settings[1];
+    system->config.policy = (ReplacementPolicy)settings[2];
+    system->config.prefetch_depth = settings[3];
+    system->config.load_control = settings[4] != 0;
+    system->config.ws_window = settings[5];
+    system->config.suspend_threshold = settings[6];
+    system->config.resume_threshold = settings[7];
+    system->config.cow_fork = settings[8] != 0;
+    system->config.contiguous = settings[9] != 0;
+    system->config.alloc_strategy = (AllocStrategy)settings[10];
+    system->config.compaction = settings[11] != 0;
+    system->config.io_model = settings[12] != 0;
+    system->config.num_devices = settings[13];
+    system->config.io_deadline = settings[14];
+    system->config.sync = settings[15] != 0;
+    system->config.spin_locks = settings[16] != 0;
+    system->config.priority_inheritance = settings[17] != 0;
+    system->config.priority_scheduling = settings[18] != 0;
+    system->config.semaphore_initial = settings[19];
+    for (int i = 0; i < 5; i++) {
+        system->config.priorities[i] = settings[20 + i];
+    }
+    system->config.rt_policy = (RealTimePolicy)settings[25];
+    for (int i = 0; i < 5; i++) {
+        system->config.periods[i] = settings[26 + i];
+        system->config.deadlines[i] = settings[31 + i];
+    }
+    system->config.cache = settings[36] != 0;
+    system->config.num_cache_levels = settings[37];
+    system->config.cache_pollution = settings[38];
+    system->config.kswapd = settings[39] != 0;
+    system->config.low_watermark = settings[40];
+    system->config.high_watermark = settings[41];
+    system->config.kswapd_batch = settings[42];
+    system->current_time = clock_state[0];
+    system->next_pid = clock_state[1];
+    system->will_be_created = clock_state[2] != 0;
+    system->finished = clock_state[3] != 0;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        if (!read_bool(file, &system->pre_new_printed[i])) return false;
+    }
+    if (!read_programs(file, &system->programs)) {
+        return false;
+    }
+    for (int i = 0; i < system->config.num_frames; i++) {
+        int fields[6];
+        if (!read_ints(file, fields, 6)) return false;
+        Frame *frame = &system->physical_memory[i];
+        frame->frame_id = i;
+        frame->process_id = fields[0];
+        frame->page_number = fields[1];
+        frame->load_time = fields[2];
+        frame->last_access_time = fields[3];
+        frame->prefetched = fields[4] != 0;
+        frame->sharers = (unsigned int)fields[5];
+    }
+    if (system->config.contiguous && !read_allocator(file, system)) {
+        return false;
+    }
+    if (system->config.io_model && !read_devices(file, system)) {
+        return false;
+    }
+    if (system->config.sync && !read_sync_objects(file, system)) {
+        return false;
+    }
+    if (system->config.rt_policy != RT_NONE && !read_ready_heap(file, system)) {
+        return false;
+    }
+    if (system->config.cache && !read_cache(file, system)) {
+        return false;
+    }
+    if (system->config.kswapd && (!read_bool(file, &system->kswapd_awake) ||
+                                  !read_ints(file, (int *)system->reclaimed_pages, MAX_PROCESSES))) {
+        return false;
+    }
+
+    int slot;
+    while (read_int(file, &slot) && slot != -1) {
+        if (slot < 0 || slot >= MAX_PROCESSES || system->processes[slot] != NULL) return false;
+        system->processes[slot] = read_pcb(file, &system->programs);
+        if (system->processes[slot] == NULL || system->processes[slot]->pid != slot + 1) return false;
+    }
+    if (slot != -1 || !frames_valid(system)) return false;
+    for (int i = 0; i < system->ready_count; i++) {
+        PCB *proc;
+        if (system->ready_heap[i].pid == 0 || !pcb_of(system, system->ready_heap[i].pid, &proc)) return false;
+    }
+
+    Queue *queues[] = {system->new_queue, system->ready_queue, system->blocked_queue, system->exit_queue, system->suspended_queue};
+    for (int q = 0; q < 5; q++) {
+        if (!read_queue(file, system, queues[q])) return false;
+    }
+    int running_pid, preempted_pid;
+    return read_int(file, &running_pid) && pcb_of(system, running_pid, &system->running_process) &&
+           read_int(file, &preempted_pid) && pcb_of(system, preempted_pid, &system->preempted_process);
+}
+
+bool load_checkpoint(SimulationSystem *system, const char *path) {
+    memset(system, 0, sizeof(SimulationSystem));
+    system->out = stdout;
+    system->new_queue = createQueue();
+    system->ready_queue = createQueue();
+    system->blocked_queue = createQueue();
+    system->exit_queue = createQueue();
+    system->suspended_queue = createQueue();
+
+    FILE *file = fopen(path, "rb");
+    bool ok = file != NULL && read_system(file, system);
+    if (file != NULL) fclose(file);
+    if (!ok) {
+        destroy_system(system);
+    }
+    return ok;
+}
@@ -0,0 +1,15 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "p2_simulator.h"
+
+// Binary snapshots of a whole SimulationSystem between two ticks: queues, PCBs, programs, frames,
+// the preempted process, configuration and counters. A restored system continues with
+// resume_simulation() and prints exactly the rows the original run printed after that tick.
+// Snapshots are meant to be read by the same build (same int size, byte order and limits).
+
+bool save_checkpoint(const SimulationSystem *system, const char *path);
+// Fills a fresh system from a snapshot. The checkpoint settings of the restored config are cleared.
+bool load_checkpoint(SimulationSystem *system, const char *path);
+
+#endif
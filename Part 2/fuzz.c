@@ -0,0 +1,647 @@
+#include "p2_simulator.h"
+#include "p2_reference.h"
+#include "inputs_part2.h"
+#include "workload.h"
+#include "checkpoint.h"
+
+// Differential fuzzer: every case is run through the reference engine and the current engine,
+// and the two state tables must be byte for byte identical.
+
+#define REFERENCE_OUTPUT "fuzz_reference.out"
+#define ENGINE_OUTPUT "fuzz_engine.out"
+#define FAILURE_PROGRAMS "fuzz_failure.txt"
+#define RESTORED_OUTPUT "fuzz_restored.out"
+#define CHECKPOINT_PREFIX "fuzz_checkpoint"
+#define COW_OUTPUT "fuzz_cow.out"
+#define CONTIGUOUS_OUTPUT "fuzz_contiguous.out"
+#define IO_OUTPUT "fuzz_io.out"
+#define SYNC_OUTPUT "fuzz_sync.out"
+#define RT_OUTPUT "fuzz_rt.out"
+#define CACHE_OUTPUT "fuzz_cache.out"
+#define KSWAPD_OUTPUT "fuzz_kswapd.out"
+#define STORE_FILE "fuzz_programs.txt"
+#define STORE_OUTPUT "fuzz_store.out"
+
+#ifdef _WIN32
+    #define NULL_DEVICE "NUL"
+#else
+    #define NULL_DEVICE "/dev/null"
+#endif
+
+char *read_file(const char *path, long *length) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return NULL;
+    fseek(file, 0, SEEK_END);
+    *length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *data = (char *)malloc(*length + 1);
+    if (data != NULL) {
+        if (fread(data, 1, *length, file) != (size_t)*length) {
+            free(data);
+            data = NULL;
+        } else {
+            data[*length] = '\0';
+        }
+    }
+    fclose(file);
+    return data;
+}
+
+// Compares two files byte for byte and reports the first line that differs
+bool same_output(const char *expected_path, const char *actual_path) {
+    long expected_length = 0, actual_length = 0;
+    char *expected = read_file(expected_path, &expected_length);
+    char *actual = read_file(actual_path, &actual_length);
+    bool same = expected != NULL && actual != NULL && expected_length == actual_length &&
+                memcmp(expected, actual, expected_length) == 0;
+    if (!same && expected != NULL && actual != NULL) {
+        long line = 1;
+        for (long i = 0; i < expected_length && i < actual_length && expected[i] == actual[i]; i++) {
+            if (expected[i] == '\n') line++;
+        }
+        fprintf(stderr, "  %s and %s differ at line %ld\n", expected_path, actual_path, line);
+    }
+    free(expected);
+    free(actual);
+    return same;
+}
+
+// The published tables use spaces and an extra "inst" column, so only the words are compared
+bool same_words(const char *expected_path, const char *actual_path) {
+    long expected_length = 0, actual_length = 0;
+    char *expected = read_file(expected_path, &expected_length);
+    char *actual = read_file(actual_path, &actual_length);
+    bool same = expected != NULL && actual != NULL;
+    char *expected_save = NULL, *actual_save = NULL;
+    char *expected_word = same ? strtok_r(expected, " \t\r\n", &expected_save) : NULL;
+    char *actual_word = same ? strtok_r(actual, " \t\r\n", &actual_save) : NULL;
+    while (same && (expected_word || actual_word)) {
+        if (expected_word && strcmp(expected_word, "inst") == 0) {
+            expected_word = strtok_r(NULL, " \t\r\n", &expected_save);
+            continue;
+        }
+        same = expected_word && actual_word && strcmp(expected_word, actual_word) == 0;
+        expected_word = strtok_r(NULL, " \t\r\n", &expected_save);
+        actual_word = strtok_r(NULL, " \t\r\n", &actual_save);
+    }
+    free(expected);
+    free(actual);
+    return same;
+}
+
+void run_engine(const char *path, bool reference, SimulationInput input) {
+    freopen(path, "w", stdout);
+    if (reference) {
+        run_reference_simulation(input);
+    } else {
+        SimulationSystem system;
+        initialize_system_with_input(&system, input);
+        run_simulation(&system);
+        destroy_system(&system);
+    }
+    fflush(stdout);
+    freopen(NULL_DEVICE, "w", stdout);
+}
+
+// Compares a table with the end of another one, from line first_line (0-based) on
+bool same_tail(const char *full_path, const char *tail_path, int first_line) {
+    long full_length = 0, tail_length = 0;
+    char *full = read_file(full_path, &full_length);
+    char *tail = read_file(tail_path, &tail_length);
+    bool same = full != NULL && tail != NULL;
+    long start = 0;
+    for (int line = 0; same && line < first_line && start < full_length; start++) {
+        if (full[start] == '\n') line++;
+    }
+    same = same && full_length - start == tail_length && memcmp(full + start, tail, tail_length) == 0;
+    free(full);
+    free(tail);
+    return same;
+}
+
+// Checkpoints the engine at a tick, restores the snapshot and checks that the resumed run prints
+// the rest of the table in full_path. Runs that end before the tick write no checkpoint.
+bool check_restore(SimulationInput input, SimulationConfig config, int tick, const char *full_path) {
+    config.checkpoint_interval = tick;
+    config.checkpoint_prefix = CHECKPOINT_PREFIX;
+    SimulationSystem system;
+    initialize_system_with_config(&system, input, &config);
+    run_simulation(&system); // stdout is on the null device between runs
+    destroy_system(&system);
+
+    char path[64];
+    snprintf(path, sizeof(path), "%s_t%03d.ckpt", CHECKPOINT_PREFIX, tick);
+    bool same = true;
+    SimulationSystem restored;
+    FILE *written = fopen(path, "rb");
+    if (written != NULL) {
+        fclose(written);
+        // Everything the engine saves must pass the checks of the loader
+        if (!load_checkpoint(&restored, path)) {
+            fprintf(stderr, "  %s does not restore\n", path);
+            same = false;
+        } else {
+            freopen(RESTORED_OUTPUT, "w", stdout);
+            resume_simulation(&restored);
+            destroy_system(&restored);
+            fflush(stdout);
+            freopen(NULL_DEVICE, "w", stdout);
+            same = same_tail(full_path, RESTORED_OUTPUT, tick + 1); // Header and the rows up to the tick
+        }
+    }
+    for (int t = tick; t <= 100; t += tick) {
+        snprintf(path, sizeof(path), "%s_t%03d.ckpt", CHECKPOINT_PREFIX, t);
+        remove(path);
+    }
+    return same;
+}
+
+// Copy-on-write mode has no reference engine. Every frame must be free once all processes are gone
+// (the reference counts add up), and a restored checkpoint must continue the table unchanged.
+bool check_cow(SimulationInput input, int tick) {
+    SimulationConfig config = default_config();
+    config.cow_fork = true;
+    SimulationSystem system;
+    freopen(COW_OUTPUT, "w", stdout);
+    initialize_system_with_config(&system, input, &config);
+    run_simulation(&system);
+    fflush(stdout);
+    freopen(NULL_DEVICE, "w", stdout);
+    bool frames_free = true;
+    for (int i = 0; system.finished && i < config.num_frames; i++) {
+        frames_free = frames_free && system.physical_memory[i].process_id == -1 && system.physical_memory[i].sharers == 0;
+    }
+    destroy_system(&system);
+    if (!frames_free) {
+        fprintf(stderr, "  frames still mapped after every process exited\n");
+        return false;
+    }
+    return check_restore(input, config, tick, COW_OUTPUT);
+}
+
+// The blocks must tile memory from address 0 without gaps, no two holes may sit side by side
+// (variable partitions), and buddy blocks must be aligned powers of two.
+bool valid_blocks(const Allocator *allocator) {
+    int next = 0;
+    for (int i = 0; i < allocator->count; i++) {
+        const Partition *block = &allocator->blocks[i];
+        if (block->start != next || block->size < 1) return false;
+        if (allocator->strategy == FIT_BUDDY) {
+            // Find the power of two top block holding the block, as the allocator lays them out
+            int base = 0, top = 0;
+            for (int size = 1 << 30; size >= BUDDY_MIN_BLOCK && top == 0; size >>= 1) {
+                if (allocator->capacity - base < size) continue;
+                if (block->start < base + size) top = size;
+                else base += size;
+            }
+            if ((block->size & (block->size - 1)) != 0 || block->size < BUDDY_MIN_BLOCK ||
+                (block->start - base) % block->size != 0 || block->start + block->size > base + top) {
+                return false;
+            }
+        } else if (i > 0 && block->owner == -1 && allocator->blocks[i - 1].owner == -1) {
+            return false;
+        }
+        next += block->size;
+    }
+    return next <= allocator->capacity && (allocator->strategy == FIT_BUDDY || next == allocator->capacity);
+}
+
+// Random allocations and frees on every strategy. Freeing everything must leave the initial blocks.
+bool check_allocator(int rounds) {
+    for (int round = 0; round < rounds; round++) {
+        AllocStrategy strategy = (AllocStrategy)(rand() % 4);
+        int capacity = 1000 + rand() % 40000;
+        Allocator allocator, initial;
+        allocator_init(&allocator, strategy, capacity, rand() % 2);
+        allocator_init(&initial, strategy, capacity, false);
+        bool live[MAX_PROCESSES + 1] = {false};
+        bool ok = true;
+        for (int step = 0; step < 200 && ok; step++) {
+            int owner = 1 + rand() % MAX_PROCESSES;
+            if (live[owner]) {
+                allocator_free(&allocator, owner);
+                live[owner] = false;
+            } else {
+                int size = 1 + rand() % (capacity / 2);
+                int start = allocator_alloc(&allocator, owner, size);
+                const Partition *partition = allocator_find(&allocator, owner);
+                live[owner] = start != -1;
+                ok = start == -1 ? partition == NULL : partition != NULL && partition->start == start && partition->size >= size;
+            }
+            allocator_sample(&allocator);
+            ok = ok && valid_blocks(&allocator);
+        }
+        for (int owner = 1; owner <= MAX_PROCESSES; owner++) {
+            if (live[owner]) allocator_free(&allocator, owner);
+        }
+        ok = ok && allocator.count == initial.count &&
+             memcmp(allocator.blocks, initial.blocks, initial.count * sizeof(Partition)) == 0;
+        allocator_destroy(&allocator);
+        allocator_destroy(&initial);
+        if (!ok) {
+            fprintf(stderr, "Allocator (%s, capacity %d) broke its block list in round %d\n", alloc_strategy_name(strategy), capacity, round);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Contiguous allocation has no reference engine either: every partition must be freed at the end,
+// and a restored checkpoint must continue the table unchanged.
+bool check_contiguous(SimulationInput input, int tick) {
+    SimulationConfig config = default_config();
+    config.contiguous = true;
+    config.alloc_strategy = (AllocStrategy)(rand() % 4);
+    config.compaction = rand() % 2;
+    config.num_frames = 1 + rand() % 12;
+    SimulationSystem system;
+    freopen(CONTIGUOUS_OUTPUT, "w", stdout);
+    initialize_system_with_config(&system, input, &config);
+    run_simulation(&system);
+    fflush(stdout);
+    freopen(NULL_DEVICE, "w", stdout);
+    bool released = true;
+    for (int pid = 1; system.finished && pid <= MAX_PROCESSES; pid++) {
+        released = released && allocator_find(&system.allocator, pid) == NULL;
+    }
+    released = released && valid_blocks(&system.allocator);
+    destroy_system(&system);
+    if (!released) {
+        fprintf(stderr, "  partitions still allocated after every process exited\n");
+        return false;
+    }
+    return check_restore(input, config, tick, CONTIGUOUS_OUTPUT);
+}
+
+// Runs the I/O model into IO_OUTPUT
+void run_io_engine(SimulationInput input, const SimulationConfig *config) {
+    SimulationSystem system;
+    freopen(IO_OUTPUT, "w", stdout);
+    initialize_system_with_config(&system, input, config);
+    run_simulation(&system);
+    destroy_system(&system);
+    fflush(stdout);
+    freopen(NULL_DEVICE, "w", stdout);
+}
+
+// A single FIFO device with a slot per process never makes a request wait, so the I/O model must print
+// the reference table. Random devices are then checked by restoring one of their checkpoints.
+bool check_io(SimulationInput input, int tick) {
+    SimulationConfig config = default_config();
+    config.io_model = true;
+    config.num_devices = 1;
+    config.devices[0] = (DeviceConfig){"free", IO_FIFO, MAX_DEVICE_SLOTS};
+    run_io_engine(input, &config);
+    if (!same_output(REFERENCE_OUTPUT, IO_OUTPUT)) {
+        fprintf(stderr, "  a contention free device changes the table\n");
+        return false;
+    }
+
+    config.num_devices = 1 + rand() % MAX_DEVICES;
+    for (int d = 0; d < config.num_devices; d++) {
+        config.devices[d] = (DeviceConfig){"random", rand() % 3, 1 + rand() % 3};
+    }
+    config.io_deadline = rand() % 10;
+    run_io_engine(input, &config);
+    return check_restore(input, config, tick, IO_OUTPUT);
+}
+
+// Under synchronization every mutex must be free with nobody waiting once all processes exited,
+// since terminating a process releases what it holds. A restored checkpoint must continue the table.
+bool check_sync(SimulationInput input, int tick) {
+    SimulationConfig config = default_config();
+    config.sync = true;
+    config.spin_locks = rand() % 2;
+    config.priority_inheritance = rand() % 2;
+    config.priority_scheduling = rand() % 2;
+    for (int i = 0; i < 5; i++) {
+        config.priorities[i] = rand() % 4;
+    }
+    config.semaphore_initial = rand() % 3;
+    SimulationSystem system;
+    freopen(SYNC_OUTPUT, "w", stdout);
+    initialize_system_with_config(&system, input, &config);
+    run_simulation(&system);
+    fflush(stdout);
+    freopen(NULL_DEVICE, "w", stdout);
+    bool released = true;
+    for (int m = 0; system.finished && m < NUM_MUTEXES; m++) {
+        released = released && system.mutexes[m].owner == 0 && system.mutexes[m].num_waiters == 0;
+    }
+    for (int s = 0; system.finished && s < NUM_SEMAPHORES; s++) {
+        released = released && system.semaphores[s].num_waiters == 0;
+    }
+    destroy_system(&system);
+    if (!released) {
+        fprintf(stderr, "  a mutex is still held or waited for after every process exited\n");
+        return false;
+    }
+    return check_restore(input, config, tick, SYNC_OUTPUT);
+}
+
+// Runs real-time scheduling into RT_OUTPUT
+void run_rt_engine(SimulationInput input, const SimulationConfig *config) {
+    SimulationSystem system;
+    freopen(RT_OUTPUT, "w", stdout);
+    initialize_system_with_config(&system, input, config);
+    run_simulation(&system);
+    destroy_system(&system);
+    fflush(stdout);
+    freopen(NULL_DEVICE, "w", stdout);
+}
+
+// With no periodic program every process is best effort, and the heap must hand them out in the
+// order of the ready queue. Random periods and deadlines are then checked by restoring a checkpoint.
+bool check_rt(SimulationInput input, int tick) {
+    SimulationConfig config = default_config();
+    config.rt_policy = rand() % 2 ? RT_EDF : RT_RM;
+    run_rt_engine(input, &config);
+    if (!same_output(REFERENCE_OUTPUT, RT_OUTPUT)) {
+        fprintf(stderr, "  best effort processes are not scheduled in FIFO order\n");
+        return false;
+    }
+
+    for (int i = 0; i < 5; i++) {
+        config.periods[i] = rand() % 2 ? 5 + rand() % 40 : 0;
+        config.deadlines[i] = rand() % 3 == 0 ? 1 + rand() % 40 : 0;
+    }
+    run_rt_engine(input, &config);
+    return check_restore(input, config, tick, RT_OUTPUT);
+}
+
+// Miss and eviction counters of a cache, which the table does not show
+void cache_counters(const CacheHierarchy *cache, long long counters[2 * CACHE_LEVELS + 2]) {
+    for (int l = 0; l < CACHE_LEVELS; l++) {
+        counters[2 * l] = l < cache->num_levels ? cache->levels[l].accesses : 0;
+        counters[2 * l + 1] = l < cache->num_levels ? cache->levels[l].misses : 0;
+    }
+    counters[2 * CACHE_LEVELS] = cache->switches;
+    counters[2 * CACHE_LEVELS + 1] = 0;
+    for (int p = 0; p < cache->num_owners; p++) {
+        counters[2 * CACHE_LEVELS + 1] += cache->owner_lost[p];
+    }
+}
+
+// Caches only observe the accesses, so the table must stay the reference one. Every level must see
+// exactly the misses of the level above, and a restored checkpoint must end with the same counters.
+bool check_cache(SimulationInput input, int tick) {
+    SimulationConfig config = default_config();
+    config.cache = true;
+    config.num_cache_levels = 1 + rand() % CACHE_LEVELS;
+    for (int l = 0; l < config.num_cache_levels; l++) {
+        int line_size = 8 << (rand() % 4), ways = 1 << (rand() % 4);
+        config.cache_levels[l] = (CacheLevelConfig){line_size * ways * (1 + rand() % 16), line_size, ways, rand() % 3};
+    }
+    config.cache_pollution = rand() % 2 ? rand() % 101 : 0;
+    SimulationSystem system;
+    freopen(CACHE_OUTPUT, "w", stdout);
+    initialize_system_with_config(&system, input, &config);
+    run_simulation(&system);
+    fflush(stdout);
+    freopen(NULL_DEVICE, "w", stdout);
+    bool consistent = system.cache.levels[0].accesses == system.stats.memory_accesses;
+    for (int l = 1; l < config.num_cache_levels; l++) {
+        consistent = consistent && system.cache.levels[l].accesses == system.cache.levels[l - 1].misses;
+    }
+    long long full[2 * CACHE_LEVELS + 2];
+    cache_counters(&system.cache, full);
+    destroy_system(&system);
+    if (!consistent) {
+        fprintf(stderr, "  cache levels do not see the misses of the level above\n");
+        return false;
+    }
+    if (!same_output(REFERENCE_OUTPUT, CACHE_OUTPUT)) {
+        fprintf(stderr, "  caches change the table\n");
+        return false;
+    }
+    if (!check_restore(input, config, tick, CACHE_OUTPUT)) return false;
+
+    config.checkpoint_interval = tick;
+    config.checkpoint_prefix = CHECKPOINT_PREFIX;
+    initialize_system_with_config(&system, input, &config);
+    run_simulation(&system);
+    destroy_system(&system);
+    char path[64];
+    snprintf(path, sizeof(path), "%s_t%03d.ckpt", CHECKPOINT_PREFIX, tick);
+    bool same = true;
+    if (load_checkpoint(&system, path)) {
+        system.config.checkpoint_interval = 0;
+        resume_simulation(&system);
+        long long restored[2 * CACHE_LEVELS + 2];
+        cache_counters(&system.cache, restored);
+        same = memcmp(full, restored, sizeof(full)) == 0;
+        destroy_system(&system);
+    }
+    for (int t = tick; t <= 100; t += tick) {
+        snprintf(path, sizeof(path), "%s_t%03d.ckpt", CHECKPOINT_PREFIX, t);
+        remove(path);
+    }
+    if (!same) fprintf(stderr, "  restored caches end with different counters\n");
+    return same;
+}
+
+// Every fault either finds a free frame or reclaims one itself, and the daemon cannot be blamed for
+// more refaults than the pages it evicted. Random watermarks are then checked by restoring a checkpoint.
+bool check_kswapd(SimulationInput input, int tick) {
+    SimulationConfig config = default_config();
+    config.kswapd = true;
+    config.low_watermark = 1 + rand() % config.num_frames;
+    config.high_watermark = config.low_watermark + rand() % (config.num_frames - config.low_watermark + 1);
+    config.kswapd_batch = 1 + rand() % 3;
+    config.policy = rand() % 2 ? POLICY_LRU : POLICY_FIFO;
+    SimulationSystem system;
+    freopen(KSWAPD_OUTPUT, "w", stdout);
+    initialize_system_with_config(&system, input, &config);
+    run_simulation(&system);
+    fflush(stdout);
+    freopen(NULL_DEVICE, "w", stdout);
+    const SimulationStats *stats = &system.stats;
+    bool consistent = stats->free_frame_faults + stats->direct_reclaims == stats->page_faults &&
+                      stats->kswapd_refaults <= stats->kswapd_reclaimed;
+    destroy_system(&system);
+    if (!consistent) {
+        fprintf(stderr, "  fault counters of background reclaim do not add up\n");
+        return false;
+    }
+    return check_restore(input, config, tick, KSWAPD_OUTPUT);
+}
+
+// The programs decoded from the input, written as a program store file and loaded back, must run to
+// the reference table
+bool check_store(SimulationInput input) {
+    SimulationSystem system;
+    initialize_system_with_input(&system, input);
+    FILE *file = fopen(STORE_FILE, "w");
+    bool written = file != NULL && program_store_write(file, &system.programs);
+    if (file != NULL) fclose(file);
+    destroy_system(&system);
+
+    ProgramStore programs;
+    file = fopen(STORE_FILE, "rb");
+    bool loaded = written && file != NULL && program_store_load(file, &programs);
+    if (file != NULL) fclose(file);
+    if (!loaded) {
+        fprintf(stderr, "  program store file could not be read back\n");
+        return false;
+    }
+    SimulationConfig config = default_config();
+    freopen(STORE_OUTPUT, "w", stdout);
+    bool started = initialize_system_with_programs(&system, &programs, &config);
+    if (started) run_simulation(&system);
+    destroy_system(&system);
+    program_store_destroy(&programs);
+    fflush(stdout);
+    freopen(NULL_DEVICE, "w", stdout);
+    return started && same_output(REFERENCE_OUTPUT, STORE_OUTPUT);
+}
+
+// Runs one case on both engines. On a mismatch the programs are saved to FAILURE_PROGRAMS.
+bool check_case(SimulationInput input, const char *description) {
+    run_engine(REFERENCE_OUTPUT, true, input);
+    run_engine(ENGINE_OUTPUT, false, input);
+    int tick = 1 + rand() % 30;
+    bool same = same_output(REFERENCE_OUTPUT, ENGINE_OUTPUT);
+    bool restored = same && check_restore(input, default_config(), tick, REFERENCE_OUTPUT);
+    bool cow = restored && check_cow(input, tick);
+    bool contiguous = cow && check_contiguous(input, tick);
+    bool io = contiguous && check_io(input, tick);
+    bool sync = io && check_sync(input, tick);
+    bool rt = sync && check_rt(input, tick);
+    bool cache = rt && check_cache(input, tick);
+    bool kswapd = cache && check_kswapd(input, tick);
+    if (kswapd && check_store(input)) return true;
+
+    if (kswapd) {
+        fprintf(stderr, "Program store run of %s failed, programs saved to %s\n", description, FAILURE_PROGRAMS);
+    } else if (cache) {
+        fprintf(stderr, "Background reclaim run of %s failed at tick %d, programs saved to %s\n", description, tick, FAILURE_PROGRAMS);
+    } else if (rt) {
+        fprintf(stderr, "Cache run of %s failed at tick %d, programs saved to %s\n", description, tick, FAILURE_PROGRAMS);
+    } else if (sync) {
+        fprintf(stderr, "Real-time run of %s failed at tick %d, programs saved to %s\n", description, tick, FAILURE_PROGRAMS);
+    } else if (io) {
+        fprintf(stderr, "Synchronization run of %s failed at tick %d, programs saved to %s\n", description, tick, FAILURE_PROGRAMS);
+    } else if (contiguous) {
+        fprintf(stderr, "I/O run of %s failed at tick %d, programs saved to %s\n", description, tick, FAILURE_PROGRAMS);
+    } else if (cow) {
+        fprintf(stderr, "Contiguous run of %s failed at tick %d, programs saved to %s\n", description, tick, FAILURE_PROGRAMS);
+    } else if (restored) {
+        fprintf(stderr, "Copy-on-write run of %s failed at tick %d, programs saved to %s\n", description, tick, FAILURE_PROGRAMS);
+    } else if (same) {
+        fprintf(stderr, "Restoring the tick %d checkpoint of %s diverges, programs saved to %s\n", tick, description, FAILURE_PROGRAMS);
+    } else {
+        fprintf(stderr, "Mismatch on %s, programs saved to %s\n", description, FAILURE_PROGRAMS);
+    }
+    FILE *file = fopen(FAILURE_PROGRAMS, "w");
+    if (file != NULL) {
+        write_programs_text(file, &input, 5);
+        fclose(file);
+    }
+    return false;
+}
+
+// Any value the instruction decoder handles, including the unused ranges that act as NOPs
+int random_instruction(int memory_size) {
+    switch (rand() % 8) {
+        case 0: return 1000 + rand() % (memory_size + 2000);   // LOAD/STORE, sometimes out of bounds
+        case 1: return 1000 + rand() % 15000;
+        case 2: return 1 + rand() % 100;                      // JUMPF
+        case 3: return 101 + rand() % 99;                     // JUMPB
+        case 4: return 200 + rand() % 101;                    // EXEC, 200 and 300 included
+        case 5: return rand() % 8 ? -(1 + rand() % 25) : -(100 + rand() % 60); // BLOCK, sometimes 100 or more
+        case 6: return (rand() % 2) ? 300 + rand() % 700 : 16000 + rand() % 1000; // Unknown, FORK/STORE/LOCK... if enabled
+        default: return 0;                                    // HALT
+    }
+}
+
+// Random programs, either from the workload generator or raw instruction values
+SimulationInput random_case(void) {
+    SimulationInput input;
+    if (rand() % 2 == 0) {
+        ProgramSpec spec = default_program_spec();
+        spec.num_programs = 1 + rand() % 5;
+        spec.length = 2 + rand() % 40;
+        spec.seed = rand();
+        spec.load_weight = rand() % 10;
+        spec.jump_weight = rand() % 10;
+        spec.exec_weight = rand() % 10;
+        spec.block_weight = rand() % 10;
+        spec.fork_weight = rand() % 4;
+        spec.store_percent = rand() % 60;
+        spec.lock_weight = rand() % 6;
+        spec.lock_count = 1 + rand() % 3;
+        spec.backward_jump_percent = rand() % 60;
+        spec.segfault_rate = (rand() % 3) / 20.0;
+        if (generate_programs(&spec, &input)) return input;
+    }
+
+    input.rows = 2 + rand() % 60;
+    input.programs = calloc(input.rows, sizeof(int[20]));
+    for (int prog = 0; prog < 5; prog++) {
+        int memory_size = rand() % 16000;
+        input.programs[0][prog] = memory_size;
+        for (int row = 1; row < input.rows; row++) {
+            input.programs[row][prog] = rand() % 12 == 0 ? 0 : random_instruction(memory_size);
+        }
+    }
+    return input;
+}
+
+int main(int argc, char *argv[]) {
+    int iterations = 2000;
+    unsigned seed = 1;
+    const char *seed_dir = "../Desired outputs";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--iterations") == 0) iterations = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0) seed = (unsigned)strtoul(argv[i + 1], NULL, 10);
+        else if (strcmp(argv[i], "--seed-dir") == 0) seed_dir = argv[i + 1];
+        else {
+            fprintf(stderr, "Usage: %s [--iterations N] [--seed N] [--seed-dir DIR]\n", argv[0]);
+            return 1;
+        }
+    }
+    srand(seed);
+
+    // Seed cases: the built-in inputs, and the published expected table for test case 00
+    SimulationInput inputs[] = {
+        {input00, 8}, {input01, 6}, {input02, 5}, {input03, 6}, {input04, 6},
+        {input05, 6}, {input06, 5}, {input07, 12}, {input08, 12}, {input09, 12},
+        {input10, 12}, {input11, 12}
+    };
+    int failures = check_allocator(iterations / 4) ? 0 : 1;
+    for (int i = 0; i < 12; i++) {
+        char description[32];
+        sprintf(description, "built-in input %02d", i);
+        if (!check_case(inputs[i], description)) failures++;
+    }
+    char desired[512];
+    snprintf(desired, sizeof(desired), "%s/output2T00.txt", seed_dir);
+    run_engine(ENGINE_OUTPUT, false, inputs[0]);
+    if (!same_words(desired, ENGINE_OUTPUT)) {
+        fprintf(stderr, "Engine does not reproduce %s\n", desired);
+        failures++;
+    }
+
+    for (int n = 0; n < iterations && failures == 0; n++) {
+        SimulationInput input = random_case();
+        char description[32];
+        sprintf(description, "random case %d", n);
+        if (!check_case(input, description)) failures++;
+        free(input.programs);
+    }
+
+    remove(REFERENCE_OUTPUT);
+    remove(ENGINE_OUTPUT);
+    remove(RESTORED_OUTPUT);
+    remove(COW_OUTPUT);
+    remove(CONTIGUOUS_OUTPUT);
+    remove(IO_OUTPUT);
+    remove(SYNC_OUTPUT);
+    remove(RT_OUTPUT);
+    remove(CACHE_OUTPUT);
+    remove(KSWAPD_OUTPUT);
+    remove(STORE_FILE);
+    remove(STORE_OUTPUT);
+    fprintf(stderr, "%s: %d random cases, seed %u\n", failures == 0 ? "PASS" : "FAIL", iterations, seed);
+    return failures == 0 ? 0 : 1;
+}
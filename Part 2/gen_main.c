@@ -0,0 +1,107 @@
+#include "workload.h"
+
+void print_usage(const char *program_name) {
+    fprintf(stderr, "Usage: %s [options]\n", program_name);
+    fprintf(stderr, "  --programs N      Number of programs (default 5, the simulator loads up to 5 of a text or c file)\n");
+    fprintf(stderr, "  --length N        Instructions per program, HALT included (default 20)\n");
+    fprintf(stderr, "  --seed N          Random seed (default 1)\n");
+    fprintf(stderr, "  --min-mem N       Smallest program memory size in bytes (default 1000)\n");
+    fprintf(stderr, "  --max-mem N       Largest program memory size in bytes (default 12000, at most 15000)\n");
+    fprintf(stderr, "  --mix L,J,E,B     Weights of LOAD/STORE, JUMP, EXEC and BLOCK (default 60,10,10,20)\n");
+    fprintf(stderr, "  --fork W          Weight of FORK instructions, for runs with --cow (default 0)\n");
+    fprintf(stderr, "  --stores P        Percent of the memory accesses written as STORE (default 0)\n");
+    fprintf(stderr, "  --locks W         Weight of LOCK and UNLOCK pairs, for runs with --sync (default 0)\n");
+    fprintf(stderr, "  --mutexes N       Mutexes the generated locks use (default 1)\n");
+    fprintf(stderr, "  --max-block N     Longest BLOCK duration (default 5, at most 99 with --devices)\n");
+    fprintf(stderr, "  --devices N       Spread the BLOCKs over N I/O devices (default 1)\n");
+    fprintf(stderr, "  --backward P      Percent of jumps that go backwards (default 20)\n");
+    fprintf(stderr, "  --segv RATE       Fraction of out of bounds addresses (default 0)\n");
+    fprintf(stderr, "  --format FMT      text (program file), c (array like inputs_part2.c) or programs\n");
+    fprintf(stderr, "                    (program store for --programs, any number and length of programs)\n");
+    fprintf(stderr, "  --out FILE        Output file (default standard output)\n");
+}
+
+// Program stores are generated straight into memory, without the 20 columns of an input
+int write_store(const ProgramSpec *spec, const char *out_path) {
+    ProgramStore programs;
+    if (!generate_program_store(spec, &programs)) {
+        fprintf(stderr, "Invalid program parameters\n");
+        return 1;
+    }
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (out == NULL) {
+        perror("Error opening output file");
+        program_store_destroy(&programs);
+        return 1;
+    }
+    bool written = program_store_write(out, &programs);
+    if (out != stdout) fclose(out);
+    program_store_destroy(&programs);
+    return written ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    ProgramSpec spec = default_program_spec();
+    const char *format = "text";
+    const char *out_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+        const char *option = argv[i - 1];
+        bool ok = true;
+        if (strcmp(option, "--programs") == 0) spec.num_programs = atoi(value);
+        else if (strcmp(option, "--length") == 0) spec.length = atoi(value);
+        else if (strcmp(option, "--seed") == 0) spec.seed = strtoul(value, NULL, 10);
+        else if (strcmp(option, "--min-mem") == 0) spec.min_memory = atoi(value);
+        else if (strcmp(option, "--max-mem") == 0) spec.max_memory = atoi(value);
+        else if (strcmp(option, "--mix") == 0) {
+            ok = sscanf(value, "%d,%d,%d,%d", &spec.load_weight, &spec.jump_weight,
+                        &spec.exec_weight, &spec.block_weight) == 4;
+        }
+        else if (strcmp(option, "--fork") == 0) spec.fork_weight = atoi(value);
+        else if (strcmp(option, "--stores") == 0) spec.store_percent = atoi(value);
+        else if (strcmp(option, "--locks") == 0) spec.lock_weight = atoi(value);
+        else if (strcmp(option, "--mutexes") == 0) spec.lock_count = atoi(value);
+        else if (strcmp(option, "--devices") == 0) spec.block_devices = atoi(value);
+        else if (strcmp(option, "--max-block") == 0) spec.max_block = atoi(value);
+        else if (strcmp(option, "--backward") == 0) spec.backward_jump_percent = atoi(value);
+        else if (strcmp(option, "--segv") == 0) spec.segfault_rate = atof(value);
+        else if (strcmp(option, "--format") == 0) format = value;
+        else if (strcmp(option, "--out") == 0) out_path = value;
+        else ok = false;
+        if (!ok) {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (strcmp(format, "programs") == 0) {
+        return write_store(&spec, out_path);
+    }
+
+    SimulationInput input;
+    if (!generate_programs(&spec, &input)) {
+        fprintf(stderr, "Invalid program parameters\n");
+        return 1;
+    }
+
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (out == NULL) {
+        perror("Error opening output file");
+        free(input.programs);
+        return 1;
+    }
+    bool written;
+    if (strcmp(format, "c") == 0) {
+        written = write_programs_c(out, &input, spec.num_programs, "inputGen");
+    } else {
+        written = write_programs_text(out, &input, spec.num_programs);
+    }
+    if (out != stdout) fclose(out);
+    free(input.programs);
+    return written ? 0 : 1;
+}
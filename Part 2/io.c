@@ -0,0 +1,122 @@
+#include <string.h>
+#include <stdlib.h>
+#include "io.h"
+
+void device_init(Device *device) {
+    memset(device, 0, sizeof(Device));
+    device->direction = 1;
+}
+
+bool device_submit(Device *device, IoRequest request) {
+    if (device->queued >= MAX_DEVICE_SLOTS) return false;
+    device->queue[device->queued++] = request;
+    device->requests++;
+    if (device->queued > device->max_queue) device->max_queue = device->queued;
+    return true;
+}
+
+// Elevator order (LOOK): the nearest track ahead of the head in the sweep direction,
+// turning around when nothing is left ahead. Equal tracks are served in arrival order.
+static int pick_scan(Device *device) {
+    for (int turn = 0; turn < 2; turn++) {
+        int best = -1;
+        for (int i = 0; i < device->queued; i++) {
+            int distance = (device->queue[i].track - device->head) * device->direction;
+            if (distance < 0) continue;
+            if (best == -1 || distance < (device->queue[best].track - device->head) * device->direction) best = i;
+        }
+        if (best != -1) return best;
+        device->direction = -device->direction;
+    }
+    return 0;
+}
+
+// Expired requests first, by deadline, and the elevator order otherwise
+static int pick_deadline(Device *device, int now) {
+    int expired = -1;
+    for (int i = 0; i < device->queued; i++) {
+        if (device->queue[i].deadline < now && (expired == -1 || device->queue[i].deadline < device->queue[expired].deadline)) {
+            expired = i;
+        }
+    }
+    return expired != -1 ? expired : pick_scan(device);
+}
+
+int device_dispatch(Device *device, const DeviceConfig *config, int now, int started_pids[], int done_times[]) {
+    int started = 0;
+    for (int slot = 0; slot < config->concurrency; slot++) {
+        if (device->slot_pid[slot] != 0 && device->slot_done[slot] <= now) device->slot_pid[slot] = 0;
+    }
+    for (int slot = 0; slot < config->concurrency && device->queued > 0; slot++) {
+        if (device->slot_pid[slot] != 0) continue;
+        int index = 0; // IO_FIFO
+        if (config->discipline == IO_SCAN) index = pick_scan(device);
+        else if (config->discipline == IO_DEADLINE) index = pick_deadline(device, now);
+        IoRequest request = device->queue[index];
+        memmove(&device->queue[index], &device->queue[index + 1], (device->queued - index - 1) * sizeof(IoRequest));
+        device->queued--;
+
+        int wait = now - request.submitted;
+        device->wait_total += wait;
+        if (wait > device->max_wait) device->max_wait = wait;
+        if (now > request.deadline) device->deadline_misses++;
+        device->head = request.track;
+
+        started_pids[started] = request.pid;
+        done_times[started++] = now + request.duration;
+        if (request.duration > 0) {
+            device->slot_pid[slot] = request.pid;
+            device->slot_done[slot] = now + request.duration;
+        } else {
+            slot--; // Nothing to serve, the slot is still free
+        }
+    }
+    return started;
+}
+
+void device_account(Device *device, const DeviceConfig *config) {
+    for (int slot = 0; slot < config->concurrency; slot++) {
+        if (device->slot_pid[slot] != 0) device->busy_ticks++;
+    }
+}
+
+void device_print_stats(const Device *device, const DeviceConfig *config, int ticks, FILE *out) {
+    int served = device->requests - device->queued;
+    char label[64];
+    snprintf(label, sizeof(label), "%s (%s, %d)", config->name, io_discipline_name((IoDiscipline)config->discipline),
+             config->concurrency);
+    fprintf(out, "%-26s %d requests\n", label, device->requests);
+    fprintf(out, "%-26s %.2f\n", "  utilization", ticks > 0 ? (double)device->busy_ticks / ((double)ticks * config->concurrency) : 0.0);
+    fprintf(out, "%-26s %.2f\n", "  average queueing delay", served > 0 ? (double)device->wait_total / served : 0.0);
+    fprintf(out, "%-26s %d\n", "  longest queueing delay", device->max_wait);
+    fprintf(out, "%-26s %d\n", "  longest queue", device->max_queue);
+    if (config->discipline == IO_DEADLINE) {
+        fprintf(out, "%-26s %d\n", "  deadline misses", device->deadline_misses);
+    }
+}
+
+bool parse_device(const char *text, DeviceConfig *config) {
+    char name[DEVICE_NAME_LENGTH], discipline[16];
+    int concurrency;
+    if (sscanf(text, "%15[^:]:%15[^:]:%d", name, discipline, &concurrency) != 3 ||
+        concurrency < 1 || concurrency > MAX_DEVICE_SLOTS) {
+        return false;
+    }
+    memset(config, 0, sizeof(DeviceConfig));
+    strcpy(config->name, name);
+    config->concurrency = concurrency;
+    if (strcmp(discipline, "fifo") == 0) config->discipline = IO_FIFO;
+    else if (strcmp(discipline, "scan") == 0) config->discipline = IO_SCAN;
+    else if (strcmp(discipline, "deadline") == 0) config->discipline = IO_DEADLINE;
+    else return false;
+    return true;
+}
+
+const char *io_discipline_name(IoDiscipline discipline) {
+    switch (discipline) {
+        case IO_FIFO:     return "fifo";
+        case IO_SCAN:     return "scan";
+        case IO_DEADLINE: return "deadline";
+    }
+    return "";
+}
@@ -0,0 +1,63 @@
+#ifndef IO_H
+#define IO_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+// I/O devices behind the BLOCK instruction. BLOCK -N asks the device of the process, pid - 1 wrapped
+// to the configured devices, for N ticks of service, as long as a plain BLOCK -N waits. Each device
+// queues the requests it cannot start yet and serves at most `concurrency` of them at a time, picked
+// by its discipline.
+
+#define MAX_DEVICES 4
+#define MAX_DEVICE_SLOTS 20 // As many as processes, so a device can be made contention free
+#define DEVICE_NAME_LENGTH 16
+#define DEFAULT_IO_DEADLINE 8
+
+typedef enum { IO_FIFO, IO_SCAN, IO_DEADLINE } IoDiscipline;
+
+typedef struct {
+    char name[DEVICE_NAME_LENGTH];
+    int discipline;  // IoDiscipline
+    int concurrency; // Requests served at the same time (1 to MAX_DEVICE_SLOTS)
+} DeviceConfig;
+
+typedef struct {
+    int pid;
+    int track;     // Position on the device, what SCAN orders requests by
+    int duration;  // Ticks of service
+    int submitted; // First tick the request could have started
+    int deadline;  // Tick after which the deadline discipline serves it first
+} IoRequest;
+
+// State and counters of one device, all ints so a checkpoint can store it as it is
+typedef struct {
+    IoRequest queue[MAX_DEVICE_SLOTS]; // Waiting requests in arrival order (one per process at most)
+    int queued;
+    int slot_pid[MAX_DEVICE_SLOTS];    // Request in service in each slot, 0 when free
+    int slot_done[MAX_DEVICE_SLOTS];   // Tick its process leaves BLOCKED
+    int head;                          // Track of the last request started
+    int direction;                     // SCAN sweep, 1 towards higher tracks, -1 towards lower
+    int requests;
+    int busy_ticks;                    // Slot ticks spent serving requests
+    int wait_total;                    // Ticks requests spent queued before service
+    int max_wait;
+    int max_queue;
+    int deadline_misses;               // Requests started after their deadline
+} Device;
+
+void device_init(Device *device);
+// Returns false if the queue is full
+bool device_submit(Device *device, IoRequest request);
+// Frees the slots whose requests end by now and starts queued requests in the free ones.
+// The pids started are written to started_pids with the tick they finish in done_times; returns their count.
+int device_dispatch(Device *device, const DeviceConfig *config, int now, int started_pids[], int done_times[]);
+// Adds the slots in service to the busy time (called once per tick)
+void device_account(Device *device, const DeviceConfig *config);
+void device_print_stats(const Device *device, const DeviceConfig *config, int ticks, FILE *out);
+
+// Reads "name:discipline:concurrency", like "disk:scan:1"
+bool parse_device(const char *text, DeviceConfig *config);
+const char *io_discipline_name(IoDiscipline discipline);
+
+#endif // IO_H
@@ -1,20 +1,311 @@
 #include "p2_simulator.h"
 #include "inputs_part2.h" // Assuming new inputs are here
+#include "workload.h"
+#include "checkpoint.h"
 
 // Define the number of inputs
 #define NUM_INPUTS 12
 
-int main() {
+void print_usage(const char *program_name) {
+    fprintf(stderr, "Usage: %s [options]\n", program_name);
+    fprintf(stderr, "  --stats         Append run statistics to every output file\n");
+    fprintf(stderr, "  --input FILE    Simulate a generated program file instead of the built-in inputs\n");
+    fprintf(stderr, "  --programs FILE Simulate a program store file (\"programs N\", then memory size, count and\n");
+    fprintf(stderr, "                  instructions of each): any number of programs of any length\n");
+    fprintf(stderr, "  --frames N      Frames of physical memory (default %d, at most %d)\n", NUM_FRAMES, MAX_FRAMES);
+    fprintf(stderr, "  --quantum N     Round robin time slice in ticks (default %d)\n", DEFAULT_QUANTUM);
+    fprintf(stderr, "  --policy NAME   Page replacement policy, lru or fifo (default lru)\n");
+    fprintf(stderr, "  --prefetch K    Read ahead K pages on faults of strided processes\n");
+    fprintf(stderr, "  --load-control  Swap out whole processes while the working sets exceed the frames\n");
+    fprintf(stderr, "  --ws-window N   Working set window in ticks (default 5)\n");
+    fprintf(stderr, "  --ws-suspend N  Suspend while the total working set is above N frames\n");
+    fprintf(stderr, "  --ws-resume N   Resume while the total working set stays at or below N frames\n");
+    fprintf(stderr, "  --cow           FORK (300) shares pages copy-on-write, 16000-30999 are STOREs\n");
+    fprintf(stderr, "  --alloc NAME    Contiguous allocation instead of paging: first, best, next or buddy\n");
+    fprintf(stderr, "  --compact       With --alloc, compact memory when a process fits only the free total\n");
+    fprintf(stderr, "  --io            Send BLOCK -N to device (pid-1) mod devices for N ticks (default disk:scan:1 and net:fifo:4)\n");
+    fprintf(stderr, "  --device SPEC   Replace the default devices, repeatable: name:fifo|scan|deadline:concurrency\n");
+    fprintf(stderr, "  --io-deadline N Ticks a request waits before the deadline discipline serves it first (default %d)\n",
+            DEFAULT_IO_DEADLINE);
+    fprintf(stderr, "  --sync          400-409 LOCK and 410-419 UNLOCK mutexes, 420-429 P and 430-439 V semaphores\n");
+    fprintf(stderr, "  --spin          With --sync, waiters spin on the CPU instead of blocking\n");
+    fprintf(stderr, "  --inherit       With --sync, mutex owners inherit the priority of their waiters\n");
+    fprintf(stderr, "  --priorities L  Schedule by priority, one per program: 1,0,0,2,0 (higher first)\n");
+    fprintf(stderr, "  --semaphores N  Initial value of every semaphore (default 1)\n");
+    fprintf(stderr, "  --edf           Preemptive earliest deadline first scheduling of periodic programs\n");
+    fprintf(stderr, "  --rm            Preemptive rate monotonic scheduling of periodic programs\n");
+    fprintf(stderr, "  --periods L     Period of each program, 0 for best effort: 20,0,0,30,0\n");
+    fprintf(stderr, "  --deadlines L   Relative deadline of each program (default the period)\n");
+    fprintf(stderr, "  --cache         Run LOAD and STORE through L1, L2 and LLC caches (512 B, 2 KB, 8 KB)\n");
+    fprintf(stderr, "  --cache-level SPEC  Replace the default levels, repeatable: size:line:ways[:lru|fifo|random]\n");
+    fprintf(stderr, "  --cache-pollute P   Percent of the cached lines lost on every context switch (default 0)\n");
+    fprintf(stderr, "  --kswapd LOW:HIGH[:BATCH]  Reclaim in the background below LOW free frames up to HIGH,\n");
+    fprintf(stderr, "                  BATCH pages per tick (default 1)\n");
+    fprintf(stderr, "  --checkpoint-every N  Write <output>_t<tick>.ckpt every N ticks of every run\n");
+    fprintf(stderr, "  --restore FILE  Continue a run from a checkpoint into output2T_restored.out\n");
+}
+
+// Read the command line into config. Any option also turns on the statistics block.
+bool parse_options(int argc, char *argv[], SimulationConfig *config, bool *print_stats, const char **input_path,
+                   const char **programs_path, const char **restore_path) {
+    bool suspend_given = false, resume_given = false;
+    int devices_given = 0, cache_levels_given = 0;
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--stats") == 0) {
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--input") == 0 && has_value) {
+            *input_path = argv[++i];
+        } else if (strcmp(argv[i], "--programs") == 0 && has_value) {
+            *programs_path = argv[++i];
+        } else if (strcmp(argv[i], "--frames") == 0 && has_value) {
+            config->num_frames = atoi(argv[++i]);
+            if (config->num_frames < 1 || config->num_frames > MAX_FRAMES) return false;
+        } else if (strcmp(argv[i], "--quantum") == 0 && has_value) {
+            config->quantum = atoi(argv[++i]);
+            if (config->quantum < 1) return false;
+        } else if (strcmp(argv[i], "--policy") == 0 && has_value) {
+            const char *policy = argv[++i];
+            if (strcmp(policy, "lru") == 0) config->policy = POLICY_LRU;
+            else if (strcmp(policy, "fifo") == 0) config->policy = POLICY_FIFO;
+            else return false;
+        } else if (strcmp(argv[i], "--prefetch") == 0 && has_value) {
+            config->prefetch_depth = atoi(argv[++i]);
+            if (config->prefetch_depth < 0) return false;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--load-control") == 0) {
+            config->load_control = true;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--ws-window") == 0 && has_value) {
+            config->ws_window = atoi(argv[++i]);
+            if (config->ws_window < 1) return false;
+        } else if (strcmp(argv[i], "--ws-suspend") == 0 && has_value) {
+            config->suspend_threshold = atoi(argv[++i]);
+            suspend_given = true;
+        } else if (strcmp(argv[i], "--ws-resume") == 0 && has_value) {
+            config->resume_threshold = atoi(argv[++i]);
+            resume_given = true;
+        } else if (strcmp(argv[i], "--cow") == 0) {
+            config->cow_fork = true;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--alloc") == 0 && has_value) {
+            if (!parse_alloc_strategy(argv[++i], &config->alloc_strategy)) return false;
+            config->contiguous = true;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--compact") == 0) {
+            config->compaction = true;
+        } else if (strcmp(argv[i], "--io") == 0) {
+            config->io_model = true;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--device") == 0 && has_value) {
+            if (devices_given == MAX_DEVICES || !parse_device(argv[++i], &config->devices[devices_given])) return false;
+            config->num_devices = ++devices_given;
+            config->io_model = true;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--io-deadline") == 0 && has_value) {
+            config->io_deadline = atoi(argv[++i]);
+            if (config->io_deadline < 0) return false;
+        } else if (strcmp(argv[i], "--sync") == 0) {
+            config->sync = true;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--spin") == 0) {
+            config->spin_locks = true;
+        } else if (strcmp(argv[i], "--inherit") == 0) {
+            config->priority_inheritance = true;
+        } else if (strcmp(argv[i], "--priorities") == 0 && has_value) {
+            int *p = config->priorities;
+            if (sscanf(argv[++i], "%d,%d,%d,%d,%d", &p[0], &p[1], &p[2], &p[3], &p[4]) != 5) return false;
+            config->priority_scheduling = true;
+        } else if (strcmp(argv[i], "--semaphores") == 0 && has_value) {
+            config->semaphore_initial = atoi(argv[++i]);
+            if (config->semaphore_initial < 0) return false;
+        } else if (strcmp(argv[i], "--edf") == 0 || strcmp(argv[i], "--rm") == 0) {
+            config->rt_policy = strcmp(argv[i], "--edf") == 0 ? RT_EDF : RT_RM;
+            *print_stats = true;
+        } else if ((strcmp(argv[i], "--periods") == 0 || strcmp(argv[i], "--deadlines") == 0) && has_value) {
+            int *p = strcmp(argv[i], "--periods") == 0 ? config->periods : config->deadlines;
+            if (sscanf(argv[++i], "%d,%d,%d,%d,%d", &p[0], &p[1], &p[2], &p[3], &p[4]) != 5) return false;
+            for (int j = 0; j < 5; j++) {
+                if (p[j] < 0) return false;
+            }
+        } else if (strcmp(argv[i], "--cache") == 0) {
+            config->cache = true;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--cache-level") == 0 && has_value) {
+            if (cache_levels_given == CACHE_LEVELS || !parse_cache_level(argv[++i], &config->cache_levels[cache_levels_given])) {
+                return false;
+            }
+            config->num_cache_levels = ++cache_levels_given;
+            config->cache = true;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--cache-pollute") == 0 && has_value) {
+            config->cache_pollution = atoi(argv[++i]);
+            if (config->cache_pollution < 0 || config->cache_pollution > 100) return false;
+        } else if (strcmp(argv[i], "--kswapd") == 0 && has_value) {
+            config->kswapd_batch = 1;
+            if (sscanf(argv[++i], "%d:%d:%d", &config->low_watermark, &config->high_watermark, &config->kswapd_batch) < 2 ||
+                config->low_watermark < 1 || config->high_watermark < config->low_watermark || config->kswapd_batch < 1) {
+                return false;
+            }
+            config->kswapd = true;
+            *print_stats = true;
+        } else if (strcmp(argv[i], "--checkpoint-every") == 0 && has_value) {
+            config->checkpoint_interval = atoi(argv[++i]);
+            if (config->checkpoint_interval < 1) return false;
+        } else if (strcmp(argv[i], "--restore") == 0 && has_value) {
+            *restore_path = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    // Partitions replace frames, so the paging features do not apply to them
+    if (config->contiguous && (config->cow_fork || config->load_control || config->prefetch_depth > 0)) return false;
+    if (config->kswapd && (config->contiguous || config->high_watermark > config->num_frames)) return false;
+    // A suspended waiter could be handed a mutex it cannot release
+    if (config->sync && config->load_control) return false;
+    // Real-time scheduling owns the ready processes, in its heap
+    if (config->rt_policy != RT_NONE && (config->priority_scheduling || config->load_control)) return false;
+    // Both replace the built-in inputs
+    if (*input_path != NULL && *programs_path != NULL) return false;
+    // Load control thresholds follow the memory size unless they are given
+    if (!suspend_given) config->suspend_threshold = config->num_frames;
+    if (!resume_given) config->resume_threshold = config->num_frames - 1;
+    return true;
+}
+
+#ifdef _WIN32
+    #define NULL_DEVICE "NUL"
+#else
+    #define NULL_DEVICE "/dev/null"
+#endif
+
+// A loaded program store takes the place of the input
+bool start_system(SimulationSystem *system, SimulationInput input, const ProgramStore *programs,
+                  const SimulationConfig *config) {
+    if (programs == NULL) {
+        initialize_system_with_config(system, input, config);
+        return true;
+    }
+    return initialize_system_with_programs(system, programs, config);
+}
+
+// Run an input with load control turned off and its table discarded, to get the baseline counters
+SimulationStats run_without_load_control(SimulationInput input, const ProgramStore *programs,
+                                         const SimulationConfig *config) {
+    SimulationConfig baseline_config = *config;
+    baseline_config.load_control = false;
+    baseline_config.checkpoint_interval = 0; // The checkpoints belong to the real run
+
+    SimulationSystem baseline;
+    freopen(NULL_DEVICE, "w", stdout);
+    if (start_system(&baseline, input, programs, &baseline_config)) run_simulation(&baseline);
+    SimulationStats stats = baseline.stats;
+    destroy_system(&baseline);
+    fclose(stdout);
+    return stats;
+}
+
+void print_load_control_gain(const SimulationStats *baseline, const SimulationStats *controlled) {
+    double base_rate = baseline->memory_accesses > 0 ? (double)baseline->page_faults / baseline->memory_accesses : 0.0;
+    double rate = controlled->memory_accesses > 0 ? (double)controlled->page_faults / controlled->memory_accesses : 0.0;
+    printf("%-26s %.3f\n", "fault rate without control", base_rate);
+    printf("%-26s %.3f\n", "fault rate reduction", base_rate - rate);
+}
+
+// Continue a checkpointed run. The table gets a header and then the rows after the checkpoint tick.
+int run_restored(const char *path, const SimulationConfig *config, bool print_stats) {
+    SimulationSystem system;
+    if (!load_checkpoint(&system, path)) {
+        fprintf(stderr, "Invalid checkpoint: %s\n", path);
+        return 1;
+    }
+    system.config.checkpoint_interval = config->checkpoint_interval;
+    system.config.checkpoint_prefix = "output2T_restored";
+
+    if (freopen("output2T_restored.out", "w", stdout) == NULL) {
+        perror("Error opening output file");
+        destroy_system(&system);
+        return 1;
+    }
+    print_table_header(&system);
+    resume_simulation(&system);
+    if (print_stats) print_statistics(&system);
+    destroy_system(&system);
+    fclose(stdout);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    SimulationConfig config = default_config();
+    bool print_stats = false;
+    const char *input_path = NULL;
+    const char *programs_path = NULL;
+    const char *restore_path = NULL;
+    if (!parse_options(argc, argv, &config, &print_stats, &input_path, &programs_path, &restore_path)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (restore_path != NULL) {
+        return run_restored(restore_path, &config, print_stats);
+    }
+
     SimulationInput inputs[NUM_INPUTS] = {
         {input00, 8}, {input01, 6}, {input02, 5}, {input03, 6}, {input04, 6},
         {input05, 6}, {input06, 5}, {input07, 12}, {input08, 12}, {input09, 12},
         {input10, 12}, {input11, 12}
     };
+    int num_inputs = NUM_INPUTS;
 
-    for (int i = 0; i < NUM_INPUTS; i++) {
+    // A program file replaces the built-in inputs and is written to output2T_file.out
+    if (input_path != NULL) {
+        FILE *file = fopen(input_path, "r");
+        if (file == NULL) {
+            perror("Error opening program file");
+            return 1;
+        }
+        bool loaded = load_programs_text(file, &inputs[0]);
+        fclose(file);
+        if (!loaded) {
+            fprintf(stderr, "Invalid program file: %s\n", input_path);
+            return 1;
+        }
+        num_inputs = 1;
+    }
+    ProgramStore store;
+    const ProgramStore *programs = NULL;
+    if (programs_path != NULL) {
+        FILE *file = fopen(programs_path, "rb");
+        if (file == NULL) {
+            perror("Error opening program file");
+            return 1;
+        }
+        bool loaded = program_store_load(file, &store);
+        fclose(file);
+        if (!loaded) {
+            fprintf(stderr, "Invalid program store: %s\n", programs_path);
+            return 1;
+        }
+        programs = &store;
+        num_inputs = 1;
+    }
+
+    for (int i = 0; i < num_inputs; i++) {
         SimulationSystem system;
         char filename[20];
-        snprintf(filename, sizeof(filename), "output2T%02d.out", i);
+        char checkpoint_prefix[20];
+        if (input_path != NULL || programs != NULL) {
+            snprintf(filename, sizeof(filename), "output2T_file.out");
+            snprintf(checkpoint_prefix, sizeof(checkpoint_prefix), "output2T_file");
+        } else {
+            snprintf(filename, sizeof(filename), "output2T%02d.out", i);
+            snprintf(checkpoint_prefix, sizeof(checkpoint_prefix), "output2T%02d", i);
+        }
+        config.checkpoint_prefix = checkpoint_prefix;
+
+        SimulationStats baseline_stats;
+        if (config.load_control) {
+            baseline_stats = run_without_load_control(inputs[i], programs, &config);
+        }
 
         FILE* output_file = freopen(filename, "w", stdout);
         if (output_file == NULL) {
@@ -22,25 +313,19 @@ int main() {
             continue;
         }
 
-        initialize_system_with_input(&system, inputs[i]);
+        if (!start_system(&system, inputs[i], programs, &config)) {
+            fprintf(stderr, "Out of memory for the programs\n");
+            destroy_system(&system);
+            fclose(stdout);
+            continue;
+        }
         run_simulation(&system);
-
-        // Cleanup any remaining processes (for safety, though run_simulation should handle it)
-        for (int j = 0; j < MAX_PROCESSES; j++) {
-            if (system.processes[j] != NULL) {
-                if (system.processes[j]->instructions) {
-                    free(system.processes[j]->instructions);
-                }
-                free(system.processes[j]);
-                system.processes[j] = NULL;
-            }
+        if (print_stats) print_statistics(&system);
+        if (config.load_control) {
+            print_load_control_gain(&baseline_stats, &system.stats);
         }
 
-        // Cleanup queues
-        if (system.new_queue) deleteQueue(system.new_queue);
-        if (system.ready_queue) deleteQueue(system.ready_queue);
-        if (system.blocked_queue) deleteQueue(system.blocked_queue);
-        if (system.exit_queue) deleteQueue(system.exit_queue);
+        destroy_system(&system);
 
         fclose(stdout);
     }
@@ -51,7 +336,9 @@ int main() {
     #else
         freopen("/dev/tty", "w", stdout);
     #endif
-    printf("Generated output files for %d test cases.\n", NUM_INPUTS);
+    printf("Generated output files for %d test cases.\n", num_inputs);
+    if (input_path != NULL) free(inputs[0].programs);
+    if (programs != NULL) program_store_destroy(&store);
 
 
     return 0;
@@ -0,0 +1,10 @@
+#ifndef P2_REFERENCE_H
+#define P2_REFERENCE_H
+
+#include "p2_simulator.h"
+
+// The original engine, kept unchanged as the oracle for optimized engines.
+// It always uses 7 frames, a quantum of 3 and LRU, and ignores SimulationConfig.
+void run_reference_simulation(SimulationInput input);
+
+#endif // P2_REFERENCE_H
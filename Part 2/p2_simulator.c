@@ -1,20 +1,55 @@
 #include "p2_simulator.h"
+#include "checkpoint.h"
+#include "profile.h"
 
 // --- Memory Management Helpers ---
 
 void initialize_memory(SimulationSystem* system) {
-    for (int i = 0; i < NUM_FRAMES; i++) {
+    for (int i = 0; i < system->config.num_frames; i++) {
         system->physical_memory[i].frame_id = i;
         system->physical_memory[i].process_id = -1;
         system->physical_memory[i].page_number = -1;
         system->physical_memory[i].load_time = -1;
         system->physical_memory[i].last_access_time = -1;
+        system->physical_memory[i].sharers = 0;
+    }
+}
+
+// True if the process owns the frame or shares it copy-on-write
+bool frame_mapped_by(const Frame *frame, int pid) {
+    return frame->process_id == pid || (pid >= 1 && (frame->sharers & (1u << (pid - 1))) != 0);
+}
+
+// Number of processes mapping the frame
+int frame_ref_count(const Frame *frame) {
+    if (frame->process_id == -1) return 0;
+    int count = 1;
+    for (unsigned int bits = frame->sharers; bits != 0; bits &= bits - 1) count++;
+    return count;
+}
+
+// Removes one process from the frame. A sharer takes over as owner, and the frame is freed with its last user.
+void unmap_frame(Frame *frame, int pid) {
+    if (frame->process_id == pid) {
+        if (frame->sharers != 0) {
+            int bit = 0;
+            while ((frame->sharers & (1u << bit)) == 0) bit++;
+            frame->process_id = bit + 1;
+            frame->sharers &= ~(1u << bit);
+            return;
+        }
+        frame->process_id = -1; // Mark frame as free
+        frame->page_number = -1;
+        frame->load_time = -1;
+        frame->last_access_time = -1;
+    } else if (pid >= 1) {
+        frame->sharers &= ~(1u << (pid - 1));
     }
 }
 
 int find_page_in_memory(SimulationSystem* system, int pid, int page_num) {
-    for (int i = 0; i < NUM_FRAMES; i++) {
-        if (system->physical_memory[i].process_id == pid && system->physical_memory[i].page_number == page_num) {
+    for (int i = 0; i < system->config.num_frames; i++) {
+        if (frame_mapped_by(&system->physical_memory[i], pid) && system->physical_memory[i].page_number == page_num) {
             return i; // Return frame index
         }
     }
@@ -22,7 +57,7 @@ int find_page_in_memory(SimulationSystem* system, int pid, int page_num) {
 }
 
 int find_free_frame(SimulationSystem* system) {
-    for (int i = 0; i < NUM_FRAMES; i++) {
+    for (int i = 0; i < system->config.num_frames; i++) {
         if (system->physical_memory[i].process_id == -1) {
             return i; // Return frame index
         }
@@ -34,7 +69,7 @@ int find_free_frame(SimulationSystem* system) {
 int find_victim_lru(SimulationSystem* system) {
     int victim_frame_idx = -1;
     int min_access_time = INT_MAX;
-    for (int i = 0; i < NUM_FRAMES; i++) {
+    for (int i = 0; i < system->config.num_frames; i++) {
         if (system->physical_memory[i].last_access_time < min_access_time) {
             min_access_time = system->physical_memory[i].last_access_time;
             victim_frame_idx = i;
@@ -48,15 +83,160 @@ int find_victim_lru(SimulationSystem* system) {
     return victim_frame_idx;
 }
 
+// FIFO: the page loaded first, with Frame ID as tie-breaker
+int find_victim_fifo(SimulationSystem* system) {
+    int victim_frame_idx = -1;
+    int min_load_time = INT_MAX;
+    for (int i = 0; i < system->config.num_frames; i++) {
+        if (system->physical_memory[i].load_time < min_load_time) {
+            min_load_time = system->physical_memory[i].load_time;
+            victim_frame_idx = i;
+        }
+    }
+    return victim_frame_idx;
+}
+
+int find_victim(SimulationSystem* system) {
+    if (system->config.policy == POLICY_FIFO) return find_victim_fifo(system);
+    return find_victim_lru(system);
+}
+
 void load_page_into_frame(SimulationSystem* system, int frame_idx, int pid, int page_num, int time) {
     system->physical_memory[frame_idx].process_id = pid;
     system->physical_memory[frame_idx].page_number = page_num;
     system->physical_memory[frame_idx].load_time = time;
     system->physical_memory[frame_idx].last_access_time = time;
+    system->physical_memory[frame_idx].prefetched = false;
+    system->physical_memory[frame_idx].sharers = 0; // Evicting a shared frame unmaps it from every sharer
+}
+
+// Follows the page changes of a process to detect sequential or strided access
+void update_stride(PCB* proc, int page_num) {
+    if (proc->last_page != -1 && page_num != proc->last_page) {
+        int delta = page_num - proc->last_page;
+        proc->stride_confirmed = (delta == proc->stride);
+        proc->stride = delta;
+    }
+    proc->last_page = page_num;
+}
+
+// Counts a prefetched page that is replaced without ever being used
+void note_eviction(SimulationSystem* system, int frame_idx) {
+    Frame *frame = &system->physical_memory[frame_idx];
+    if (frame->process_id != -1 && frame->prefetched) {
+        system->stats.prefetch_unused++;
+    }
+}
+
+// Read ahead the next pages of a strided process after a fault.
+// Free frames are used first, then the policy's victim, but never the frame that was just faulted in.
+void prefetch_pages(SimulationSystem* system, PCB* proc, int page_num, int faulted_idx) {
+    if (system->config.prefetch_depth <= 0 || !proc->stride_confirmed) return;
+    int highest_page = (proc->memory_size - 1) / PAGE_SIZE;
+
+    for (int k = 1; k <= system->config.prefetch_depth; k++) {
+        int next_page = page_num + proc->stride * k;
+        if (next_page < 0 || next_page > highest_page) break;
+        if (find_page_in_memory(system, proc->pid, next_page) != -1) continue;
+
+        int frame_idx = find_free_frame(system);
+        if (frame_idx == -1) {
+            // Hide the faulted page from the victim search (it was loaded and used just now)
+            system->physical_memory[faulted_idx].last_access_time = INT_MAX;
+            system->physical_memory[faulted_idx].load_time = INT_MAX;
+            frame_idx = find_victim(system);
+            system->physical_memory[faulted_idx].last_access_time = system->current_time;
+            system->physical_memory[faulted_idx].load_time = system->current_time;
+            if (frame_idx == -1 || frame_idx == faulted_idx) break;
+            note_eviction(system, frame_idx);
+            if (!system->physical_memory[frame_idx].prefetched) {
+                system->stats.prefetch_evictions++;
+            }
+        }
+        load_page_into_frame(system, frame_idx, proc->pid, next_page, system->current_time);
+        system->physical_memory[frame_idx].prefetched = true;
+        system->stats.prefetches++;
+    }
+}
+// A STORE to a frame other processes still map: the page is copied into a frame of its own first.
+// Returns the frame the writer uses from now on.
+int copy_on_write(SimulationSystem* system, PCB* proc, int frame_idx) {
+    Frame *shared = &system->physical_memory[frame_idx];
+    system->stats.cow_faults++;
+    int copy_idx = find_free_frame(system);
+    if (copy_idx == -1) {
+        // The shared frame is the one being copied, so it cannot be the victim
+        int last_access_time = shared->last_access_time, load_time = shared->load_time;
+        shared->last_access_time = INT_MAX;
+        shared->load_time = INT_MAX;
+        copy_idx = find_victim(system);
+        shared->last_access_time = last_access_time;
+        shared->load_time = load_time;
+        if (copy_idx == -1 || copy_idx == frame_idx) {
+            // Only one frame: the writer keeps it and the other processes lose the page
+            shared->process_id = proc->pid;
+            shared->sharers = 0;
+            return frame_idx;
+        }
+        note_eviction(system, copy_idx);
+    }
+    load_page_into_frame(system, copy_idx, proc->pid, shared->page_number, system->current_time);
+    unmap_frame(shared, proc->pid);
+    return copy_idx;
+}
+
+// Coldest resident page for the policy, free frames aside, lower frame on ties
+static int find_cold_frame(SimulationSystem* system) {
+    int victim_frame_idx = -1, min_time = INT_MAX;
+    for (int i = 0; i < system->config.num_frames; i++) {
+        const Frame *frame = &system->physical_memory[i];
+        int time = system->config.policy == POLICY_FIFO ? frame->load_time : frame->last_access_time;
+        if (frame->process_id != -1 && time < min_time) {
+            min_time = time;
+            victim_frame_idx = i;
+        }
+    }
+    return victim_frame_idx;
+}
+
+// Background reclaim, like kswapd. The daemon wakes when the free frames fall below the low watermark
+// and evicts the pages the replacement policy would pick, kswapd_batch per tick, until the high
+// watermark is reached, so that faults find a free frame instead of evicting on their own.
+void run_kswapd(SimulationSystem* system) {
+    int free_frames = 0;
+    for (int i = 0; i < system->config.num_frames; i++) {
+        if (system->physical_memory[i].process_id == -1) free_frames++;
+    }
+    if (!system->kswapd_awake && free_frames < system->config.low_watermark) {
+        system->kswapd_awake = true;
+        system->stats.kswapd_wakeups++;
+    }
+    if (!system->kswapd_awake) return;
+    system->stats.kswapd_ticks++;
+    for (int n = 0; n < system->config.kswapd_batch && free_frames < system->config.high_watermark; n++) {
+        int victim_idx = find_cold_frame(system);
+        if (victim_idx == -1) break;
+        Frame *frame = &system->physical_memory[victim_idx];
+        note_eviction(system, victim_idx);
+        unsigned int bit = frame->page_number < 32 ? 1u << frame->page_number : 0;
+        system->reclaimed_pages[frame->process_id - 1] |= bit;
+        for (unsigned int bits = frame->sharers; bits != 0; bits &= bits - 1) {
+            int sharer = 0;
+            while ((bits & (1u << sharer)) == 0) sharer++;
+            system->reclaimed_pages[sharer] |= bit;
+        }
+        frame->sharers = 0;
+        unmap_frame(frame, frame->process_id);
+        system->stats.kswapd_reclaimed++;
+        free_frames++;
+    }
+    if (free_frames >= system->config.high_watermark) {
+        system->kswapd_awake = false;
+    }
 }
 
 // Handle memory access and SIGSEGV
-int handle_memory_access(SimulationSystem* system, PCB* proc, int address) {
+int handle_memory_access(SimulationSystem* system, PCB* proc, int address, bool write) {
     // Check if address is within the process's allocated memory space
     if (address < 0 || address >= proc->memory_size) {
         return 0; // Invalid access, triggers SIGSEGV
@@ -64,67 +244,173 @@ int handle_memory_access(SimulationSystem* system, PCB* proc, int address) {
 
     int page_needed = address / PAGE_SIZE;
     int frame_idx = find_page_in_memory(system, proc->pid, page_needed);
+    system->stats.memory_accesses++;
+    update_stride(proc, page_needed);
+    if (page_needed < proc->page_count) {
+        proc->page_last_ref[page_needed] = system->current_time;
+    }
+    if (system->config.contiguous) {
+        if (system->config.cache) {
+            cache_access(&system->cache, proc->pid, allocator_find(&system->allocator, proc->pid)->start + address);
+        }
+        return 1; // The whole image is in the process's partition
+    }
+
+    if (frame_idx != -1 && write && frame_ref_count(&system->physical_memory[frame_idx]) > 1) {
+        frame_idx = copy_on_write(system, proc, frame_idx);
+    }
 
     if (frame_idx != -1) {
         // Page hit, update last access time for LRU
         system->physical_memory[frame_idx].last_access_time = system->current_time;
+        if (system->physical_memory[frame_idx].prefetched) {
+            system->physical_memory[frame_idx].prefetched = false;
+            system->stats.prefetch_hits++;
+        }
     } else {
         // Page fault
+        system->stats.page_faults++;
+        if (page_needed < 32 && (system->reclaimed_pages[proc->pid - 1] & (1u << page_needed)) != 0) {
+            system->reclaimed_pages[proc->pid - 1] &= ~(1u << page_needed);
+            system->stats.kswapd_refaults++;
+        }
         int free_frame_idx = find_free_frame(system);
         if (free_frame_idx != -1) {
             // Load into a free frame
+            system->stats.free_frame_faults++;
             load_page_into_frame(system, free_frame_idx, proc->pid, page_needed, system->current_time);
+            prefetch_pages(system, proc, page_needed, free_frame_idx);
+            frame_idx = free_frame_idx;
         } else {
-            // No free frames, find a victim using LRU
-            int victim_idx = find_victim_lru(system);
+            // No free frames, find a victim with the replacement policy
+            system->stats.direct_reclaims++;
+            int victim_idx = find_victim(system);
+            note_eviction(system, victim_idx);
             load_page_into_frame(system, victim_idx, proc->pid, page_needed, system->current_time);
+            prefetch_pages(system, proc, page_needed, victim_idx);
+            frame_idx = victim_idx;
         }
     }
+    if (system->config.cache) {
+        cache_access(&system->cache, proc->pid, frame_idx * PAGE_SIZE + address % PAGE_SIZE);
+    }
     return 1;
 }
 
+// Free every frame owned by a process. Shared frames stay with the other processes that map them.
+void release_frames(SimulationSystem* system, int pid) {
+    if (system->config.contiguous) {
+        allocator_free(&system->allocator, pid);
+    }
+    for (int f = 0; f < system->config.num_frames; f++) {
+        if (frame_mapped_by(&system->physical_memory[f], pid)) {
+            unmap_frame(&system->physical_memory[f], pid);
+        }
+    }
+}
+
+void free_process(PCB* proc) {
+    if (proc->instructions) free(proc->instructions);
+    if (proc->page_last_ref) free(proc->page_last_ref);
+    free(proc);
+}
+
 // Terminating a process moves it to the EXIT state
 void terminate_process(SimulationSystem* system, PCB* proc, const char* reason) {
     proc->state = EXIT;
     proc->error_message = reason;
     proc->time_in_state = 0; // Reset timer for the EXIT state
+    if (system->config.sync) release_locks(system, proc);
     enqueue(system->exit_queue, proc);
     if (system->running_process == proc) {
         system->running_process = NULL;
     }
 }
 
-// Read memory size from first line of input
+// Configuration that reproduces the standard output files
+SimulationConfig default_config(void) {
+    SimulationConfig config;
+    memset(&config, 0, sizeof(config));
+    config.num_frames = NUM_FRAMES;
+    config.quantum = DEFAULT_QUANTUM;
+    config.policy = POLICY_LRU;
+    config.prefetch_depth = 0;
+    config.load_control = false;
+    config.ws_window = 5;
+    config.suspend_threshold = NUM_FRAMES;
+    config.resume_threshold = NUM_FRAMES - 1;
+    // A disk that serves one request at a time in elevator order, and a network link with four channels
+    config.num_devices = 2;
+    config.devices[0] = (DeviceConfig){"disk", IO_SCAN, 1};
+    config.devices[1] = (DeviceConfig){"net", IO_FIFO, 4};
+    config.io_deadline = DEFAULT_IO_DEADLINE;
+    config.semaphore_initial = 1;
+    config.num_cache_levels = CACHE_LEVELS;
+    cache_default_levels(config.cache_levels);
+    config.low_watermark = 1;
+    config.high_watermark = 2;
+    config.kswapd_batch = 1;
+    return config;
+}
+
 void initialize_system_with_input(SimulationSystem *system, SimulationInput input) {
+    SimulationConfig config = default_config();
+    initialize_system_with_config(system, input, &config);
+}
+
+// Everything but the programs
+static void init_system(SimulationSystem *system, const SimulationConfig *config) {
     memset(system, 0, sizeof(SimulationSystem));
+    system->config = *config;
+    system->out = stdout;
 
     system->ready_queue = createQueue();
     system->new_queue = createQueue();
     system->blocked_queue = createQueue();
     system->exit_queue = createQueue();
+    system->suspended_queue = createQueue();
     
     system->running_process = NULL;
     system->next_pid = 1;
     system->current_time = 0;
 
     initialize_memory(system);
+    for (int d = 0; d < MAX_DEVICES; d++) {
+        device_init(&system->devices[d]);
+    }
+    for (int i = 0; i < NUM_SEMAPHORES; i++) {
+        system->semaphores[i].count = system->config.semaphore_initial;
+    }
+    if (system->config.contiguous) {
+        allocator_init(&system->allocator, system->config.alloc_strategy, system->config.num_frames * PAGE_SIZE,
+                       system->config.compaction);
+    }
+    if (system->config.cache) {
+        cache_init(&system->cache, system->config.cache_levels, system->config.num_cache_levels, MAX_PROCESSES,
+                   system->config.cache_pollution);
+    }
 
     for (int i = 0; i < MAX_PROCESSES; ++i) {
         system->processes[i] = NULL;
 
     }
+}
 
+// Read memory size from first line of input
+void initialize_system_with_config(SimulationSystem *system, SimulationInput input, const SimulationConfig *config) {
+    init_system(system, config);
+
+    // The five programs fit in a few hundred instructions, so they are reserved at once
+    program_store_reserve(&system->programs, 5, 5 * MAX_PROGRAM_INSTRUCTIONS);
     for (int prog_id = 0; prog_id < 5; prog_id++) {
         // First row contains the process memory size in bytes
-        system->program_mem_sizes[prog_id] = input.programs[0][prog_id];
-        system->program_lengths[prog_id] = 0;
+        program_store_begin(&system->programs, input.programs[0][prog_id]);
 
         // Subsequent rows contain instructions
         for (int step = 1; step < input.rows; step++) {
             int instruction = input.programs[step][prog_id];
-            if(system->program_lengths[prog_id] < MAX_PROGRAM_INSTRUCTIONS) {
-                 system->programs[prog_id][system->program_lengths[prog_id]++] = instruction;
-
+            if (program_length(&system->programs, prog_id) < MAX_PROGRAM_INSTRUCTIONS) {
+                program_store_append(&system->programs, instruction);
             }
             if (instruction == 0) break; // Halt instruction marks end of program
         }
@@ -133,8 +419,19 @@ void initialize_system_with_input(SimulationSystem *system, SimulationInput inpu
     enqueue(system->new_queue, first_process);
 }
 
+bool initialize_system_with_programs(SimulationSystem *system, const ProgramStore *programs, const SimulationConfig *config) {
+    init_system(system, config);
+    if (programs->num_programs < 1 || !program_store_copy(&system->programs, programs)) {
+        return false;
+    }
+    PCB *first_process = create_new_process(system, 0);
+    if (first_process == NULL) return false;
+    enqueue(system->new_queue, first_process);
+    return true;
+}
+
 PCB *create_new_process(SimulationSystem *system, int prog_id) {
-    if (prog_id < 0 || prog_id >= 5 || system->next_pid > MAX_PROCESSES) return NULL;
+    if (prog_id < 0 || prog_id >= system->programs.num_programs || system->next_pid > MAX_PROCESSES) return NULL;
     PCB *new_process = (PCB *)calloc(1, sizeof(PCB));
     if (!new_process) return NULL;
 
@@ -143,19 +440,105 @@ PCB *create_new_process(SimulationSystem *system, int prog_id) {
     new_process->state = NEW;
     new_process->pc = 0;
     new_process->error_message = NULL;
-    new_process->memory_size = system->program_mem_sizes[prog_id];
-    int length = system->program_lengths[prog_id];
+    new_process->memory_size = system->programs.mem_sizes[prog_id];
+    new_process->last_page = -1;
+    bool configured = prog_id < CONFIG_PROGRAMS;
+    new_process->priority = configured ? system->config.priorities[prog_id] : 0;
+    new_process->effective_priority = new_process->priority;
+    new_process->waiting_on = -1;
+    new_process->wait_start = -1;
+    new_process->period = configured ? system->config.periods[prog_id] : 0;
+    new_process->relative_deadline = configured && system->config.deadlines[prog_id] > 0 ? system->config.deadlines[prog_id] : new_process->period;
+    new_process->release = system->current_time;
+    new_process->deadline = new_process->release + new_process->relative_deadline;
+    new_process->page_count = new_process->memory_size / PAGE_SIZE + 1;
+    new_process->page_last_ref = (int *)calloc(new_process->page_count, sizeof(int));
+    int length = program_length(&system->programs, prog_id);
     new_process->instruction_count = length;
     new_process->instructions = (int *)malloc(length * sizeof(int));
-    if (!new_process->instructions) {
+    if (!new_process->instructions || !new_process->page_last_ref) {
+        free(new_process->instructions);
+        free(new_process->page_last_ref);
         free(new_process);
         return NULL;
     }
-    memcpy(new_process->instructions, system->programs[prog_id], length * sizeof(int));
+    memcpy(new_process->instructions, program_code(&system->programs, prog_id), length * sizeof(int));
     system->processes[new_process->pid - 1] = new_process;
     return new_process;
 }
 
+// FORK: the child runs the parent's program from the instruction after the FORK and maps every
+// frame of the parent until one of them writes to it
+PCB *fork_process(SimulationSystem *system, PCB *parent) {
+    PCB *child = create_new_process(system, parent->program_id);
+    if (!child) return NULL;
+    child->pc = parent->pc + 1;
+    child->last_page = parent->last_page;
+    child->stride = parent->stride;
+    child->stride_confirmed = parent->stride_confirmed;
+    memcpy(child->page_last_ref, parent->page_last_ref, parent->page_count * sizeof(int));
+    for (int i = 0; i < system->config.num_frames; i++) {
+        if (frame_mapped_by(&system->physical_memory[i], parent->pid)) {
+            system->physical_memory[i].sharers |= 1u << (child->pid - 1);
+        }
+    }
+    system->stats.forks++;
+    return child;
+}
+
+// Frames the processes would need on top of the resident ones without sharing
+void track_shared_frames(SimulationSystem *system) {
+    int saved = 0;
+    for (int i = 0; i < system->config.num_frames; i++) {
+        if (system->physical_memory[i].process_id != -1) {
+            saved += frame_ref_count(&system->physical_memory[i]) - 1;
+        }
+    }
+    if (saved > system->stats.peak_frames_saved) system->stats.peak_frames_saved = saved;
+    system->stats.frames_saved_ticks += saved;
+}
+
+// --- I/O Devices ---
+
+// Queues the request of a BLOCK -operand on the device of the process. The process stays BLOCKED
+// until the device starts the request and knows when it ends.
+void submit_io(SimulationSystem *system, PCB *proc, int operand) {
+    int device = (proc->pid - 1) % system->config.num_devices;
+    IoRequest request;
+    request.pid = proc->pid;
+    request.track = proc->last_page > 0 ? proc->last_page : 0;
+    request.duration = operand;
+    request.submitted = system->current_time + 1; // Service starts on the tick after the BLOCK at the earliest
+    request.deadline = request.submitted + system->config.io_deadline;
+    if (device_submit(&system->devices[device], request)) {
+        proc->blocked_until = INT_MAX;
+    }
+}
+
+// Starts queued requests on free device slots. Runs before the blocked processes are checked, so a
+// request without contention ends on the same tick as a plain BLOCK.
+void dispatch_io(SimulationSystem *system) {
+    for (int d = 0; d < system->config.num_devices; d++) {
+        int started_pids[MAX_DEVICE_SLOTS], done_times[MAX_DEVICE_SLOTS];
+        int started = device_dispatch(&system->devices[d], &system->config.devices[d], system->current_time,
+                                      started_pids, done_times);
+        for (int i = 0; i < started; i++) {
+            PCB *proc = system->processes[started_pids[i] - 1];
+            if (proc) proc->blocked_until = done_times[i];
+        }
+        device_account(&system->devices[d], &system->config.devices[d]);
+    }
+}
+
+// Puts a READY process where the scheduler looks: the ready queue, or the heap of real-time scheduling
+static void make_ready(SimulationSystem *system, PCB *proc) {
+    if (system->config.rt_policy != RT_NONE) {
+        ready_push(system, proc);
+    } else {
+        enqueue(system->ready_queue, proc);
+    }
+}
+
 void update_blocked_processes(SimulationSystem *system) {
     size_t size = queueSize(system->blocked_queue);
     if (size == 0) return;
@@ -173,7 +556,7 @@ void update_blocked_processes(SimulationSystem *system) {
             proc->state = READY;
             proc->time_in_state = 0;
             proc->pc++; 
-            enqueue(system->ready_queue, proc);
+            make_ready(system, proc);
         }
     }
 }
@@ -205,6 +588,13 @@ void update_new_processes(SimulationSystem *system) {
             }
         }
 
+        // Under contiguous allocation the process is only admitted once its partition fits
+        if (should_move_to_ready && system->config.contiguous && allocator_find(&system->allocator, proc->pid) == NULL &&
+            allocator_alloc(&system->allocator, proc->pid, proc->memory_size) == -1) {
+            system->stats.admission_waits++;
+            should_move_to_ready = false;
+        }
+
         if (should_move_to_ready) {
             to_ready[ready_count++] = proc;
         }
@@ -214,9 +604,10 @@ void update_new_processes(SimulationSystem *system) {
     for (int i = 0; i < ready_count; i++) {
         PCB *proc = to_ready[i];
         if (removeNodeByData(system->new_queue, proc)) {
+            if (system->config.rt_policy != RT_NONE) rt_admit(system, proc);
             proc->state = READY;
             proc->time_in_state = 0;
-            enqueue(system->ready_queue, proc);
+            make_ready(system, proc);
         }
     }
 }
@@ -251,36 +642,131 @@ void update_exit_processes(SimulationSystem *system) {
         PCB *proc = to_remove[i];
         if (removeNodeByData(system->exit_queue, proc)) {
             // Free the process's frames from memory.
-            for (int f = 0; f < NUM_FRAMES; f++) {
-                if (system->physical_memory[f].process_id == proc->pid) {
-                    system->physical_memory[f].process_id = -1; // Mark frame as free
-                    system->physical_memory[f].page_number = -1;
-                    system->physical_memory[f].load_time = -1;
-                    system->physical_memory[f].last_access_time = -1;
-                }
-            }
-            if (proc->instructions) free(proc->instructions);
+            release_frames(system, proc->pid);
             system->processes[proc->pid - 1] = NULL;
-            free(proc);
+            free_process(proc);
+        }
+    }
+}
+
+// --- Working Set Load Control ---
+
+// Number of distinct pages the process referenced in the last ws_window ticks
+int working_set_size(SimulationSystem *system, PCB *proc) {
+    int size = 0;
+    for (int page = 0; page < proc->page_count; page++) {
+        int last_ref = proc->page_last_ref[page];
+        if (last_ref > 0 && system->current_time - last_ref < system->config.ws_window) {
+            size++;
         }
     }
+    return size;
+}
+
+// Total working set of the processes that compete for frames
+int total_working_set(SimulationSystem *system) {
+    int total = 0;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        PCB *proc = system->processes[i];
+        if (proc && (proc->state == READY || proc->state == RUNNING || proc->state == BLOCKED)) {
+            total += working_set_size(system, proc);
+        }
+    }
+    return total;
+}
+
+// Swap out whole processes while the working sets do not fit, and bring them back once they do.
+// The youngest ready process is suspended first; suspended processes resume in FIFO order.
+void apply_load_control(SimulationSystem *system) {
+    if (!system->config.load_control) return;
+
+    int total = total_working_set(system);
+    if (total > system->stats.peak_working_set) system->stats.peak_working_set = total;
+
+    while (total > system->config.suspend_threshold && !isEmpty(system->ready_queue)) {
+        PCB *victim = NULL;
+        for (size_t i = 0; i < queueSize(system->ready_queue); i++) {
+            PCB *proc = (PCB *)getQueueNodeAt(system->ready_queue, i);
+            if (working_set_size(system, proc) > 0 && (!victim || proc->pid > victim->pid)) victim = proc;
+        }
+        if (!victim) break; // Swapping out processes without a working set frees nothing
+        victim->suspended_ws = working_set_size(system, victim);
+        total -= victim->suspended_ws;
+        removeNodeByData(system->ready_queue, victim);
+        release_frames(system, victim->pid);
+        victim->state = SUSPENDED;
+        victim->time_in_state = 0;
+        enqueue(system->suspended_queue, victim);
+        system->stats.suspensions++;
+    }
+
+    if (total <= system->config.resume_threshold && !isEmpty(system->suspended_queue)) {
+        PCB *proc = (PCB *)getQueueNodeAt(system->suspended_queue, 0);
+        // Always resume when nothing else is active, otherwise the run could never finish
+        if (total + proc->suspended_ws <= system->config.resume_threshold || total == 0) {
+            dequeue(system->suspended_queue);
+            proc->state = READY;
+            proc->time_in_state = 0;
+            enqueue(system->ready_queue, proc);
+            system->stats.resumes++;
+        }
+    }
+}
+
+// Puts a process on the CPU with a fresh quantum
+static void dispatch(SimulationSystem *system, PCB *next_proc) {
+    next_proc->state = RUNNING;
+    next_proc->time_in_state = 0;
+    next_proc->remaining_quantum = system->config.quantum;
+    system->running_process = next_proc;
+    system->stats.dispatches++;
+    if (system->config.cache) cache_switch(&system->cache, next_proc->pid);
+}
+
+// Real-time scheduling takes the most urgent process off the heap, preempting the running one
+// when a ready process has an earlier deadline (EDF) or a shorter period (RM)
+static void schedule_real_time(SimulationSystem *system) {
+    PCB *running = system->running_process;
+    if (running && ready_preempts(system, running)) {
+        running->state = READY;
+        ready_push(system, running);
+        system->running_process = NULL;
+        system->stats.rt_preemptions++;
+    }
+    if (system->running_process || system->ready_count == 0) return;
+    dispatch(system, ready_pop(system));
 }
 
-// Scheduler uses the ready queue (FIFO/Round Robin)
+// Scheduler uses the ready queue (FIFO/Round Robin). Under priority scheduling the oldest ready
+// process of the highest effective priority goes first.
 void schedule_next_process(SimulationSystem *system) {
+    if (system->config.rt_policy != RT_NONE) {
+        schedule_real_time(system);
+        return;
+    }
     if (system->running_process) return;
     if (!isEmpty(system->ready_queue)) {
-        PCB *next_proc = dequeue(system->ready_queue);
-        next_proc->state = RUNNING;
-        next_proc->time_in_state = 0;
-        next_proc->remaining_quantum = 3;
-        system->running_process = next_proc;
+        PCB *next_proc;
+        if (system->config.priority_scheduling) {
+            size_t best = 0;
+            for (size_t i = 1; i < queueSize(system->ready_queue); i++) {
+                const PCB *proc = (PCB *)getQueueNodeAt(system->ready_queue, i);
+                if (proc->effective_priority > ((PCB *)getQueueNodeAt(system->ready_queue, best))->effective_priority) best = i;
+            }
+            next_proc = (PCB *)getQueueNodeAt(system->ready_queue, best);
+            removeNodeAt(system->ready_queue, best);
+        } else {
+            next_proc = dequeue(system->ready_queue);
+        }
+        dispatch(system, next_proc);
     }
 }
 
 // Print state and sorted list of frames
 void print_current_state(SimulationSystem *system) {
-    printf("%-10d", system->current_time);
+    FILE *out = system->out;
+    if (!out) return;
+    fprintf(out, "%-10d", system->current_time);
     for (int pid = 1; pid <= 20; pid++) {
         PCB *proc = system->processes[pid - 1];
 
@@ -291,21 +777,23 @@ void print_current_state(SimulationSystem *system) {
             // Check if there is a running process that is about to execute an EXEC instruction.
             if (creator_proc && creator_proc->pc < creator_proc->instruction_count) {
                 int instruction = creator_proc->instructions[creator_proc->pc];
-                // Check if the instruction is EXEC and if the PID it will create matches the current PID column.
-                if ((instruction >= 201 && instruction <= 299) && (system->next_pid == pid)) {
+                // Check if the instruction is EXEC (or FORK) and if the PID it will create matches the current PID column.
+                bool creates = (instruction >= 201 && instruction <= 299) ||
+                               (system->config.cow_fork && instruction == FORK_INSTRUCTION);
+                if (creates && (system->next_pid == pid)) {
                     system->will_be_created = true;
                 }
             }
 
             if (system->will_be_created) {
                 // Print the special "pre-NEW" state and set the flag so we don't do it again.
-                printf("\t%-18s", "NEW");
+                fprintf(out, "\t%-18s", "NEW");
                 system->pre_new_printed[pid - 1] = true;
                 continue; // Move to the next pid in the loop.
             }
         }
 
-        char output_str[100] = "";
+        char output_str[MAX_FRAMES * 5 + 32] = ""; // Room for a message and every frame
         if (proc) {
             const char *state_str = "";
             switch (proc->state) {
@@ -314,16 +802,25 @@ void print_current_state(SimulationSystem *system) {
                 case RUNNING: state_str = "RUN"; break;
                 case BLOCKED: state_str = "BLOCKED"; break;
                 case EXIT:    state_str = "EXIT"; break;
+                case SUSPENDED: state_str = "SUSPENDED"; break;
             }
             strcpy(output_str, state_str);
             if (proc->error_message) {
                  strcpy(output_str, proc->error_message);
             }
-            if (proc->state == READY || proc->state == RUNNING || proc->state == BLOCKED || proc->state == EXIT) {
-                Frame proc_frames[NUM_FRAMES];
+            if (system->config.contiguous) {
+                // The partition as its first and last byte address, once the process is admitted
+                const Partition *partition = allocator_find(&system->allocator, proc->pid);
+                if (partition != NULL && proc->state != NEW) {
+                    char partition_str[32];
+                    sprintf(partition_str, " [%d-%d]", partition->start, partition->start + partition->size - 1);
+                    strcat(output_str, partition_str);
+                }
+            } else if (proc->state == READY || proc->state == RUNNING || proc->state == BLOCKED || proc->state == EXIT) {
+                Frame proc_frames[MAX_FRAMES];
                 int frame_count = 0;
-                for (int i = 0; i < NUM_FRAMES; i++) {
-                    if (system->physical_memory[i].process_id == proc->pid) {
+                for (int i = 0; i < system->config.num_frames; i++) {
+                    if (frame_mapped_by(&system->physical_memory[i], proc->pid)) {
                         proc_frames[frame_count++] = system->physical_memory[i];
                     }
                 }
@@ -337,7 +834,7 @@ void print_current_state(SimulationSystem *system) {
                         }
                     }
                 }
-                char frame_list_str[80] = " [";
+                char frame_list_str[MAX_FRAMES * 5 + 8] = " [";
                 for (int i = 0; i < frame_count; i++) {
                     char temp[10];
                     sprintf(temp, "F%d%s", proc_frames[i].frame_id, (i == frame_count - 1) ? "" : ",");
@@ -347,32 +844,40 @@ void print_current_state(SimulationSystem *system) {
                 strcat(output_str, frame_list_str);
             }
         }
-        printf("\t%-18s", output_str);
+        fprintf(out, "\t%-18s", output_str);
     }
-    printf("\n");
+    fprintf(out, "\n");
 }
 
-void run_simulation(SimulationSystem *system) {
-    if (!system) return;
-
-    printf("time      ");
-    for (int i = 1; i <= 20; i++) printf("\tproc%-15d", i);
-    printf("\n");
-
-    PCB* preempted_process = NULL;
+// Writes the periodic checkpoint of the tick that just ended, if one is due
+void write_periodic_checkpoint(SimulationSystem *system) {
+    int interval = system->config.checkpoint_interval;
+    if (interval <= 0 || system->current_time % interval != 0) return;
+    char path[256];
+    snprintf(path, sizeof(path), "%s_t%03d.ckpt", system->config.checkpoint_prefix ? system->config.checkpoint_prefix : "checkpoint",
+             system->current_time);
+    if (!save_checkpoint(system, path)) {
+        fprintf(stderr, "Could not write checkpoint %s\n", path);
+    }
+}
 
-    for (int time = 1; time <= 100; time++) {
+// Runs the ticks after system->current_time until the simulation ends
+void run_ticks(SimulationSystem *system) {
+    for (int time = system->current_time + 1; time <= 100 && !system->finished; time++) {
         system->current_time = time;
 
-        update_new_processes(system);
-        update_blocked_processes(system);
+        PROFILE_CALL(PROFILE_NEW_PROCESSES, update_new_processes(system));
+        if (system->config.io_model) dispatch_io(system);
+        PROFILE_CALL(PROFILE_BLOCKED_PROCESSES, update_blocked_processes(system));
 
-        if (preempted_process) {
-            enqueue(system->ready_queue, preempted_process);
-            preempted_process = NULL;
+        if (system->preempted_process) {
+            make_ready(system, system->preempted_process);
+            system->preempted_process = NULL;
         }
 
-        schedule_next_process(system);
+        apply_load_control(system);
+        PROFILE_CALL(PROFILE_SCHEDULE, schedule_next_process(system));
+        if (system->config.sync) account_sync(system);
 
         // Check for errors in the running process
         bool error_occurred = false;
@@ -386,8 +891,16 @@ void run_simulation(SimulationSystem *system) {
                 error_reason = "SIGEOF";
             } else {
                 int instruction = proc->instructions[proc->pc];
+                int valid_access = 1;
                 if (instruction >= 1000 && instruction <= 15999) {
-                    if (!handle_memory_access(system, proc, instruction - 1000)) {
+                    PROFILE_CALL(PROFILE_MEMORY_ACCESS, valid_access = handle_memory_access(system, proc, instruction - 1000, false));
+                    if (!valid_access) {
+                        error_occurred = true;
+                        error_reason = "SIGSEGV";
+                    }
+                } else if (system->config.cow_fork && instruction >= STORE_BASE && instruction <= STORE_LAST) {
+                    PROFILE_CALL(PROFILE_MEMORY_ACCESS, valid_access = handle_memory_access(system, proc, instruction - STORE_BASE, true));
+                    if (!valid_access) {
                         error_occurred = true;
                         error_reason = "SIGSEGV";
                     }
@@ -401,6 +914,9 @@ void run_simulation(SimulationSystem *system) {
                         error_occurred = true;
                         error_reason = "SIGILL";
                     }
+                } else if (is_sync_instruction(system, instruction) && sync_fault(system, proc, instruction)) {
+                    error_occurred = true;
+                    error_reason = "SIGILL";
                 }
             }
             
@@ -410,7 +926,7 @@ void run_simulation(SimulationSystem *system) {
         }
 
         // Print the state
-        print_current_state(system);
+        PROFILE_CALL(PROFILE_PRINT_STATE, print_current_state(system));
 
         // Fully execute the logic and state changes
         PCB* proc = system->running_process;
@@ -422,7 +938,9 @@ void run_simulation(SimulationSystem *system) {
             }
             else { // No error, proceed as normal
                 int instruction = proc->instructions[proc->pc];
-                if (instruction == 0) { // Halt
+                if (instruction == 0 && proc->period > 0) { // Halt of a real-time job
+                    complete_job(system, proc);
+                } else if (instruction == 0) { // Halt
                     terminate_process(system, proc, NULL);
                 } else if (instruction >= 1000 && instruction <= 15999) { // LOAD/STORE
                     proc->pc++;
@@ -432,14 +950,23 @@ void run_simulation(SimulationSystem *system) {
                     proc->pc -= (instruction - 100);
                 } else if (instruction >= 201 && instruction <= 299) { // EXEC
                     int program_id = (instruction % 100) - 1;
-                    if (system->next_pid <= MAX_PROCESSES && program_id >= 0 && program_id < 5) {
+                    if (system->next_pid <= MAX_PROCESSES && program_id >= 0 && program_id < system->programs.num_programs) {
                         PCB *new_proc = create_new_process(system, program_id);
                         if (new_proc) enqueue(system->new_queue, new_proc);
                     }
                     proc->pc++;
+                } else if (system->config.cow_fork && instruction == FORK_INSTRUCTION) { // FORK
+                    PCB *child = fork_process(system, proc);
+                    if (child) enqueue(system->new_queue, child);
+                    proc->pc++;
+                } else if (system->config.cow_fork && instruction >= STORE_BASE && instruction <= STORE_LAST) { // STORE
+                    proc->pc++;
+                } else if (is_sync_instruction(system, instruction)) { // LOCK, UNLOCK, P and V
+                    execute_sync(system, proc, instruction);
                 } else if (instruction < 0) { // BLOCK
                     proc->state = BLOCKED;
                     proc->blocked_until = system->current_time + (-instruction) + 1;
+                    if (system->config.io_model) submit_io(system, proc, -instruction);
                     enqueue(system->blocked_queue, proc);
                     system->running_process = NULL;
                 } else { // Unknown instruction, treat as NOP
@@ -453,19 +980,126 @@ void run_simulation(SimulationSystem *system) {
              system->running_process->remaining_quantum--;
              if (system->running_process->remaining_quantum <= 0) {
                  system->running_process->state = READY;
-                 preempted_process = system->running_process;
+                 system->preempted_process = system->running_process;
                  system->running_process = NULL;
              }
         }
 
         // Cleanup exit processes
-        update_exit_processes(system);
+        PROFILE_CALL(PROFILE_EXIT_PROCESSES, update_exit_processes(system));
+        if (system->config.kswapd) run_kswapd(system);
+        if (system->config.cow_fork) track_shared_frames(system);
+        if (system->config.contiguous) allocator_sample(&system->allocator);
 
         // Check for simulation end
-        if (isEmpty(system->new_queue) && isEmpty(system->ready_queue) &&
+        if (isEmpty(system->new_queue) && isEmpty(system->ready_queue) && system->ready_count == 0 &&
             isEmpty(system->blocked_queue) && isEmpty(system->exit_queue) &&
-            !system->running_process && !preempted_process) {
-            break;
+            isEmpty(system->suspended_queue) &&
+            !system->running_process && !system->preempted_process) {
+            system->finished = true;
         }
+        write_periodic_checkpoint(system);
     }
-}
\ No newline at end of file
+}
+
+void print_table_header(SimulationSystem *system) {
+    if (!system->out) return;
+    fprintf(system->out, "time      ");
+    for (int i = 1; i <= 20; i++) fprintf(system->out, "\tproc%-15d", i);
+    fprintf(system->out, "\n");
+}
+
+void run_simulation(SimulationSystem *system) {
+    if (!system) return;
+
+    print_table_header(system);
+    PROFILE_CALL(PROFILE_TICKS, run_ticks(system));
+}
+
+// Continues a restored system from the tick after its checkpoint. No header is printed, so the rows
+// follow the ones the original run printed up to the checkpoint.
+void resume_simulation(SimulationSystem *system) {
+    if (!system) return;
+    PROFILE_CALL(PROFILE_TICKS, run_ticks(system));
+}
+// Print the counters of the run below the state table
+void print_statistics(SimulationSystem *system) {
+    SimulationStats *stats = &system->stats;
+    FILE *out = system->out;
+    if (!out) return;
+    fprintf(out, "\n--- Statistics ---\n");
+    fprintf(out, "%-26s %d\n", "memory accesses", stats->memory_accesses);
+    fprintf(out, "%-26s %d\n", "page faults", stats->page_faults);
+    fprintf(out, "%-26s %.3f\n", "fault rate", stats->memory_accesses > 0 ? (double)stats->page_faults / stats->memory_accesses : 0.0);
+    if (system->config.prefetch_depth > 0) {
+        // Accuracy: used prefetches over issued ones. Coverage: faults avoided over faults that would have happened.
+        int would_be_faults = stats->page_faults + stats->prefetch_hits;
+        fprintf(out, "%-26s %d\n", "prefetches", stats->prefetches);
+        fprintf(out, "%-26s %d\n", "prefetch hits", stats->prefetch_hits);
+        fprintf(out, "%-26s %.2f\n", "prefetch accuracy", stats->prefetches > 0 ? (double)stats->prefetch_hits / stats->prefetches : 0.0);
+        fprintf(out, "%-26s %.2f\n", "prefetch coverage", would_be_faults > 0 ? (double)stats->prefetch_hits / would_be_faults : 0.0);
+        fprintf(out, "%-26s %d\n", "unused prefetches evicted", stats->prefetch_unused);
+        fprintf(out, "%-26s %d\n", "prefetch pollution", stats->prefetch_evictions);
+    }
+    if (system->config.load_control) {
+        fprintf(out, "%-26s %d\n", "suspensions", stats->suspensions);
+        fprintf(out, "%-26s %d\n", "resumes", stats->resumes);
+        fprintf(out, "%-26s %d\n", "peak total working set", stats->peak_working_set);
+    }
+    if (system->config.cow_fork) {
+        fprintf(out, "%-26s %d\n", "forks", stats->forks);
+        fprintf(out, "%-26s %d\n", "copy-on-write faults", stats->cow_faults);
+        fprintf(out, "%-26s %d\n", "peak frames saved", stats->peak_frames_saved);
+        fprintf(out, "%-26s %.2f\n", "average frames saved",
+                system->current_time > 0 ? (double)stats->frames_saved_ticks / system->current_time : 0.0);
+    }
+    if (system->config.io_model) {
+        for (int d = 0; d < system->config.num_devices; d++) {
+            device_print_stats(&system->devices[d], &system->config.devices[d], system->current_time, out);
+        }
+    }
+    if (system->config.contiguous) {
+        allocator_print_stats(&system->allocator, out);
+        fprintf(out, "%-26s %d\n", "admission wait ticks", stats->admission_waits);
+    }
+    if (system->config.sync) {
+        print_sync_statistics(system);
+    }
+    if (system->config.rt_policy != RT_NONE) {
+        print_rt_statistics(system);
+    }
+    if (system->config.cache) {
+        cache_print_stats(&system->cache, out);
+    }
+    if (system->config.kswapd) {
+        fprintf(out, "%-26s %d-%d free frames, %d per tick\n", "watermarks", system->config.low_watermark,
+                system->config.high_watermark, system->config.kswapd_batch);
+        fprintf(out, "%-26s %d\n", "faults with a free frame", stats->free_frame_faults);
+        fprintf(out, "%-26s %d\n", "direct reclaims", stats->direct_reclaims);
+        fprintf(out, "%-26s %d\n", "kswapd wakeups", stats->kswapd_wakeups);
+        fprintf(out, "%-26s %d\n", "kswapd active ticks", stats->kswapd_ticks);
+        fprintf(out, "%-26s %d\n", "pages reclaimed", stats->kswapd_reclaimed);
+        fprintf(out, "%-26s %d\n", "refaults", stats->kswapd_refaults);
+    }
+}
+
+// Free every process and queue still owned by the system
+void destroy_system(SimulationSystem *system) {
+    for (int j = 0; j < MAX_PROCESSES; j++) {
+        if (system->processes[j] != NULL) {
+            free_process(system->processes[j]);
+            system->processes[j] = NULL;
+        }
+    }
+
+    if (system->new_queue) deleteQueue(system->new_queue);
+    if (system->ready_queue) deleteQueue(system->ready_queue);
+    if (system->blocked_queue) deleteQueue(system->blocked_queue);
+    if (system->exit_queue) deleteQueue(system->exit_queue);
+    if (system->suspended_queue) deleteQueue(system->suspended_queue);
+    allocator_destroy(&system->allocator);
+    cache_destroy(&system->cache);
+    program_store_destroy(&system->programs);
+    system->new_queue = system->ready_queue = system->blocked_queue = NULL;
+    system->exit_queue = system->suspended_queue = NULL;
+}
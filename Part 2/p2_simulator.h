@@ -7,12 +7,36 @@
 #include <stdlib.h> 
 #include <stdbool.h> 
 #include "queue.h"
+#include "allocator.h"
+#include "io.h"
+#include "cache.h"
+#include "programs.h"
 
 // --- Configuration from Part 2 ---
 #define PAGE_SIZE 3000
 #define NUM_FRAMES 7  // 21KB total memory / 3KB per frame
+#define MAX_FRAMES 64 // Largest frame count a configuration may ask for
+#define DEFAULT_QUANTUM 3
 #define MAX_PROCESSES 20
-#define MAX_PROGRAM_INSTRUCTIONS 100 // A reasonable limit for instructions per program
+#define MAX_PROGRAM_INSTRUCTIONS 100 // Instructions taken from each column of a SimulationInput
+#define CONFIG_PROGRAMS 5 // Programs the per program settings cover, later ones get 0
+
+// Instructions of the copy-on-write mode (config.cow_fork), NOPs otherwise
+#define FORK_INSTRUCTION 300 // Child continues after the FORK with the parent's pages shared
+#define STORE_BASE 16000     // 16000-30999: STORE to address instruction - 16000
+#define STORE_LAST 30999
+
+// Synchronization instructions (config.sync), NOPs otherwise. The last digit picks the object.
+#define NUM_MUTEXES 10
+#define NUM_SEMAPHORES 10
+#define LOCK_BASE 400       // 400-409: acquire mutex
+#define UNLOCK_BASE 410     // 410-419: release mutex (SIGILL if the process does not hold it)
+#define SEM_WAIT_BASE 420   // 420-429: P on a semaphore
+#define SEM_SIGNAL_BASE 430 // 430-439: V on a semaphore
+#define CONVOY_LENGTH 3     // Waiters on one mutex that count as a convoy
+
+// Real-time scheduling (config.rt_policy)
+#define LATENESS_BUCKETS 6  // Early, on time, 1-2, 3-5, 6-10 and over 10 ticks late
 
 // --- Memory Management Structures ---
 typedef struct {
@@ -21,11 +45,13 @@ typedef struct {
     int page_number;
     int load_time;
     int last_access_time;
+    bool prefetched; // Loaded by the prefetcher and not used by the process yet
+    unsigned int sharers; // Other processes mapping the frame copy-on-write, bit pid-1 (MAX_PROCESSES <= 32)
 } Frame;
 
 // --- Process and System Structures ---
 typedef enum {
-    NEW, READY, RUNNING, BLOCKED, EXIT
+    NEW, READY, RUNNING, BLOCKED, EXIT, SUSPENDED
 } ProcessState;
 
 typedef struct {
@@ -44,31 +70,195 @@ typedef struct {
     int* instructions;
     int instruction_count;
 
+    // Stride detection for the prefetcher
+    int last_page;
+    int stride;
+    bool stride_confirmed;
+
+    // Working set tracking for load control
+    int *page_last_ref; // Last time each page of the address space was referenced (0 = never)
+    int page_count;
+    int suspended_ws;   // Working set size when the process was swapped out
+
+    // Synchronization
+    int priority;           // Base priority of its program, higher runs first under priority scheduling
+    int effective_priority; // Raised while it holds a mutex a higher priority process waits for
+    int waiting_on;         // Mutex m, NUM_MUTEXES + semaphore s, or -1
+    int wait_start;         // Tick it started waiting or spinning, -1 when not waiting
+
+    // Real-time task: every period the program runs again from the start as a new job
+    int period;             // Ticks between job releases, 0 for a best effort process
+    int relative_deadline;  // Ticks after its release a job must reach HALT by
+    int release;            // Release tick of the current job
+    int deadline;           // Absolute deadline of the current job
+
 } PCB;
 
+// Ready processes under real-time scheduling: a binary min-heap on (key, seq), where key is the
+// absolute deadline (EDF) or the period (RM), INT_MAX for best effort, and seq keeps FIFO order on ties
+typedef struct {
+    int key;
+    int seq;
+    int pid;
+} ReadyEntry;
+
+typedef enum { RT_NONE, RT_EDF, RT_RM } RealTimePolicy;
+
+// A mutex or a counting semaphore with the processes waiting for it
+typedef struct {
+    int owner;                  // Pid holding the mutex, 0 when free (unused by semaphores)
+    int count;                  // Semaphore value (unused by mutexes)
+    int acquired_at;            // Tick the owner got the mutex
+    int waiters[MAX_PROCESSES]; // Pids blocked or spinning on it, in arrival order
+    int num_waiters;
+} SyncObject;
+
+typedef enum { POLICY_LRU, POLICY_FIFO } ReplacementPolicy;
+
+// Optional features, all disabled by default so the standard output files are unchanged
+typedef struct {
+    // Machine parameters, NUM_FRAMES, DEFAULT_QUANTUM and LRU reproduce the assignment
+    int num_frames;            // Frames of physical memory (1 to MAX_FRAMES)
+    int quantum;               // Ticks a process runs before it is preempted
+    ReplacementPolicy policy;
+
+    int prefetch_depth; // Pages read ahead on a fault of a strided process (0 = disabled)
+
+    // Working set load control
+    bool load_control;
+    int ws_window;          // Ticks a referenced page stays in the working set
+    int suspend_threshold;  // Swap out processes while the total working set is above this
+    int resume_threshold;   // Swap a process back in if the total stays at or below this
+
+    // FORK shares the parent's frames with the child, the first STORE to a shared frame copies it
+    bool cow_fork;
+
+    // Contiguous allocation instead of paging: a process is admitted once its whole memory_size
+    // fits in the num_frames * PAGE_SIZE bytes of memory, and then never faults
+    bool contiguous;
+    AllocStrategy alloc_strategy;
+    bool compaction;
+
+    // BLOCK requests go to I/O devices and wait for a free slot instead of sleeping on their own
+    bool io_model;
+    int num_devices;
+    DeviceConfig devices[MAX_DEVICES];
+    int io_deadline; // Ticks a request may wait before the deadline discipline serves it first
+
+    // Mutexes and semaphores
+    bool sync;
+    bool spin_locks;           // Waiters keep running and retry instead of blocking
+    bool priority_inheritance; // A mutex owner runs at the priority of its highest waiter
+    bool priority_scheduling;  // Dispatch the ready process of highest priority instead of the oldest
+    int priorities[CONFIG_PROGRAMS]; // Priority of each program
+    int semaphore_initial;     // Starting value of every semaphore
+
+    // Real-time scheduling of periodic programs, preemptive, replacing the ready queue by a heap
+    RealTimePolicy rt_policy;
+    int periods[CONFIG_PROGRAMS];    // Period of each program, 0 for best effort
+    int deadlines[CONFIG_PROGRAMS];  // Relative deadline of each program, 0 for the period
+
+    // CPU caches on the physical addresses of LOAD and STORE
+    bool cache;
+    int num_cache_levels;
+    CacheLevelConfig cache_levels[CACHE_LEVELS];
+    int cache_pollution;       // Percent of the cached lines lost on every context switch
+
+    // Background reclaim: at the end of a tick with fewer than low_watermark free frames, a daemon
+    // evicts the coldest pages, kswapd_batch per tick, until high_watermark frames are free
+    bool kswapd;
+    int low_watermark;
+    int high_watermark;
+    int kswapd_batch;
+
+    // Periodic checkpoints (see checkpoint.h), not part of the simulated behaviour
+    int checkpoint_interval;        // Write a checkpoint every N ticks (0 = disabled)
+    const char *checkpoint_prefix;  // Files are named <prefix>_t<tick>.ckpt
+} SimulationConfig;
+
+// Counters collected during run_simulation()
+typedef struct {
+    int memory_accesses;
+    int page_faults;
+    int prefetches;         // Pages loaded by the prefetcher
+    int prefetch_hits;      // Prefetched pages used before being evicted
+    int prefetch_unused;    // Prefetched pages evicted without ever being used
+    int prefetch_evictions; // Resident pages evicted to make room for prefetches
+    int suspensions;
+    int resumes;
+    int peak_working_set;
+    int dispatches;         // Processes put on the CPU by the scheduler
+    int forks;
+    int cow_faults;         // STOREs to a shared frame that had to copy it first
+    int peak_frames_saved;  // Most frames the sharing saved at the end of one tick
+    int frames_saved_ticks; // Frames saved added up over all ticks, for the average
+    int admission_waits;    // Ticks NEW processes spent waiting for a partition
+    int lock_acquisitions;
+    int contended_acquisitions; // Acquisitions that had to wait first
+    int hold_ticks;         // Ticks mutexes were held, over every release
+    int max_hold;
+    int wait_ticks;         // Ticks from the first failed attempt to the acquisition
+    int max_wait;
+    int spin_ticks;         // Ticks spent on the CPU retrying a taken mutex or empty semaphore
+    int semaphore_waits;
+    int convoys;            // Times a mutex queue grew to CONVOY_LENGTH waiters
+    int peak_waiters;
+    int inversion_ticks;    // Ticks a lower priority process ran while a higher one waited for a mutex
+    int rt_jobs;            // Jobs of real-time processes that reached HALT
+    int deadline_misses;
+    int lateness_total;     // Completion minus deadline over every job, negative when early
+    int max_lateness;
+    int lateness_buckets[LATENESS_BUCKETS];
+    int rt_preemptions;     // Running processes displaced by a more urgent ready one
+    int heap_comparisons;   // Key comparisons of the ready heap, the scheduling overhead
+    int admission_rejects;  // Tasks the schedulability test demoted to best effort
+    int peak_utilization;   // Highest utilization (density under EDF) admitted, in per mille
+    int free_frame_faults;  // Faults that found a free frame
+    int direct_reclaims;    // Faults that had to evict a victim themselves
+    int kswapd_wakeups;
+    int kswapd_ticks;       // Ticks the daemon spent reclaiming
+    int kswapd_reclaimed;   // Pages the daemon evicted
+    int kswapd_refaults;    // Faults on pages the daemon evicted, the cost of reclaiming too early
+} SimulationStats;
+
 typedef struct {
     // Queues
     Queue *new_queue;
     Queue *ready_queue;
     Queue *blocked_queue;
     Queue *exit_queue;
+    Queue *suspended_queue;
 
     // CPU and System State
     PCB *running_process;
+    PCB *preempted_process; // Quantum expired last tick, goes back to READY at the start of the next one
     int current_time;
     int next_pid;
+    bool finished;          // Every queue drained, nothing left to run
 
     // Process and Program Storage
     PCB *processes[MAX_PROCESSES];
-    int programs[5][MAX_PROGRAM_INSTRUCTIONS];
-    int program_lengths[5];
-    int program_mem_sizes[5];
+    ProgramStore programs;
     bool pre_new_printed[MAX_PROCESSES];
     bool will_be_created;
 
 
     // Physical Memory
-    Frame physical_memory[NUM_FRAMES];
+    Frame physical_memory[MAX_FRAMES]; // Only the first config.num_frames are used
+    Allocator allocator;               // Partitions of the contiguous model
+    Device devices[MAX_DEVICES];       // Queues and slots of the I/O model
+    SyncObject mutexes[NUM_MUTEXES];
+    SyncObject semaphores[NUM_SEMAPHORES];
+    ReadyEntry ready_heap[MAX_PROCESSES]; // Ready processes under real-time scheduling
+    int ready_count;
+    int ready_seq;                        // Next FIFO tie breaker
+    CacheHierarchy cache;
+    bool kswapd_awake;
+    unsigned int reclaimed_pages[MAX_PROCESSES]; // Pages evicted by the daemon and not faulted back yet, bit page
+
+    SimulationConfig config;
+    SimulationStats stats;
+    FILE *out; // Where the table and the statistics go: stdout by default, NULL to print nothing
 
 } SimulationSystem;
 
@@ -80,10 +270,35 @@ typedef struct {
 
 
 // Function Prototypes
+SimulationConfig default_config(void);
 void initialize_system_with_input(SimulationSystem *system, SimulationInput input);
+void initialize_system_with_config(SimulationSystem *system, SimulationInput input, const SimulationConfig *config);
+// Runs a copy of a program store instead of the columns of an input, with every program of it.
+// Fails on an empty store or when memory runs out; the system must still be destroyed then.
+bool initialize_system_with_programs(SimulationSystem *system, const ProgramStore *programs, const SimulationConfig *config);
+void print_table_header(SimulationSystem *system);
 void run_simulation(SimulationSystem *system);
+void resume_simulation(SimulationSystem *system);
 PCB *create_new_process(SimulationSystem *system, int prog_id);
 void print_current_state(SimulationSystem *system);
+void print_statistics(SimulationSystem *system);
+void destroy_system(SimulationSystem *system);
+
+// Synchronization (sync.c)
+bool is_sync_instruction(const SimulationSystem *system, int instruction);
+bool sync_fault(const SimulationSystem *system, const PCB *proc, int instruction);
+void execute_sync(SimulationSystem *system, PCB *proc, int instruction);
+void release_locks(SimulationSystem *system, PCB *proc);
+void account_sync(SimulationSystem *system);
+void print_sync_statistics(SimulationSystem *system);
+
+// Real-time scheduling (realtime.c)
+void ready_push(SimulationSystem *system, PCB *proc);
+PCB *ready_pop(SimulationSystem *system);
+bool ready_preempts(SimulationSystem *system, const PCB *running);
+void rt_admit(SimulationSystem *system, PCB *proc);
+void complete_job(SimulationSystem *system, PCB *proc);
+void print_rt_statistics(SimulationSystem *system);
 // ... other internal functions ...
 
 #endif // SIMULATION_H
\ No newline at end of file
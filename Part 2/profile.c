@@ -0,0 +1,41 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "profile.h"
+
+// Only built into p2_sim_profile.exe, see the profile target of the Makefile
+
+static const char *const phase_names[PROFILE_PHASES] = {
+    "update_new_processes", "update_blocked_processes", "schedule_next_process", "handle_memory_access",
+    "print_current_state", "update_exit_processes", "tick loop"
+};
+
+static unsigned long long phase_time[PROFILE_PHASES];
+static long phase_calls[PROFILE_PHASES];
+
+// Shares are of the tick loops, so what is left is the time of the instructions themselves
+static void print_profile(void) {
+    unsigned long long total = phase_time[PROFILE_TICKS];
+    fprintf(stderr, "\n--- Profile (%s) ---\n", PROFILE_UNIT);
+    fprintf(stderr, "%-26s %12s %16s %12s %s\n", "phase", "calls", PROFILE_UNIT, "per call", "share");
+    unsigned long long phases = 0;
+    for (int p = 0; p < PROFILE_PHASES; p++) {
+        fprintf(stderr, "%-26s %12ld %16llu %12.1f %5.1f%%\n", phase_names[p], phase_calls[p], phase_time[p],
+                phase_calls[p] > 0 ? (double)phase_time[p] / phase_calls[p] : 0.0,
+                total > 0 ? 100.0 * phase_time[p] / total : 0.0);
+        if (p != PROFILE_TICKS) phases += phase_time[p];
+    }
+    unsigned long long rest = total > phases ? total - phases : 0;
+    fprintf(stderr, "%-26s %12s %16llu %12s %5.1f%%\n", "rest of the tick", "", rest, "",
+            total > 0 ? 100.0 * rest / total : 0.0);
+}
+
+void profile_record(ProfilePhase phase, unsigned long long elapsed) {
+    static bool registered = false;
+    if (!registered) {
+        atexit(print_profile);
+        registered = true;
+    }
+    phase_time[phase] += elapsed;
+    phase_calls[phase]++;
+}
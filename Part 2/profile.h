@@ -0,0 +1,56 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+// Per phase profiler of the tick loop, compiled in with -DSIM_PROFILE (make profile builds
+// p2_sim_profile.exe). Every phase counts its calls and the time spent in them: cycles of the time
+// stamp counter on x86, nanoseconds of the monotonic clock elsewhere. The breakdown is printed to
+// stderr when the program exits. Without SIM_PROFILE, PROFILE_CALL() is the bare statement.
+
+typedef enum {
+    PROFILE_NEW_PROCESSES,
+    PROFILE_BLOCKED_PROCESSES,
+    PROFILE_SCHEDULE,
+    PROFILE_MEMORY_ACCESS,
+    PROFILE_PRINT_STATE,
+    PROFILE_EXIT_PROCESSES,
+    PROFILE_TICKS,         // Whole tick loops, the phases above included
+    PROFILE_PHASES
+} ProfilePhase;
+
+#ifdef SIM_PROFILE
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+    #define PROFILE_UNIT "cycles"
+    static inline unsigned long long profile_clock(void) {
+        return __rdtsc();
+    }
+#else
+    #include <time.h>
+    #define PROFILE_UNIT "ns"
+    static inline unsigned long long profile_clock(void) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    }
+#endif
+
+void profile_record(ProfilePhase phase, unsigned long long elapsed);
+
+#define PROFILE_CALL(phase, statement) do { \
+        unsigned long long profile_start = profile_clock(); \
+        statement; \
+        profile_record(phase, profile_clock() - profile_start); \
+    } while (0)
+
+#else
+
+#define PROFILE_CALL(phase, statement) statement
+
+#endif // SIM_PROFILE
+
+#endif // PROFILE_H
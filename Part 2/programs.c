@@ -0,0 +1,207 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "programs.h"
+
+// --- Store ---
+
+void program_store_init(ProgramStore *store) {
+    memset(store, 0, sizeof(ProgramStore));
+}
+
+void program_store_destroy(ProgramStore *store) {
+    free(store->mem_sizes);
+    free(store->starts);
+    free(store->instructions);
+    program_store_init(store);
+}
+
+bool program_store_reserve(ProgramStore *store, int num_programs, int num_instructions) {
+    if (num_programs < 0 || num_instructions < 0 || num_programs == INT_MAX) return false;
+    if (num_programs > store->program_capacity) {
+        int *mem_sizes = (int *)realloc(store->mem_sizes, num_programs * sizeof(int));
+        if (!mem_sizes) return false;
+        store->mem_sizes = mem_sizes;
+        int *starts = (int *)realloc(store->starts, (num_programs + 1) * sizeof(int));
+        if (!starts) return false;
+        if (store->starts == NULL) starts[0] = 0;
+        store->starts = starts;
+        store->program_capacity = num_programs;
+    }
+    if (num_instructions > store->instruction_capacity) {
+        int *instructions = (int *)realloc(store->instructions, num_instructions * sizeof(int));
+        if (!instructions) return false;
+        store->instructions = instructions;
+        store->instruction_capacity = num_instructions;
+    }
+    return true;
+}
+
+// Doubles the capacity, so appending a whole workload costs amortized constant time per value
+static int grown(int capacity, int needed) {
+    int doubled = capacity > INT_MAX / 2 ? INT_MAX : 2 * capacity;
+    return needed > doubled ? needed : doubled;
+}
+
+bool program_store_begin(ProgramStore *store, int mem_size) {
+    int num_programs = store->num_programs;
+    if (num_programs == INT_MAX - 1) return false;
+    if (num_programs + 1 > store->program_capacity &&
+        !program_store_reserve(store, grown(store->program_capacity, num_programs + 1), 0)) {
+        return false;
+    }
+    store->mem_sizes[num_programs] = mem_size;
+    store->starts[num_programs + 1] = store->starts[num_programs];
+    store->num_programs++;
+    return true;
+}
+
+bool program_store_append(ProgramStore *store, int instruction) {
+    if (store->num_programs == 0) return false;
+    int end = store->starts[store->num_programs];
+    if (end == INT_MAX) return false;
+    if (end + 1 > store->instruction_capacity &&
+        !program_store_reserve(store, 0, grown(store->instruction_capacity, end + 1))) {
+        return false;
+    }
+    store->instructions[end] = instruction;
+    store->starts[store->num_programs] = end + 1;
+    return true;
+}
+
+bool program_store_copy(ProgramStore *dest, const ProgramStore *src) {
+    program_store_init(dest);
+    int num_instructions = src->num_programs > 0 ? src->starts[src->num_programs] : 0;
+    if (!program_store_reserve(dest, src->num_programs, num_instructions)) {
+        program_store_destroy(dest);
+        return false;
+    }
+    dest->num_programs = src->num_programs;
+    if (src->num_programs > 0) {
+        memcpy(dest->mem_sizes, src->mem_sizes, src->num_programs * sizeof(int));
+        memcpy(dest->starts, src->starts, (src->num_programs + 1) * sizeof(int));
+        memcpy(dest->instructions, src->instructions, num_instructions * sizeof(int));
+    }
+    return true;
+}
+
+// --- Text Format ---
+
+// The file is read in blocks and scanned by hand, which is several times faster than fscanf() on
+// workloads of millions of instructions
+typedef struct {
+    FILE *file;
+    size_t length;
+    size_t pos;
+    char buffer[1 << 16];
+} Reader;
+
+static int next_char(Reader *reader) {
+    if (reader->pos == reader->length) {
+        reader->length = fread(reader->buffer, 1, sizeof(reader->buffer), reader->file);
+        reader->pos = 0;
+        if (reader->length == 0) return EOF;
+    }
+    return (unsigned char)reader->buffer[reader->pos++];
+}
+
+static bool is_space(int c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static bool is_digit(int c) {
+    return c >= '0' && c <= '9';
+}
+
+// First character of the next word, past whitespace and comments
+static int skip_blanks(Reader *reader) {
+    int c = next_char(reader);
+    while (is_space(c) || c == '#') {
+        if (c == '#') {
+            while (c != EOF && c != '\n') c = next_char(reader);
+        } else {
+            c = next_char(reader);
+        }
+    }
+    return c;
+}
+
+// A word must be followed by whitespace, a comment or the end of the file.
+// A '#' is given back so the next word skips the comment.
+static bool end_of_word(Reader *reader, int c) {
+    if (c == '#') reader->pos--;
+    return c == EOF || c == '#' || is_space(c);
+}
+
+static bool read_number(Reader *reader, int *value) {
+    int c = skip_blanks(reader);
+    bool negative = c == '-';
+    if (negative) c = next_char(reader);
+    if (!is_digit(c)) return false;
+    long long number = 0;
+    while (is_digit(c)) {
+        number = number * 10 + (c - '0');
+        if (number > (long long)INT_MAX + 1) return false;
+        c = next_char(reader);
+    }
+    if (negative) number = -number;
+    if (number > INT_MAX || !end_of_word(reader, c)) return false;
+    *value = (int)number;
+    return true;
+}
+
+static bool read_keyword(Reader *reader, const char *keyword) {
+    int c = skip_blanks(reader);
+    for (const char *k = keyword; *k != '\0'; k++) {
+        if (c != *k) return false;
+        c = next_char(reader);
+    }
+    return end_of_word(reader, c);
+}
+
+static bool read_programs(Reader *reader, ProgramStore *store) {
+    int num_programs;
+    if (!read_keyword(reader, "programs") || !read_number(reader, &num_programs) || num_programs < 1) {
+        return false;
+    }
+    // The counts are only trusted as far as the file goes, so the store grows as the values come
+    for (int p = 0; p < num_programs; p++) {
+        int mem_size, length;
+        if (!read_number(reader, &mem_size) || mem_size < 0 || !read_number(reader, &length) || length < 1 ||
+            !program_store_begin(store, mem_size)) {
+            return false;
+        }
+        for (int i = 0; i < length; i++) {
+            int instruction;
+            if (!read_number(reader, &instruction) || !program_store_append(store, instruction)) return false;
+        }
+    }
+    return skip_blanks(reader) == EOF;
+}
+
+bool program_store_load(FILE *file, ProgramStore *store) {
+    Reader *reader = (Reader *)malloc(sizeof(Reader));
+    program_store_init(store);
+    if (!reader) return false;
+    reader->file = file;
+    reader->length = reader->pos = 0;
+    bool ok = read_programs(reader, store);
+    free(reader);
+    if (!ok) program_store_destroy(store);
+    return ok;
+}
+
+bool program_store_write(FILE *file, const ProgramStore *store) {
+    fprintf(file, "programs %d\n", store->num_programs);
+    fprintf(file, "# memory size, instruction count, instructions\n");
+    for (int p = 0; p < store->num_programs; p++) {
+        int length = program_length(store, p);
+        const int *code = program_code(store, p);
+        fprintf(file, "%d %d", store->mem_sizes[p], length);
+        for (int i = 0; i < length; i++) {
+            fprintf(file, " %d", code[i]);
+        }
+        fputc('\n', file);
+    }
+    return ferror(file) == 0;
+}
@@ -0,0 +1,43 @@
+#ifndef PROGRAMS_H
+#define PROGRAMS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+// Decoded programs of a simulation: the memory size of every program and its instructions, the
+// programs back to back in one array. Any number of programs of any length, although EXEC can
+// only start programs 0 to 98 (instructions 201-299).
+typedef struct {
+    int num_programs;
+    int *mem_sizes;            // num_programs entries
+    int *starts;               // num_programs + 1 entries, program p is instructions starts[p] to starts[p + 1] - 1
+    int *instructions;
+    int program_capacity;
+    int instruction_capacity;
+} ProgramStore;
+
+void program_store_init(ProgramStore *store);
+void program_store_destroy(ProgramStore *store);
+// Makes room for that many programs and instructions in total
+bool program_store_reserve(ProgramStore *store, int num_programs, int num_instructions);
+// Starts a new, empty program, then program_store_append() adds its instructions
+bool program_store_begin(ProgramStore *store, int mem_size);
+bool program_store_append(ProgramStore *store, int instruction);
+bool program_store_copy(ProgramStore *dest, const ProgramStore *src);
+
+static inline int program_length(const ProgramStore *store, int prog_id) {
+    return store->starts[prog_id + 1] - store->starts[prog_id];
+}
+
+static inline const int *program_code(const ProgramStore *store, int prog_id) {
+    return &store->instructions[store->starts[prog_id]];
+}
+
+// Text format, read in a single streaming pass:
+//   programs N
+//   then N times: memory size, instruction count, the instructions
+// Numbers are separated by any whitespace, and '#' starts a comment that runs to the end of the line.
+bool program_store_load(FILE *file, ProgramStore *store);
+bool program_store_write(FILE *file, const ProgramStore *store);
+
+#endif // PROGRAMS_H
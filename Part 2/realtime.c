@@ -0,0 +1,134 @@
+#include "p2_simulator.h"
+
+// Periodic real-time tasks. A process whose program has a period runs it as a job: reaching HALT
+// completes the job, and the process sleeps BLOCKED until the next release, then starts over from
+// the first instruction with a new absolute deadline. Best effort processes only run when no
+// real-time one is ready, in FIFO order.
+
+// Liu and Layland bound n(2^(1/n) - 1) in per mille, for n = 1 to MAX_PROCESSES tasks
+static const int rm_bound[MAX_PROCESSES] = {
+    1000, 828, 779, 756, 743, 734, 728, 724, 720, 717, 715, 713, 711, 710, 709, 708, 707, 706, 705, 705
+};
+
+static int rt_key(const SimulationSystem *system, const PCB *proc) {
+    if (proc->period == 0) return INT_MAX;
+    return system->config.rt_policy == RT_EDF ? proc->deadline : proc->period;
+}
+
+static bool entry_before(SimulationSystem *system, const ReadyEntry *a, const ReadyEntry *b) {
+    system->stats.heap_comparisons++;
+    return a->key < b->key || (a->key == b->key && a->seq < b->seq);
+}
+
+static void swap_entries(ReadyEntry *a, ReadyEntry *b) {
+    ReadyEntry temp = *a;
+    *a = *b;
+    *b = temp;
+}
+
+void ready_push(SimulationSystem *system, PCB *proc) {
+    ReadyEntry *heap = system->ready_heap;
+    int i = system->ready_count++;
+    heap[i] = (ReadyEntry){rt_key(system, proc), system->ready_seq++, proc->pid};
+    while (i > 0 && entry_before(system, &heap[i], &heap[(i - 1) / 2])) {
+        swap_entries(&heap[i], &heap[(i - 1) / 2]);
+        i = (i - 1) / 2;
+    }
+}
+
+PCB *ready_pop(SimulationSystem *system) {
+    ReadyEntry *heap = system->ready_heap;
+    if (system->ready_count == 0) return NULL;
+    PCB *proc = system->processes[heap[0].pid - 1];
+    heap[0] = heap[--system->ready_count];
+    int i = 0;
+    while (true) {
+        int smallest = i;
+        for (int child = 2 * i + 1; child <= 2 * i + 2 && child < system->ready_count; child++) {
+            if (entry_before(system, &heap[child], &heap[smallest])) smallest = child;
+        }
+        if (smallest == i) break;
+        swap_entries(&heap[i], &heap[smallest]);
+        i = smallest;
+    }
+    return proc;
+}
+
+// True when the most urgent ready process should take the CPU from the running one
+bool ready_preempts(SimulationSystem *system, const PCB *running) {
+    if (system->ready_count == 0) return false;
+    system->stats.heap_comparisons++;
+    return system->ready_heap[0].key < rt_key(system, running);
+}
+
+// Density of a task in per mille: its execution time over the shorter of deadline and period. The
+// execution time is estimated as one tick per instruction of its program, ignoring loops, BLOCKs and
+// page faults, so the test predicts what the CPU alone allows.
+static int density(const PCB *proc) {
+    int window = proc->relative_deadline < proc->period ? proc->relative_deadline : proc->period;
+    return window > 0 ? proc->instruction_count * 1000 / window : INT_MAX / MAX_PROCESSES;
+}
+
+// Schedulability test at admission: EDF accepts up to a total density of 1, RM up to the Liu and
+// Layland bound (sufficient only, so RM may turn away sets it could have met). A task that does not
+// fit is demoted to best effort instead of endangering the admitted ones.
+void rt_admit(SimulationSystem *system, PCB *proc) {
+    if (proc->period == 0) return;
+    int total = density(proc), tasks = 1;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        const PCB *other = system->processes[i];
+        if (other && other != proc && other->period > 0 && other->state != NEW && other->state != EXIT) {
+            total += density(other);
+            tasks++;
+        }
+    }
+    int bound = system->config.rt_policy == RT_EDF ? 1000 : rm_bound[tasks - 1];
+    if (total > bound) {
+        proc->period = 0;
+        system->stats.admission_rejects++;
+    } else if (total > system->stats.peak_utilization) {
+        system->stats.peak_utilization = total;
+    }
+}
+
+// HALT of a real-time process: records the job's lateness and sleeps until the next release
+void complete_job(SimulationSystem *system, PCB *proc) {
+    SimulationStats *stats = &system->stats;
+    int now = system->current_time;
+    int lateness = now - proc->deadline;
+    stats->rt_jobs++;
+    stats->lateness_total += lateness;
+    if (stats->rt_jobs == 1 || lateness > stats->max_lateness) stats->max_lateness = lateness;
+    if (lateness > 0) stats->deadline_misses++;
+    int bucket = lateness < 0 ? 0 : lateness == 0 ? 1 : lateness <= 2 ? 2 : lateness <= 5 ? 3 : lateness <= 10 ? 4 : 5;
+    stats->lateness_buckets[bucket]++;
+
+    proc->release += proc->period;
+    proc->deadline = proc->release + proc->relative_deadline;
+    proc->pc = -1; // update_blocked_processes() steps it onto the first instruction
+    proc->state = BLOCKED;
+    proc->blocked_until = proc->release > now ? proc->release : now + 1;
+    enqueue(system->blocked_queue, proc);
+    system->running_process = NULL;
+}
+
+void print_rt_statistics(SimulationSystem *system) {
+    const SimulationStats *stats = &system->stats;
+    FILE *out = system->out;
+    static const char *const bucket_names[LATENESS_BUCKETS] = {
+        "  early", "  on time", "  1-2 ticks late", "  3-5 ticks late", "  6-10 ticks late", "  over 10 ticks late"
+    };
+    fprintf(out, "%-26s %s\n", "scheduler", system->config.rt_policy == RT_EDF ? "earliest deadline first" : "rate monotonic");
+    fprintf(out, "%-26s %d\n", "real-time jobs", stats->rt_jobs);
+    fprintf(out, "%-26s %d\n", "deadline misses", stats->deadline_misses);
+    fprintf(out, "%-26s %.2f\n", "average lateness", stats->rt_jobs > 0 ? (double)stats->lateness_total / stats->rt_jobs : 0.0);
+    fprintf(out, "%-26s %d\n", "worst lateness", stats->max_lateness);
+    for (int i = 0; i < LATENESS_BUCKETS; i++) {
+        fprintf(out, "%-26s %d\n", bucket_names[i], stats->lateness_buckets[i]);
+    }
+    fprintf(out, "%-26s %d\n", "real-time preemptions", stats->rt_preemptions);
+    fprintf(out, "%-26s %.2f\n", "heap comparisons/dispatch",
+            stats->dispatches > 0 ? (double)stats->heap_comparisons / stats->dispatches : 0.0);
+    fprintf(out, "%-26s %d\n", "admission rejects", stats->admission_rejects);
+    fprintf(out, "%-26s %.1f%%\n", "peak admitted utilization", stats->peak_utilization / 10.0);
+}
@@ -0,0 +1,324 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include "p2_simulator.h"
+#include "inputs_part2.h"
+#include "workload.h"
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+// Parameter sweep: every combination of quantum, frame count, replacement policy and reclaim watermarks is run over
+// every input on a pool of threads. Each run has its own SimulationSystem and output stream,
+// and the counters of all inputs are added up into one row per combination.
+
+#define NUM_INPUTS 12
+#define MAX_VALUES 64
+
+typedef struct {
+    int quantum;
+    int num_frames;
+    ReplacementPolicy policy;
+    int low_watermark;  // 0 without background reclaim
+    int high_watermark;
+} Combination;
+
+typedef struct {
+    int combination;
+    int input;
+    SimulationStats stats;
+    int ticks;
+    bool finished;
+    bool failed; // The table file could not be opened
+} Job;
+
+typedef struct {
+    Job *jobs;
+    int num_jobs;
+    atomic_int next_job;
+    const Combination *combinations;
+    const SimulationInput *inputs;
+    const SimulationConfig *base_config;
+    const char *tables_dir; // NULL: tables are not printed at all
+} Sweep;
+
+void print_usage(const char *program_name) {
+    fprintf(stderr, "Usage: %s [options]\n", program_name);
+    fprintf(stderr, "  --quantum LIST   Quantum values, like 3, 1:6, 1:9:2 or 2,3,5 (default %d)\n", DEFAULT_QUANTUM);
+    fprintf(stderr, "  --frames LIST    Frame counts in the same forms, at most %d (default %d)\n", MAX_FRAMES, NUM_FRAMES);
+    fprintf(stderr, "  --policy LIST    lru, fifo or lru,fifo (default lru)\n");
+    fprintf(stderr, "  --watermarks L   Background reclaim watermarks, like off,1:2,2:4 (default off)\n");
+    fprintf(stderr, "  --threads N      Worker threads (default: one per CPU)\n");
+    fprintf(stderr, "  --input FILE     Sweep a generated program file instead of the built-in inputs\n");
+    fprintf(stderr, "  --tables DIR     Also write the state table of every run into DIR\n");
+    fprintf(stderr, "  --csv FILE       Also write the results table as CSV\n");
+}
+
+// Reads "A", "A:B", "A:B:STEP" or "A,B,C" into values. Returns the number of values, 0 on error.
+int parse_values(const char *text, int values[], int low, int high) {
+    int count = 0;
+    int first, last, step = 1;
+    int fields = sscanf(text, "%d:%d:%d", &first, &last, &step);
+    if (fields >= 2 && strchr(text, ',') == NULL) {
+        if (step < 1 || first > last) return 0;
+        for (int value = first; value <= last && count < MAX_VALUES; value += step) {
+            values[count++] = value;
+        }
+    } else {
+        char list[256];
+        strncpy(list, text, sizeof(list) - 1);
+        list[sizeof(list) - 1] = '\0';
+        for (char *item = strtok(list, ","); item != NULL && count < MAX_VALUES; item = strtok(NULL, ",")) {
+            values[count++] = atoi(item);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        if (values[i] < low || values[i] > high) return 0;
+    }
+    return count;
+}
+
+int parse_policies(const char *text, ReplacementPolicy policies[]) {
+    int count = 0;
+    char list[64];
+    strncpy(list, text, sizeof(list) - 1);
+    list[sizeof(list) - 1] = '\0';
+    for (char *item = strtok(list, ","); item != NULL && count < 2; item = strtok(NULL, ",")) {
+        if (strcmp(item, "lru") == 0) policies[count++] = POLICY_LRU;
+        else if (strcmp(item, "fifo") == 0) policies[count++] = POLICY_FIFO;
+        else return 0;
+    }
+    return count;
+}
+
+// Reads "off" and "low:high" pairs separated by commas, low 0 standing for off. Returns the number of pairs, 0 on error.
+int parse_watermarks(const char *text, int lows[], int highs[]) {
+    int count = 0;
+    char list[256];
+    strncpy(list, text, sizeof(list) - 1);
+    list[sizeof(list) - 1] = '\0';
+    for (char *item = strtok(list, ","); item != NULL && count < MAX_VALUES; item = strtok(NULL, ",")) {
+        lows[count] = highs[count] = 0;
+        if (strcmp(item, "off") != 0 && (sscanf(item, "%d:%d", &lows[count], &highs[count]) != 2 ||
+                                         lows[count] < 1 || highs[count] < lows[count])) {
+            return 0;
+        }
+        count++;
+    }
+    return count;
+}
+
+const char *policy_name(ReplacementPolicy policy) {
+    return policy == POLICY_FIFO ? "fifo" : "lru";
+}
+
+void run_job(Sweep *sweep, Job *job) {
+    const Combination *combination = &sweep->combinations[job->combination];
+    SimulationConfig config = *sweep->base_config;
+    config.quantum = combination->quantum;
+    config.num_frames = combination->num_frames;
+    config.policy = combination->policy;
+    config.suspend_threshold = combination->num_frames;
+    config.resume_threshold = combination->num_frames - 1;
+    config.kswapd = combination->low_watermark > 0;
+    if (config.kswapd) {
+        config.low_watermark = combination->low_watermark;
+        config.high_watermark = combination->high_watermark < combination->num_frames ? combination->high_watermark
+                                                                                          : combination->num_frames;
+    }
+
+    FILE *table = NULL;
+    if (sweep->tables_dir != NULL) {
+        // The watermarks are part of the name, as runs differing only by them go to the same directory
+        char watermarks[24] = "off";
+        if (combination->low_watermark > 0) {
+            snprintf(watermarks, sizeof(watermarks), "%d-%d", combination->low_watermark, combination->high_watermark);
+        }
+        char path[512];
+        snprintf(path, sizeof(path), "%s/q%d_f%d_%s_%s_%02d.out", sweep->tables_dir, combination->quantum,
+                 combination->num_frames, policy_name(combination->policy), watermarks, job->input);
+        table = fopen(path, "w");
+        if (table == NULL) {
+            job->failed = true;
+            return;
+        }
+    }
+
+    SimulationSystem system;
+    initialize_system_with_config(&system, sweep->inputs[job->input], &config);
+    system.out = table;
+    run_simulation(&system);
+    job->stats = system.stats;
+    job->ticks = system.current_time;
+    job->finished = system.finished;
+    destroy_system(&system);
+    if (table != NULL) fclose(table);
+}
+
+void *worker(void *arg) {
+    Sweep *sweep = (Sweep *)arg;
+    while (true) {
+        int index = atomic_fetch_add(&sweep->next_job, 1);
+        if (index >= sweep->num_jobs) break;
+        run_job(sweep, &sweep->jobs[index]);
+    }
+    return NULL;
+}
+
+int default_thread_count(void) {
+#ifndef _WIN32
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 0) return (int)cpus;
+#endif
+    return 4;
+}
+
+int main(int argc, char *argv[]) {
+    int quanta[MAX_VALUES] = {DEFAULT_QUANTUM}, num_quanta = 1;
+    int frames[MAX_VALUES] = {NUM_FRAMES}, num_frames = 1;
+    ReplacementPolicy policies[2] = {POLICY_LRU}; int num_policies = 1;
+    int lows[MAX_VALUES] = {0}, highs[MAX_VALUES] = {0}, num_watermarks = 1;
+    int threads = default_thread_count();
+    const char *input_path = NULL, *tables_dir = NULL, *csv_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+        bool valid = true;
+        if (strcmp(argv[i - 1], "--quantum") == 0) valid = (num_quanta = parse_values(value, quanta, 1, 1000)) > 0;
+        else if (strcmp(argv[i - 1], "--frames") == 0) valid = (num_frames = parse_values(value, frames, 1, MAX_FRAMES)) > 0;
+        else if (strcmp(argv[i - 1], "--policy") == 0) valid = (num_policies = parse_policies(value, policies)) > 0;
+        else if (strcmp(argv[i - 1], "--watermarks") == 0) valid = (num_watermarks = parse_watermarks(value, lows, highs)) > 0;
+        else if (strcmp(argv[i - 1], "--threads") == 0) valid = (threads = atoi(value)) > 0;
+        else if (strcmp(argv[i - 1], "--input") == 0) input_path = value;
+        else if (strcmp(argv[i - 1], "--tables") == 0) tables_dir = value;
+        else if (strcmp(argv[i - 1], "--csv") == 0) csv_path = value;
+        else valid = false;
+        if (!valid) {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    SimulationInput inputs[NUM_INPUTS] = {
+        {input00, 8}, {input01, 6}, {input02, 5}, {input03, 6}, {input04, 6},
+        {input05, 6}, {input06, 5}, {input07, 12}, {input08, 12}, {input09, 12},
+        {input10, 12}, {input11, 12}
+    };
+    int num_inputs = NUM_INPUTS;
+    if (input_path != NULL) {
+        FILE *file = fopen(input_path, "r");
+        if (file == NULL || !load_programs_text(file, &inputs[0])) {
+            fprintf(stderr, "Invalid program file: %s\n", input_path);
+            if (file != NULL) fclose(file);
+            return 1;
+        }
+        fclose(file);
+        num_inputs = 1;
+    }
+
+    int num_combinations = num_quanta * num_frames * num_policies * num_watermarks;
+    if (threads > num_combinations * num_inputs) threads = num_combinations * num_inputs;
+    Combination *combinations = (Combination *)malloc(num_combinations * sizeof(Combination));
+    Job *jobs = (Job *)calloc((size_t)num_combinations * num_inputs, sizeof(Job));
+    pthread_t *pool = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    // Opened before the runs, so a bad path is reported without sweeping for nothing
+    FILE *csv = csv_path != NULL ? fopen(csv_path, "w") : NULL;
+    if (!combinations || !jobs || !pool || (csv_path != NULL && csv == NULL)) {
+        if (csv_path != NULL && csv == NULL) {
+            fprintf(stderr, "Could not write %s\n", csv_path);
+        } else {
+            fprintf(stderr, "Out of memory for the sweep\n");
+        }
+        if (csv != NULL) fclose(csv);
+        free(pool);
+        free(jobs);
+        free(combinations);
+        if (input_path != NULL) free(inputs[0].programs);
+        return 1;
+    }
+    int c = 0;
+    for (int q = 0; q < num_quanta; q++) {
+        for (int f = 0; f < num_frames; f++) {
+            for (int p = 0; p < num_policies; p++) {
+                for (int w = 0; w < num_watermarks; w++) {
+                    combinations[c++] = (Combination){quanta[q], frames[f], policies[p], lows[w], highs[w]};
+                }
+            }
+        }
+    }
+
+    SimulationConfig base_config = default_config();
+    Sweep sweep = {
+        .jobs = jobs,
+        .num_jobs = num_combinations * num_inputs,
+        .combinations = combinations,
+        .inputs = inputs,
+        .base_config = &base_config,
+        .tables_dir = tables_dir
+    };
+    atomic_init(&sweep.next_job, 0);
+    for (int j = 0; j < sweep.num_jobs; j++) {
+        sweep.jobs[j].combination = j / num_inputs;
+        sweep.jobs[j].input = j % num_inputs;
+    }
+
+    int started = 0;
+    while (started < threads && pthread_create(&pool[started], NULL, worker, &sweep) == 0) {
+        started++;
+    }
+    if (started < threads) {
+        worker(&sweep); // Takes the share of the threads that could not start
+    }
+    for (int t = 0; t < started; t++) {
+        pthread_join(pool[t], NULL);
+    }
+
+    if (csv != NULL) {
+        fprintf(csv, "quantum,frames,policy,watermarks,runs,ticks,accesses,page_faults,fault_rate,direct_reclaims,refaults,"
+                     "dispatches,unfinished\n");
+    }
+    printf("%-8s %-7s %-7s %-10s %8s %10s %8s %10s %8s %9s %11s %10s\n", "quantum", "frames", "policy", "watermarks",
+           "ticks", "accesses", "faults", "fault rate", "direct", "refaults", "dispatches", "unfinished");
+    int failed = 0;
+    for (c = 0; c < num_combinations; c++) {
+        long ticks = 0, accesses = 0, faults = 0, direct = 0, refaults = 0, dispatches = 0;
+        int unfinished = 0;
+        for (int in = 0; in < num_inputs; in++) {
+            const Job *job = &sweep.jobs[c * num_inputs + in];
+            failed += job->failed;
+            ticks += job->ticks;
+            accesses += job->stats.memory_accesses;
+            faults += job->stats.page_faults;
+            direct += job->stats.direct_reclaims;
+            refaults += job->stats.kswapd_refaults;
+            dispatches += job->stats.dispatches;
+            unfinished += !job->finished; // Still running at the tick limit
+        }
+        double fault_rate = accesses > 0 ? (double)faults / accesses : 0.0;
+        const Combination *combination = &combinations[c];
+        char watermarks[24] = "off";
+        if (combination->low_watermark > 0) {
+            snprintf(watermarks, sizeof(watermarks), "%d:%d", combination->low_watermark, combination->high_watermark);
+        }
+        printf("%-8d %-7d %-7s %-10s %8ld %10ld %8ld %10.3f %8ld %9ld %11ld %10d\n", combination->quantum,
+               combination->num_frames, policy_name(combination->policy), watermarks, ticks, accesses, faults, fault_rate,
+               direct, refaults, dispatches, unfinished);
+        if (csv != NULL) {
+            fprintf(csv, "%d,%d,%s,%s,%d,%ld,%ld,%ld,%.4f,%ld,%ld,%ld,%d\n", combination->quantum, combination->num_frames,
+                    policy_name(combination->policy), watermarks, num_inputs, ticks, accesses, faults, fault_rate, direct,
+                    refaults, dispatches, unfinished);
+        }
+    }
+    if (csv != NULL) fclose(csv);
+    if (failed > 0) fprintf(stderr, "%d tables could not be written to %s\n", failed, tables_dir);
+
+    free(pool);
+    free(sweep.jobs);
+    free(combinations);
+    if (input_path != NULL) free(inputs[0].programs);
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,206 @@
+#include "p2_simulator.h"
+
+// Mutexes and counting semaphores. A process that cannot get one either blocks on its wait queue
+// (and is handed the mutex or semaphore unit when it is released) or, with spin locks, stays on the
+// CPU retrying the same instruction every tick it runs. Waiting processes are BLOCKED with no
+// wake up time until the hand-off, and leave BLOCKED on the next tick like after a BLOCK.
+
+bool is_sync_instruction(const SimulationSystem *system, int instruction) {
+    return system->config.sync && instruction >= LOCK_BASE && instruction < SEM_SIGNAL_BASE + NUM_SEMAPHORES;
+}
+
+// Releasing a mutex the process does not hold is an illegal instruction
+bool sync_fault(const SimulationSystem *system, const PCB *proc, int instruction) {
+    if (instruction < UNLOCK_BASE || instruction >= UNLOCK_BASE + NUM_MUTEXES) return false;
+    return system->mutexes[instruction - UNLOCK_BASE].owner != proc->pid;
+}
+
+static SyncObject *object_of(SimulationSystem *system, int index) {
+    return index < NUM_MUTEXES ? &system->mutexes[index] : &system->semaphores[index - NUM_MUTEXES];
+}
+
+static void remove_waiter(SyncObject *object, int pid) {
+    for (int i = 0; i < object->num_waiters; i++) {
+        if (object->waiters[i] == pid) {
+            memmove(&object->waiters[i], &object->waiters[i + 1], (object->num_waiters - i - 1) * sizeof(int));
+            object->num_waiters--;
+            return;
+        }
+    }
+}
+
+// Recomputes the effective priority of a process and of the owners down its chain of waits
+static void update_priority(SimulationSystem *system, PCB *proc) {
+    for (int depth = 0; proc != NULL && depth < MAX_PROCESSES; depth++) {
+        int effective = proc->priority;
+        for (int m = 0; system->config.priority_inheritance && m < NUM_MUTEXES; m++) {
+            const SyncObject *mutex = &system->mutexes[m];
+            if (mutex->owner != proc->pid) continue;
+            for (int i = 0; i < mutex->num_waiters; i++) {
+                const PCB *waiter = system->processes[mutex->waiters[i] - 1];
+                if (waiter && waiter->effective_priority > effective) effective = waiter->effective_priority;
+            }
+        }
+        proc->effective_priority = effective;
+        if (proc->waiting_on < 0 || proc->waiting_on >= NUM_MUTEXES) break;
+        int owner = system->mutexes[proc->waiting_on].owner;
+        proc = owner != 0 ? system->processes[owner - 1] : NULL;
+    }
+}
+
+// The first failed attempt puts the process on the wait queue; later spins only count
+static void start_waiting(SimulationSystem *system, PCB *proc, int index) {
+    SyncObject *object = object_of(system, index);
+    if (proc->waiting_on != index) {
+        proc->waiting_on = index;
+        proc->wait_start = system->current_time;
+        object->waiters[object->num_waiters++] = proc->pid;
+        if (index >= NUM_MUTEXES) system->stats.semaphore_waits++;
+        if (object->num_waiters == CONVOY_LENGTH && index < NUM_MUTEXES) system->stats.convoys++;
+        if (object->num_waiters > system->stats.peak_waiters) system->stats.peak_waiters = object->num_waiters;
+    }
+    if (index < NUM_MUTEXES && object->owner != 0) {
+        update_priority(system, system->processes[object->owner - 1]);
+    }
+    if (system->config.spin_locks) {
+        system->stats.spin_ticks++; // The instruction is retried, the process keeps its CPU
+    } else {
+        proc->state = BLOCKED;
+        proc->blocked_until = INT_MAX;
+        enqueue(system->blocked_queue, proc);
+        system->running_process = NULL;
+    }
+}
+
+// Ends the wait of a process that got its mutex or semaphore unit
+static void finish_waiting(SimulationSystem *system, PCB *proc, int index) {
+    if (proc->wait_start == -1) return;
+    int wait = system->current_time - proc->wait_start;
+    system->stats.wait_ticks += wait;
+    if (wait > system->stats.max_wait) system->stats.max_wait = wait;
+    if (index < NUM_MUTEXES) system->stats.contended_acquisitions++;
+    remove_waiter(object_of(system, index), proc->pid);
+    proc->waiting_on = -1;
+    proc->wait_start = -1;
+}
+
+static void take_mutex(SimulationSystem *system, PCB *proc, int m) {
+    system->mutexes[m].owner = proc->pid;
+    system->mutexes[m].acquired_at = system->current_time;
+    system->stats.lock_acquisitions++;
+    finish_waiting(system, proc, m);
+    update_priority(system, proc);
+}
+
+// The blocked waiter the object is handed to: the highest priority one under priority scheduling,
+// the oldest one otherwise. Spinners are never handed anything, they retry on their own.
+static PCB *next_waiter(SimulationSystem *system, const SyncObject *object) {
+    if (system->config.spin_locks) return NULL;
+    PCB *chosen = NULL;
+    for (int i = 0; i < object->num_waiters; i++) {
+        PCB *waiter = system->processes[object->waiters[i] - 1];
+        if (waiter && (!chosen || (system->config.priority_scheduling && waiter->effective_priority > chosen->effective_priority))) {
+            chosen = waiter;
+        }
+    }
+    return chosen;
+}
+
+static void release_mutex(SimulationSystem *system, PCB *proc, int m) {
+    SyncObject *mutex = &system->mutexes[m];
+    int hold = system->current_time - mutex->acquired_at;
+    system->stats.hold_ticks += hold;
+    if (hold > system->stats.max_hold) system->stats.max_hold = hold;
+    mutex->owner = 0;
+    update_priority(system, proc);
+
+    PCB *next = next_waiter(system, mutex);
+    if (next) {
+        take_mutex(system, next, m);
+        next->blocked_until = system->current_time + 1;
+    }
+}
+
+void execute_sync(SimulationSystem *system, PCB *proc, int instruction) {
+    if (instruction < UNLOCK_BASE) { // LOCK
+        int m = instruction - LOCK_BASE;
+        if (system->mutexes[m].owner != 0) {
+            start_waiting(system, proc, m);
+            return;
+        }
+        take_mutex(system, proc, m);
+    } else if (instruction < SEM_WAIT_BASE) { // UNLOCK
+        release_mutex(system, proc, instruction - UNLOCK_BASE);
+    } else if (instruction < SEM_SIGNAL_BASE) { // P
+        int index = NUM_MUTEXES + instruction - SEM_WAIT_BASE;
+        SyncObject *semaphore = object_of(system, index);
+        if (semaphore->count <= 0) {
+            start_waiting(system, proc, index);
+            return;
+        }
+        semaphore->count--;
+        finish_waiting(system, proc, index);
+    } else { // V
+        int index = NUM_MUTEXES + instruction - SEM_SIGNAL_BASE;
+        SyncObject *semaphore = object_of(system, index);
+        PCB *next = next_waiter(system, semaphore);
+        if (next) {
+            finish_waiting(system, next, index); // The unit goes straight to the waiter
+            next->blocked_until = system->current_time + 1;
+        } else {
+            semaphore->count++;
+        }
+    }
+    proc->pc++;
+}
+
+// A terminated process gives up its mutexes, so their waiters are not stuck forever
+void release_locks(SimulationSystem *system, PCB *proc) {
+    for (int m = 0; m < NUM_MUTEXES; m++) {
+        if (system->mutexes[m].owner == proc->pid) release_mutex(system, proc, m);
+    }
+    if (proc->waiting_on != -1) {
+        remove_waiter(object_of(system, proc->waiting_on), proc->pid);
+        proc->waiting_on = -1;
+    }
+}
+
+// Per tick: counts priority inversion, a process running while a more important one waits for a mutex
+// held by someone else. Priority inheritance lets the owner run first and avoids it.
+void account_sync(SimulationSystem *system) {
+    PCB *running = system->running_process;
+    if (!system->config.priority_scheduling || !running) return;
+    for (int m = 0; m < NUM_MUTEXES; m++) {
+        const SyncObject *mutex = &system->mutexes[m];
+        if (mutex->owner == 0 || mutex->owner == running->pid) continue;
+        for (int i = 0; i < mutex->num_waiters; i++) {
+            const PCB *waiter = system->processes[mutex->waiters[i] - 1];
+            if (waiter && waiter != running && running->effective_priority < waiter->priority) {
+                system->stats.inversion_ticks++;
+                return;
+            }
+        }
+    }
+}
+
+void print_sync_statistics(SimulationSystem *system) {
+    const SimulationStats *stats = &system->stats;
+    FILE *out = system->out;
+    fprintf(out, "%-26s %s%s\n", "locks", system->config.spin_locks ? "spin" : "blocking",
+            system->config.priority_inheritance ? " with priority inheritance" : "");
+    fprintf(out, "%-26s %d\n", "lock acquisitions", stats->lock_acquisitions);
+    fprintf(out, "%-26s %d\n", "contended acquisitions", stats->contended_acquisitions);
+    fprintf(out, "%-26s %.2f\n", "average hold ticks",
+            stats->lock_acquisitions > 0 ? (double)stats->hold_ticks / stats->lock_acquisitions : 0.0);
+    fprintf(out, "%-26s %d\n", "longest hold", stats->max_hold);
+    int waits = stats->contended_acquisitions + stats->semaphore_waits;
+    fprintf(out, "%-26s %.2f\n", "average wait ticks", waits > 0 ? (double)stats->wait_ticks / waits : 0.0);
+    fprintf(out, "%-26s %d\n", "longest wait", stats->max_wait);
+    fprintf(out, "%-26s %d\n", "semaphore waits", stats->semaphore_waits);
+    fprintf(out, "%-26s %d\n", "spin ticks", stats->spin_ticks);
+    fprintf(out, "%-26s %d\n", "convoys", stats->convoys);
+    fprintf(out, "%-26s %d\n", "longest wait queue", stats->peak_waiters);
+    if (system->config.priority_scheduling) {
+        fprintf(out, "%-26s %d\n", "priority inversion ticks", stats->inversion_ticks);
+    }
+}
@@ -0,0 +1,200 @@
+#include "workload.h"
+
+// --- Random Numbers ---
+// A small xorshift generator so the same seed gives the same programs on every platform.
+
+static unsigned long long rng_state;
+
+static void seed_random(unsigned long seed) {
+    rng_state = (unsigned long long)seed * 0x9E3779B97F4A7C15ULL + 1;
+}
+
+static unsigned long long next_random(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+// Uniform integer in [0, n)
+static int random_below(int n) {
+    return (int)(next_random() % (unsigned long long)n);
+}
+
+ProgramSpec default_program_spec(void) {
+    ProgramSpec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.num_programs = 5;
+    spec.length = 20;
+    spec.seed = 1;
+    spec.min_memory = 1000;
+    spec.max_memory = 12000;
+    spec.load_weight = 60;
+    spec.jump_weight = 10;
+    spec.exec_weight = 10;
+    spec.block_weight = 20;
+    spec.max_block = 5;
+    spec.block_devices = 1;
+    spec.lock_count = 1;
+    spec.backward_jump_percent = 20;
+    spec.segfault_rate = 0.0;
+    return spec;
+}
+
+// Picks one instruction for position pc of a program with the given length. EXEC starts one of the
+// first exec_programs programs. held is the mutex the program entered a critical section on, -1 outside of one.
+static int generate_instruction(const ProgramSpec *spec, int exec_programs, int memory_size, int pc, int length,
+                                int *held) {
+    int total = spec->load_weight + spec->jump_weight + spec->exec_weight + spec->block_weight + spec->fork_weight +
+                spec->lock_weight;
+    int pick = random_below(total > 0 ? total : 1);
+
+    if (pick < spec->load_weight || total == 0) {
+        int address;
+        if (spec->segfault_rate > 0.0 && random_below(1000000) < spec->segfault_rate * 1000000) {
+            address = memory_size + random_below(15000 - memory_size > 0 ? 15000 - memory_size : 1);
+        } else {
+            address = random_below(memory_size);
+        }
+        if (spec->store_percent > 0 && random_below(100) < spec->store_percent) {
+            return STORE_BASE + address; // STORE
+        }
+        return 1000 + address; // LOAD/STORE
+    }
+    pick -= spec->load_weight;
+
+    if (pick < spec->jump_weight) {
+        bool backward = pc > 0 && random_below(100) < spec->backward_jump_percent;
+        if (backward) {
+            int reach = pc < 99 ? pc : 99;
+            return 100 + 1 + random_below(reach); // JUMPB
+        }
+        // A forward jump must land inside the program, before or on the HALT
+        int reach = length - 1 - pc;
+        if (reach > 100) reach = 100;
+        if (reach >= 1) {
+            return 1 + random_below(reach); // JUMPF
+        }
+        return 1000; // No room to jump, read address 0 instead
+    }
+    pick -= spec->jump_weight;
+
+    if (pick < spec->exec_weight) {
+        return 201 + random_below(exec_programs); // EXEC
+    }
+
+    pick -= spec->exec_weight;
+
+    if (pick < spec->fork_weight) {
+        return FORK_INSTRUCTION;
+    }
+    pick -= spec->fork_weight;
+
+    if (pick < spec->lock_weight) {
+        if (*held != -1) {
+            int mutex = *held;
+            *held = -1;
+            return UNLOCK_BASE + mutex;
+        }
+        *held = random_below(spec->lock_count);
+        return LOCK_BASE + *held;
+    }
+
+    int duration = 1 + random_below(spec->max_block > 0 ? spec->max_block : 1);
+    int device = spec->block_devices > 1 ? random_below(spec->block_devices) : 0;
+    return -(device * 100 + duration); // BLOCK
+}
+
+static bool valid_spec(const ProgramSpec *spec) {
+    return spec->num_programs >= 1 && spec->length >= 1 &&
+           spec->min_memory >= 1 && spec->max_memory >= spec->min_memory && spec->max_memory <= 15000 &&
+           spec->block_devices >= 1 && spec->block_devices <= 9 && (spec->block_devices == 1 || spec->max_block <= 99) &&
+           spec->lock_count >= 1 && spec->lock_count <= NUM_MUTEXES;
+}
+
+bool generate_programs(const ProgramSpec *spec, SimulationInput *input) {
+    if (!valid_spec(spec) || spec->num_programs > 20) {
+        return false;
+    }
+    seed_random(spec->seed);
+    int exec_programs = spec->num_programs < 5 ? spec->num_programs : 5;
+
+    input->rows = spec->length + 1;
+    input->programs = calloc(input->rows, sizeof(int[20]));
+    if (!input->programs) return false;
+
+    for (int prog = 0; prog < spec->num_programs; prog++) {
+        int memory_size = spec->min_memory + random_below(spec->max_memory - spec->min_memory + 1);
+        input->programs[0][prog] = memory_size;
+        int held = -1;
+        for (int pc = 0; pc < spec->length - 1; pc++) {
+            input->programs[pc + 1][prog] = generate_instruction(spec, exec_programs, memory_size, pc, spec->length, &held);
+        }
+        input->programs[spec->length][prog] = 0; // HALT
+    }
+    return true;
+}
+
+bool generate_program_store(const ProgramSpec *spec, ProgramStore *programs) {
+    program_store_init(programs);
+    if (!valid_spec(spec) || (long long)spec->num_programs * spec->length > INT_MAX ||
+        !program_store_reserve(programs, spec->num_programs, spec->num_programs * spec->length)) {
+        return false;
+    }
+    seed_random(spec->seed);
+    int exec_programs = spec->num_programs < 99 ? spec->num_programs : 99;
+
+    for (int prog = 0; prog < spec->num_programs; prog++) {
+        int memory_size = spec->min_memory + random_below(spec->max_memory - spec->min_memory + 1);
+        program_store_begin(programs, memory_size);
+        int held = -1;
+        for (int pc = 0; pc < spec->length - 1; pc++) {
+            program_store_append(programs, generate_instruction(spec, exec_programs, memory_size, pc, spec->length, &held));
+        }
+        program_store_append(programs, 0); // HALT
+    }
+    return true;
+}
+
+bool write_programs_text(FILE *file, const SimulationInput *input, int num_programs) {
+    fprintf(file, "%d %d\n", input->rows, num_programs);
+    for (int row = 0; row < input->rows; row++) {
+        for (int prog = 0; prog < num_programs; prog++) {
+            fprintf(file, "%d%c", input->programs[row][prog], prog == num_programs - 1 ? '\n' : ' ');
+        }
+    }
+    return ferror(file) == 0;
+}
+
+// Writes the rows in the style of inputs_part2.c
+bool write_programs_c(FILE *file, const SimulationInput *input, int num_programs, const char *name) {
+    fprintf(file, "int %s[%d][20] = {\n", name, input->rows);
+    for (int row = 0; row < input->rows; row++) {
+        fprintf(file, "    {");
+        for (int prog = 0; prog < num_programs; prog++) {
+            fprintf(file, "%s%6d", prog == 0 ? " " : ", ", input->programs[row][prog]);
+        }
+        fprintf(file, " }%s\n", row == input->rows - 1 ? "};" : ",");
+    }
+    return ferror(file) == 0;
+}
+
+bool load_programs_text(FILE *file, SimulationInput *input) {
+    int rows, num_programs;
+    if (fscanf(file, "%d %d", &rows, &num_programs) != 2 || rows < 1 || num_programs < 1 || num_programs > 20) {
+        return false;
+    }
+    input->rows = rows;
+    input->programs = calloc(rows, sizeof(int[20]));
+    if (!input->programs) return false;
+    for (int row = 0; row < rows; row++) {
+        for (int prog = 0; prog < num_programs; prog++) {
+            if (fscanf(file, "%d", &input->programs[row][prog]) != 1) {
+                free(input->programs);
+                input->programs = NULL;
+                return false;
+            }
+        }
+    }
+    return true;
+}
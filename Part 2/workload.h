@@ -0,0 +1,44 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "p2_simulator.h"
+
+// Parameters of a generated set of programs
+typedef struct {
+    int num_programs;    // Columns of the input (at most 5 are loaded by the simulator), or programs of a store
+    int length;          // Instructions per program, the final HALT included
+    unsigned long seed;
+    int min_memory;      // Range of the program memory sizes in bytes
+    int max_memory;
+    // Relative weights of each instruction kind
+    int load_weight;
+    int jump_weight;
+    int exec_weight;
+    int block_weight;
+    int fork_weight;     // FORK instructions, only meaningful with copy-on-write enabled (default 0)
+    int store_percent;   // Share of the memory accesses written as STORE (default 0, all LOAD)
+    int lock_weight;     // Critical section boundaries: LOCK, then the matching UNLOCK (default 0)
+    int lock_count;      // Mutexes the critical sections pick from (1 to NUM_MUTEXES)
+    int max_block;       // Longest BLOCK duration
+    int block_devices;   // BLOCKs are spread over devices 0 to block_devices-1 (operand device*100 + ticks)
+    int backward_jump_percent; // Share of the jumps that go backwards (they can create loops)
+    double segfault_rate;      // Fraction of LOAD/STORE addresses outside the program's memory
+} ProgramSpec;
+
+ProgramSpec default_program_spec(void);
+
+// Builds rows in the layout of inputs_part2.c: row 0 holds the memory sizes, then one instruction per row.
+// The rows are allocated with malloc and belong to the caller.
+bool generate_programs(const ProgramSpec *spec, SimulationInput *input);
+// Programs of the same kind straight into a program store, with no limit on their number. EXEC starts any
+// of the first 99. The store belongs to the caller, who releases it with program_store_destroy().
+bool generate_program_store(const ProgramSpec *spec, ProgramStore *programs);
+
+// Text format: "rows programs" followed by the rows, one line each
+bool write_programs_text(FILE *file, const SimulationInput *input, int num_programs);
+bool write_programs_c(FILE *file, const SimulationInput *input, int num_programs, const char *name);
+bool load_programs_text(FILE *file, SimulationInput *input);
+
+#endif // WORKLOAD_H